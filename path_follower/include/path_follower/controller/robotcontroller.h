@@ -18,6 +18,7 @@
 #include <path_follower/utils/movecommand.h>
 #include <path_follower/utils/path_interpolated.h>
 #include <path_follower/utils/parameters.h>
+#include <path_follower/utils/obstacle_index.h>
 
 
 class PoseTracker;
@@ -112,6 +113,8 @@ protected:
         P<double> k_w;
         P<double> k_curv;
         P<double> obst_threshold;
+        P<bool> pose_prediction;
+        P<double> actuation_delay;
 
         ControllerParameters(const std::string& controller_name) :
             Parameters("controller/" + controller_name),
@@ -122,7 +125,12 @@ protected:
             k_g(this, "k_g", 0.4, "The goal position factor. If increased, the robot speed decreases, as it approaches the goal position."),
             k_w(this, "k_w", 0.5, "The rotation factor. If increased, the robot speed decreases, as the rotation increases."),
             k_curv(this, "k_curv", 0.05, "The curvature factor. If increased, the robot speed decreases, as the curvature increases."),
-            obst_threshold(this, "obst_threshold", 2.0, "The threshold at which the obstacles are taken into account.")
+            obst_threshold(this, "obst_threshold", 2.0, "The threshold at which the obstacles are taken into account."),
+            pose_prediction(this, "pose_prediction", false,
+                            "If set to true, the controller uses the robot pose extrapolated with the odometry velocity"
+                            " from the time of the last transform to the time the command is executed."),
+            actuation_delay(this, "actuation_delay", 0.05,
+                            "Time in s between computing a command and its execution by the robot, used for the pose prediction.")
         {}
     };
 
@@ -271,6 +279,8 @@ protected:
     double distance_to_goal_;
     //distance to the nearest obstacle
     double distance_to_obstacle_;
+    //index of the current obstacle cloud for the nearest obstacle
+    ObstacleIndex obstacle_index_;
 
     //publish the parameters of the exponential speed control
     ros::Publisher exp_control_pub_;
@@ -10,6 +10,8 @@
 
 /// PROJECT
 #include <path_follower/controller/robotcontroller.h>
+#include <path_follower/utils/obstacle_distance_grid.h>
+#include <path_follower/utils/worker_pool.h>
 #include <path_follower/utils/parameters.h>
 
 
@@ -55,14 +57,44 @@ protected:
      */
     virtual void initialize();
 
+    /// One velocity pair of the dynamic window and the result of its forward simulation
+    struct Candidate
+    {
+        Candidate():
+            v(0.0), w(0.0), admissible(false), theta_pred(0.0), curv_dist_obst(0.0),
+            obstacle_found(false), has_next_pos(false)
+        {}
+
+        //velocity pair
+        double v, w;
+        //result of checkAdmissibleVelocities
+        bool admissible;
+        //angle between the predicted orientation and the goal direction at T_dwa, or at the last predicted
+        //pose if the prediction ends earlier
+        double theta_pred;
+        //distance to the nearest obstacle on the curvature
+        double curv_dist_obst;
+        //the last predicted position is closer than obst_dist_thresh to an obstacle
+        bool obstacle_found;
+        //predicted position at T_dwa
+        bool has_next_pos;
+        cv::Point2d next_pos;
+        //predicted positions, up to the first one close to an obstacle
+        std::vector<cv::Point2d> positions;
+    };
+
     /**
      * @brief findNextVelocityPair finds the next velocity pair (v,w) inside the specified dynamic window
+     *
+     * All velocity pairs are evaluated in parallel, the best one is selected afterwards.
      */
     void findNextVelocityPair();
     /**
      * @brief checkAdmissibleVelocities iterates/predicts up to the specified time point, and cheks admissibility
+     *
+     * Only reads the state of the controller, so it can be called concurrently for different candidates.
      */
-    bool checkAdmissibleVelocities();
+    bool checkAdmissibleVelocities(Candidate& candidate) const;
     /**
      * @brief setGoalPosition sets the goal position to be the next point on the path in front of the robot
      *
@@ -72,9 +104,14 @@ protected:
      */
     void setGoalPosition();
     /**
-     * @brief searchMinObstDist searches for nearest obstacle points along the predicted paths
+     * @brief updateObstacleDistances transforms the obstacles to the fixed frame and computes the distance grid
+     *        for all predicted positions within <reach> around the robot
+     */
+    void updateObstacleDistances(double reach);
+    /**
+     * @brief visualizeCandidate publishes the predicted position and the nearest obstacle of the selected candidate
      */
-    void searchMinObstDist();
+    void visualizeCandidate(const Candidate& candidate);
 
 
     // nominal robot velocity
@@ -83,24 +120,18 @@ protected:
     ros::Time t_old_;
     //velocity commands (newly found velocity pair)
     double v_cmd_, w_cmd_;
-    //distance to the nearest obstacle on the curvature (every (v,w) pair uses this variable)
-    double curv_dist_obst_;
     //goal position
     double mGoalPosX, mGoalPosY;
     //currently measured (x,y,theta)
     double x_meas_, y_meas_, theta_meas_;
-    //orientation of the predicted point
-    double theta_pred_;
-    //current velocity pair in the dynamic window
-    double v_iter_, w_iter_;
-    //predicted position
-    double x_pred_, y_pred_;
-    //next position
-    double x_next_, y_next_, theta_next_;
-    //obstacle flag
-    bool obstacle_found;
-    //marker id counter
-    int m_id_counter;
+    //velocity pairs of the current dynamic window
+    std::vector<Candidate> candidates_;
+    //obstacle points in the fixed frame
+    std::vector<cv::Point2f> obstacle_points_;
+    //distance to the nearest obstacle around the robot, in the fixed frame
+    ObstacleDistanceGrid obstacle_grid_;
+    //threads evaluating the velocity pairs, kept alive between the ticks
+    WorkerPool workers_;
     //far predicted positions
     visualization_msgs::MarkerArray far_pred_points;
     //possible trajectories
@@ -137,6 +168,8 @@ protected:
         P<double> obst_dist_thresh;
         P<double> max_ang_vel;
         P<double> initial_vel_fact;
+        P<double> grid_resolution;
+        P<int> threads;
 
         ControllerParameters():
             RobotController::ControllerParameters("dynamic_window"),
@@ -155,7 +188,9 @@ protected:
             step_T(this, "step_T", 0.4, "Time step inside the dynamic window time lenght"),
             obst_dist_thresh(this, "obst_dist_thresh", 0.6, "Threshold at which the obstacles are taken into account."),
             max_ang_vel(this, "max_ang_vel", 0.5, "Maximum angular velocity."),
-            initial_vel_fact(this, "initial_vel_fact", 0.2, "Factor for scaling the initial velocity commands.")
+            initial_vel_fact(this, "initial_vel_fact", 0.2, "Factor for scaling the initial velocity commands."),
+            grid_resolution(this, "grid_resolution", 0.05, "Cell size of the obstacle distance grid."),
+            threads(this, "threads", 1, "Number of threads evaluating the velocity pairs, 0 to use all cores.")
         {}
     } opt_;
 
@@ -14,6 +14,7 @@
 
 /// LIBRARIES
 #include <model_based_planner/imodelbasedplanner.h>
+#include <model_based_planner/planner_recording.h>
 
 
 #define MODEL_CONTROLLER_DEBUG 1
@@ -86,6 +87,7 @@ protected:
         P<double> max_angular_velocity;
 
         P<std::string> pose_output_folder;
+        P<std::string> recording_file;
 
 
         ControllerParameters():
@@ -99,7 +101,8 @@ protected:
             max_linear_velocity(this, "max_linear_velocity", 1.0, "Lower velocity bound for model based path search"),
             lin_acc_step(this, "lin_acc_step", 0.05, "Acceleration per time step"),
             max_angular_velocity(this, "max_angular_velocity", 0.5, "Lower velocity bound for model based path search"),
-            pose_output_folder(this, "pose_output_folder", "", "Output folder for debug output")
+            pose_output_folder(this, "pose_output_folder", "", "Output folder for debug output"),
+            recording_file(this, "recording_file", "", "File for recording the planner inputs, which can be replayed with model_based_planner_replay")
 
         {
 
@@ -227,6 +230,8 @@ protected:
     PoseWriter writer_;
 #endif
 
+    PlannerRecorder recorder_;
+
 
 
 };
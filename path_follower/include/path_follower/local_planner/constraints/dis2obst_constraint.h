@@ -14,6 +14,18 @@ public:
     void setParams(double threshold);
 
     virtual bool isSatisfied(const LNode& point) override;
+
+    double getThreshold() const
+    {
+        return threshold;
+    }
+
+    //! Check without timing, shared with the EvaluationPipeline.
+    static bool check(const LNode& point, double threshold)
+    {
+        return point.d2o > threshold;
+    }
+
 private:
     double threshold;
 };
@@ -17,6 +17,22 @@ public:
     double getLimit();
 
     virtual bool isSatisfied(const LNode& point) override;
+
+    //! Allowed distance to the path at <point>, which is enhanced close to obstacles.
+    static double limitAt(const LNode& point)
+    {
+        //this should be a parameter
+        double obst_min_dist = 4.0;
+        double enhancement_fact = 4.0;
+        return point.d2o <= obst_min_dist ? DIS2P_ * enhancement_fact : DIS2P_;
+    }
+
+    //! Check without timing, shared with the EvaluationPipeline.
+    static bool check(const LNode& point)
+    {
+        return point.d2p <= limitAt(point);
+    }
+
 private:
     static double D_RATE, DIS2P_;
     double limit;
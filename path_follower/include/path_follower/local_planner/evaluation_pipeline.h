@@ -0,0 +1,103 @@
+#ifndef EVALUATION_PIPELINE_H
+#define EVALUATION_PIPELINE_H
+
+#include <path_follower/local_planner/scorer.h>
+#include <path_follower/local_planner/constraint.h>
+
+#include <vector>
+
+/**
+ * @brief The EvaluationPipeline class evaluates the scorers and constraints of a local planner without virtual calls.
+ *
+ * Every combination of the known scorers and constraints is compiled into one inlined function, the combination
+ * used by the planner is selected at runtime with configureScorers() and configureConstraints().
+ * If a planner uses a scorer or constraint the pipeline does not know, the configuration fails and the planner has
+ * to use the virtual interface instead.
+ * The fused functions do not update the stopwatches of the scorers and constraints.
+ */
+class EvaluationPipeline
+{
+public:
+    //! Known scorers, in the order in which the LocalPlannerFactory adds them.
+    enum ScorerKernel {
+        SCORER_DIS2PATH_P = 0,
+        SCORER_DIS2PATH_D,
+        SCORER_CURVATURE,
+        SCORER_CURVATURE_D,
+        SCORER_LEVEL,
+        SCORER_DIS2OBST,
+        SCORER_KERNELS
+    };
+
+    //! Known constraints
+    enum ConstraintKernel {
+        CONSTRAINT_DIS2PATH = 0,
+        CONSTRAINT_DIS2OBST,
+        CONSTRAINT_KERNELS
+    };
+
+public:
+    EvaluationPipeline();
+
+    /**
+     * @brief configureScorers selects the fused function for <scorers>.
+     *        Fails if a scorer is unknown, used twice or not in the order of ScorerKernel,
+     *        since the sum would then differ from the one of the virtual interface.
+     * @return true, iff score() can be used for <scorers>
+     */
+    bool configureScorers(const std::vector<Scorer::Ptr>& scorers);
+
+    /**
+     * @brief configureConstraints selects the fused function for <constraints>.
+     *        Has to be called again after the parameters of the constraints changed.
+     * @return true, iff isSatisfied() can be used for <constraints>
+     */
+    bool configureConstraints(const std::vector<Constraint::Ptr>& constraints);
+
+    bool hasScorers() const;
+    bool hasConstraints() const;
+
+    //! Weighted sum of all configured scores of <node>.
+    double score(const LNode& node) const
+    {
+        return score_one_(node, weights_);
+    }
+
+    //! Scores of <n> nodes, evaluated in blocks with the cheap scorers vectorized.
+    void score(const LNode* const* nodes, std::size_t n, double* scores) const
+    {
+        score_batch_(nodes, n, weights_, scores);
+    }
+
+    //! true, iff <node> satisfies all configured constraints
+    bool isSatisfied(const LNode& node) const
+    {
+        return satisfied_one_(node, obstacle_threshold_);
+    }
+
+    //! Checks the constraints for <n> nodes, satisfied[i] is set to 1 iff nodes[i] satisfies all constraints.
+    void areSatisfied(const LNode* const* nodes, std::size_t n, char* satisfied) const
+    {
+        satisfied_batch_(nodes, n, obstacle_threshold_, satisfied);
+    }
+
+public:
+    typedef double (*ScoreOneFn)(const LNode&, const double*);
+    typedef void (*ScoreBatchFn)(const LNode* const*, std::size_t, const double*, double*);
+    typedef bool (*SatisfiedOneFn)(const LNode&, double);
+    typedef void (*SatisfiedBatchFn)(const LNode* const*, std::size_t, double, char*);
+
+private:
+    bool scorers_valid_;
+    bool constraints_valid_;
+
+    double weights_[SCORER_KERNELS];
+    double obstacle_threshold_;
+
+    ScoreOneFn score_one_;
+    ScoreBatchFn score_batch_;
+    SatisfiedOneFn satisfied_one_;
+    SatisfiedBatchFn satisfied_batch_;
+};
+
+#endif // EVALUATION_PIPELINE_H
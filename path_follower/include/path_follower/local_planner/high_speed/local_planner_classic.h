@@ -3,6 +3,7 @@
 
 /// PROJECT
 #include <path_follower/local_planner/high_speed_local_planner.h>
+#include <path_follower/local_planner/evaluation_pipeline.h>
 
 class LocalPlannerClassic : public HighSpeedLocalPlanner
 {
@@ -25,6 +26,8 @@ protected:
 
     double Score(const LNode& current);
 
+    void Score(const std::vector<LNode*>& nodes, std::vector<double>& scores);
+
     void checkQuarters(LNode child, LNode* parent, LNode& first, LNode& mid, LNode& second);
 
     bool createAlternative(LNode*& s_p, LNode& alt, bool allow_lines = false);
@@ -61,6 +64,10 @@ private:
 
     void setStep();
 
+    void initPrimitives();
+
+    void expandPrimitives(const LNode& current);
+
     double computeFrontier(double& angle);
 
     virtual bool algo(Eigen::Vector3d& pose, SubPath& local_wps,
@@ -122,6 +129,17 @@ private:
 
     PathInterpolated last_local_path_;
 
+    //! fused scorers and constraints, used if all of them are known to the pipeline
+    EvaluationPipeline pipeline_;
+    //! motion primitives in the frame of the parent node: offset, heading change and radius of each successor
+    std::vector<double> prim_dx_, prim_dy_, prim_dtheta_, prim_radius_;
+    std::vector<double> succ_x_, succ_y_;
+
+    //! candidate successors of the current expansion
+    std::vector<LNode> candidates_;
+    std::vector<const LNode*> candidate_ptrs_;
+    std::vector<char> candidate_sat_;
+
     double step_, neig_s, FFL, beta2;
 };
 
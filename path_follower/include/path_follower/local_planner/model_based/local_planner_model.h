@@ -35,6 +35,7 @@ public:
 
     Path::Ptr updateLocalPath_BaseLink();
     Path::Ptr updateLocalPath_LocalMap();
+    Path::Ptr updateLocalPath_Refined();
 
     Path::Ptr CreateDummyWps();
 
@@ -67,7 +68,7 @@ private:
 
     bool transform2base(ros::Time& now);
 
-    bool transformWPS(std::string source, std::string target, SubPath &waypoints, ros::Time& now);
+    bool transformWPS(std::string source, std::string target, SubPath &waypoints, ros::Time& now, tf::Transform& transform);
 
     bool GetTransform(ros::Time time,std::string targetFrame, std::string sourceFrame, tf::StampedTransform &trans);
 
@@ -77,6 +78,8 @@ private:
     void printVelocity() const;
     void printLevelReached() const;
     bool algo(SubPath& local_wps);
+    bool resultToWaypoints(SubPath& local_wps);
+    void applyTransform(const tf::Transform &transform, SubPath &waypoints) const;
 
     void PublishDebugImage();
 
@@ -99,6 +102,9 @@ protected:
 
     ros::Time last_update_;
 
+    //! transform used for the waypoints of the planning that started the current refinement, refined results are planned in the same frame
+    tf::Transform refinement_transform_;
+
     int numFrames_;
     double totalPlanningTime_;
 };
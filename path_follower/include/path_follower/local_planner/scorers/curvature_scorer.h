@@ -14,6 +14,13 @@ public:
     static void setMaxC(double& radius);
 
     virtual double score(const LNode& point) override;
+
+    //! Score without timing, shared with the EvaluationPipeline.
+    static double compute(double radius)
+    {
+        return radius < std::numeric_limits<double>::infinity() ? std::abs(1.0/radius) : 0.0;
+    }
+
 private:
     static double MAX_CURV;
 };
@@ -14,6 +14,15 @@ public:
     static void setMaxC(double& radius);
 
     virtual double score(const LNode& point) override;
+
+    //! Score of a node with a parent without timing, shared with the EvaluationPipeline.
+    static double compute(double radius, double parent_radius)
+    {
+        double c_curv = radius < std::numeric_limits<double>::infinity() ? 1.0/radius : 0.0;
+        double p_curv = parent_radius < std::numeric_limits<double>::infinity() ? 1.0/parent_radius : 0.0;
+        return c_curv - p_curv;
+    }
+
 private:
     static double MAX_CURV;
 };
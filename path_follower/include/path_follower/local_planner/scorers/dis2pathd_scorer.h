@@ -15,6 +15,12 @@ public:
 
     virtual double score(const LNode& point) override;
 
+    //! Score of a node with a parent without timing, shared with the EvaluationPipeline.
+    static double compute(double d2p, double parent_d2p)
+    {
+        return d2p - parent_d2p;
+    }
+
 private:
     static double MAX_DIS;
 };
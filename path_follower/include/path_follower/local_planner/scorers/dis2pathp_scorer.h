@@ -15,6 +15,12 @@ public:
 
     virtual double score(const LNode& point) override;
 
+    //! Score without timing, shared with the EvaluationPipeline.
+    static double compute(double d2p)
+    {
+        return d2p;
+    }
+
 private:
     static double MAX_DIS;
 };
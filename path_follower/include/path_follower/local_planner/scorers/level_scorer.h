@@ -16,6 +16,12 @@ public:
 
     virtual double score(const LNode& point) override;
 
+    //! Score without timing, shared with the EvaluationPipeline.
+    static double compute(int level)
+    {
+        return (double)(max_level - level);
+    }
+
 private:
     static int max_level;
 };
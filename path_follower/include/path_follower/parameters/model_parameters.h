@@ -38,6 +38,11 @@ public:
     P<double> look_ahead_time;//        float lookAheadTime;
 
     P<int> replan_factor;//        int replanFactor;
+    P<bool> anytime_refinement;//        bool anytimeRefinement;
+    P<double> refinement_deadline;//        float refinementDeadline;
+    P<int> pose_cache_block_size;//        int poseCacheBlockSize;
+    P<double> pose_cache_resolution;//        float poseCacheResolution;
+    P<int> pose_cache_max_entries;//        int poseCacheMaxEntries;
 
     //
 
@@ -112,6 +117,11 @@ public:
         config.plannerConfig_.numSubSamples = curve_segment_subdivisions();
         config.plannerConfig_.lookAheadTime = look_ahead_time();
         config.plannerConfig_.replanFactor = replan_factor();
+        config.plannerConfig_.anytimeRefinement = anytime_refinement();
+        config.plannerConfig_.refinementDeadline = refinement_deadline();
+        config.plannerConfig_.poseCacheBlockSize = pose_cache_block_size();
+        config.plannerConfig_.poseCacheResolution = pose_cache_resolution();
+        config.plannerConfig_.poseCacheMaxEntries = pose_cache_max_entries();
 
 
         //Scorer
@@ -190,6 +200,11 @@ public:
         curve_segment_subdivisions(this, "curve_segment_subdivisions", 20, "Determines the number of subdivisions of curve segments in the final path"),
         look_ahead_time(this, "look_ahead_time", 3.0, "look ahead time for model based planner"),
         replan_factor(this, "replan_factor", -1, " multiply number of splits and divide delta theta by this factor for replanning. <0 to disable replanning"),
+        anytime_refinement(this, "anytime_refinement", false, "Use the first planning result immediately and replan with replan_factor on a background thread"),
+        refinement_deadline(this, "refinement_deadline", 0.05, "Time in seconds after the start of planning when the background refinement is stopped"),
+        pose_cache_block_size(this, "pose_cache_block_size", 0, "Size in pixels of the DEM blocks checked for changes to keep pose evaluations cached across planning cycles. 0 disables the cache"),
+        pose_cache_resolution(this, "pose_cache_resolution", 1.0, "Position quantization in pixels of cached pose evaluations"),
+        pose_cache_max_entries(this, "pose_cache_max_entries", 200000, "Maximum number of cached pose evaluations"),
         // Model based scores
         grav_angle_threshold(this, "grav_angle_threshold", 0.2, "Min value for angle between robot and gravity "),
         delta_angle_threshold(this, "delta_angle_threshold", 0.1, "Min value for angle between old and new robot pose "),
@@ -28,6 +28,9 @@ public:
     P<float> min_velocity;
     P<float> max_velocity;
     P<bool> abort_if_obstacle_ahead;
+    P<bool> tf_snapshot;
+    P<double> tf_snapshot_tolerance;
+    P<bool> interpolation_single_precision;
 
 private:
     PathFollowerParameters():
@@ -59,7 +62,18 @@ private:
         abort_if_obstacle_ahead(this, "abort_if_obstacle_ahead",  false,
                                 "If set to true, path execution is aborted, if an obstacle is"
                                 " detected on front of the robot. If false, the robot will"
-                                " stop, but not abort (the obstacle might move away).")
+                                " stop, but not abort (the obstacle might move away)."),
+
+        tf_snapshot(this, "tf_snapshot", true,
+                    "If set to true, the transforms used during a control tick are looked up once at the"
+                    " start of the tick and all lookups of the tick are answered from this snapshot."),
+        tf_snapshot_tolerance(this, "tf_snapshot_tolerance", 0.05,
+                              "Lookups for a time that is older than the snapshot by more than this (in s)"
+                              " bypass the snapshot."),
+
+        interpolation_single_precision(this, "interpolation_single_precision", false,
+                                       "If set to true, the interpolated path is evaluated in single precision,"
+                                       " which processes twice as many points per SIMD instruction.")
 
       /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     {
@@ -15,6 +15,7 @@
 
 /// PROJECT
 #include <path_follower/utils/path_follower_config.h>
+#include <path_follower/utils/perception_snapshot.h>
 
 /// SYSTEM
 #include <ros/node_handle.h>
@@ -202,10 +203,8 @@ private:
 
     const LocalPlannerParameters& opt_l_;
 
-    //! The last received obstacle cloud
-    std::shared_ptr<ObstacleCloud const> obstacle_cloud_;
-    //! The last received elevation map
-    std::shared_ptr<ElevationMap const> elevation_map_;
+    //! The last received obstacle cloud and elevation map, written by the sensor callbacks
+    PerceptionInputs perception_;
 
     //! Path driven by the robot
     visualization_msgs::Marker g_robot_path_marker_;
@@ -43,11 +43,12 @@ struct Obstacle
  *   - Add observed obstacles w/o matching partner in the list of currently tracked obstacles as new.
  *
  * Matching:
- *   1) Construct a matrix with all distances between tracked and observed obstacles (observed = rows, tracked = columns)
- *   2) Search the matrix for the pair with the minimal distance. Match this pair.
- *   3) Remove the row and the column, related to the matched obstacles, from the distance matrix.
- *   4) Iterate until distance matrix is empty (= all are matched), or the minimal distance in the remaining matrix is
- *      greater than a defined threshold (-> do not match, if they are to far away from each other).
+ *   1) Gating: only pairs of a tracked and an observed obstacle that are at most max_dist apart are candidates.
+ *      The candidates are found with a grid over the tracked obstacles, not by comparing all pairs.
+ *   2) The candidate pairs split the obstacles into independent groups (connected components). In crowded
+ *      scenes these are still small.
+ *   3) Each group is matched optimally with the Hungarian algorithm: as many pairs as possible are matched,
+ *      with the minimal sum of distances. Groups that are too large for that are matched greedily by distance.
  *
  * Currently only the center point of an obstacle is used.
  */
@@ -112,7 +113,7 @@ public:
         opt_.max_dist.set(md);
     }
 
-    std::vector<TrackedObstacle> getTrackedObstacles() const
+    const std::vector<TrackedObstacle>& getTrackedObstacles() const
     {
         return obstacles_;
     }
@@ -122,7 +123,17 @@ public:
      * @brief Update the list ob tracked obstacles with a new observation.
      * @param obstacles List of obstacles observed in the last scan.
      */
-    void update(std::vector<Obstacle> obstacles);
+    void update(const std::vector<Obstacle>& obstacles);
+
+    /**
+     * @brief Match observed with tracked positions, see class comment.
+     * @param observed Positions of the observed obstacles.
+     * @param tracked Positions of the tracked obstacles.
+     * @param max_dist Pairs that are farther apart are never matched.
+     * @return For each observed position the index of the matched tracked position or -1.
+     */
+    static std::vector<int> match(const std::vector<cv::Point2f>& observed, const std::vector<cv::Point2f>& tracked,
+                                  float max_dist);
 
     //! Reset the tracker (= drop all tracked obstacles).
     void reset();
@@ -144,23 +155,9 @@ private:
     //! List of tracked obstacles
     std::vector<TrackedObstacle> obstacles_;
 
-    //! Check if an obstacle is dead (= no observation for more than the allowed ''lost lifetime'') and thus can be
-    //! removed from the list.
-    bool isDead(TrackedObstacle o);
-
-    /**
-     * @brief Remove a row from a matrix.
-     * @param m    The matrix.
-     * @param row  Row-Index.
-     */
-    static inline void removeRow(cv::Mat &m, int row);
-
-    /**
-     * @brief Remove a column from a matrix.
-     * @param m    The matrix.
-     * @param col  Column-Index.
-     */
-    static inline void removeColumn(cv::Mat &m, int col);
+    //! Check if an obstacle is dead (= no observation for more than the allowed ''lost lifetime'' before <now>) and
+    //! thus can be removed from the list.
+    bool isDead(const TrackedObstacle& o, const ros::Time& now) const;
 };
 
 #endif // OBSTACLETRACKER_H
@@ -16,6 +16,8 @@ public:
 
 private:
     std::list<Supervisor::Ptr> supervisors_;
+    //! stage names of the supervisors for tracing, same order as supervisors_
+    std::list<const char*> trace_names_;
 };
 
 #endif // SUPERVISORCHAIN_H
@@ -42,18 +42,64 @@ public:
 
 // spline interpolation
 class spline {
+public:
+   // boundary conditions: zero curvature at both ends, or a parabola on the
+   // first and last segment (zero third derivative)
+   enum bd_type { natural, parabolic };
+
 private:
    std::vector<double> m_x,m_y;           // x,y coordinates of points
    // interpolation parameters
    // f(x) = a*(x-x_i)^3 + b*(x-x_i)^2 + c*(x-x_i) + y_i
    std::vector<double> m_a,m_b,m_c,m_d;
+
+   friend class spline_curve;
 public:
    void set_points(const std::vector<double>& x,
-                   const std::vector<double>& y, bool cubic_spline=true);
+                   const std::vector<double>& y, bool cubic_spline=true,
+                   bd_type boundary=natural);
    double operator() (double x) const;
 };
 
 
+// samples of a planar curve, see spline_curve
+template <typename T>
+struct curve_samples {
+   std::vector<T> p,q;                    // position
+   std::vector<T> p_prim,q_prim;          // first derivative
+   std::vector<T> p_sek,q_sek;            // second derivative
+   std::vector<T> curvature;
+
+   void resize(std::size_t n);
+};
+
+// planar curve (p(s), q(s)) of two splines over the same knots
+//
+// evaluate() computes position, first and second derivative and curvature
+// for many parameter values at once: the segments are looked up in one
+// pass (linear for ascending parameters) and the polynomials are evaluated
+// with SIMD in blocks. T is float or double, float gives twice the lanes.
+class spline_curve {
+private:
+   spline m_p,m_q;
+public:
+   void set_points(const std::vector<double>& s,
+                   const std::vector<double>& p,
+                   const std::vector<double>& q,
+                   spline::bd_type boundary=spline::natural);
+
+   template <typename T>
+   void evaluate(const std::vector<T>& s, curve_samples<T>& out) const;
+
+   const spline& p() const {
+      return m_p;
+   }
+   const spline& q() const {
+      return m_q;
+   }
+};
+
+
 
 
 
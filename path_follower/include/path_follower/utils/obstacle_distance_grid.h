@@ -0,0 +1,72 @@
+#ifndef PATH_FOLLOWER_OBSTACLE_DISTANCE_GRID_H
+#define PATH_FOLLOWER_OBSTACLE_DISTANCE_GRID_H
+
+/// THIRD PARTY
+#include <opencv2/core/core.hpp>
+
+/// SYSTEM
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Distance to the nearest obstacle, precomputed for every cell of a square window.
+ *
+ * The obstacle points are rasterised into the window and an exact euclidean distance transform of the
+ * occupied cells is computed, so a query is a single lookup. Distances are measured between cell centers,
+ * so they are exact up to about resolution * sqrt(2).
+ */
+class ObstacleDistanceGrid
+{
+public:
+    ObstacleDistanceGrid();
+
+    /**
+     * @brief build computes the distance field for queries within <radius> around <center>. Distances larger
+     *        than <max_distance> are not needed, so only points within radius + max_distance are rasterised.
+     *        If the window would need too many cells, the resolution is reduced. Buffers are reused between calls.
+     */
+    void build(const std::vector<cv::Point2f>& points, const cv::Point2f& center, float radius,
+               float max_distance, float resolution);
+
+    /**
+     * @brief distance returns the distance from (x, y) to the nearest obstacle, or infinity if there is
+     *        no obstacle within max_distance or (x, y) is outside of the window.
+     */
+    float distance(float x, float y) const
+    {
+        int cx = static_cast<int>(std::floor((x - origin_x_) / resolution_));
+        int cy = static_cast<int>(std::floor((y - origin_y_) / resolution_));
+        if(cx < 0 || cy < 0 || cx >= size_ || cy >= size_) {
+            return std::numeric_limits<float>::infinity();
+        }
+        return distance_[cy * size_ + cx];
+    }
+
+    float resolution() const
+    {
+        return resolution_;
+    }
+    //! Number of cells along each axis
+    int size() const
+    {
+        return size_;
+    }
+
+private:
+    float origin_x_;
+    float origin_y_;
+    float resolution_;
+    int size_;
+
+    //! squared distances in cells during the transform, distances in m afterwards
+    std::vector<float> distance_;
+
+    //! buffers of the 1d transform
+    std::vector<float> line_;
+    std::vector<float> line_out_;
+    std::vector<int> parabola_;
+    std::vector<float> boundary_;
+};
+
+#endif // PATH_FOLLOWER_OBSTACLE_DISTANCE_GRID_H
@@ -0,0 +1,41 @@
+#ifndef PATH_FOLLOWER_OBSTACLE_INDEX_H
+#define PATH_FOLLOWER_OBSTACLE_INDEX_H
+
+/// PROJECT
+#include <path_follower/utils/obstacle_cloud.h>
+#include <path_follower/utils/point_grid.h>
+
+/// SYSTEM
+#include <Eigen/Core>
+#include <vector>
+
+/**
+ * @brief Grid index over an obstacle cloud for nearest obstacle queries.
+ *
+ * The index is only rebuilt if a different cloud is passed to update(), so it can be updated on every
+ * control tick, but is rebuilt only once per received cloud.
+ */
+class ObstacleIndex
+{
+public:
+    /**
+     * @brief update indexes <obstacles>, if they are not indexed already.
+     */
+    void update(const ObstacleCloud::ConstPtr& obstacles);
+
+    /**
+     * @brief nearest finds the obstacle point with the minimal (3d) distance to <query>.
+     *        Query and result are given in the frame of the cloud.
+     * @return false, if there are no obstacles
+     */
+    bool nearest(const Eigen::Vector3d& query, Eigen::Vector3d& result) const;
+
+private:
+    ObstacleCloud::ConstPtr obstacles_;
+
+    std::vector<cv::Point2f> points_;
+    std::vector<float> z_;
+    PointGrid grid_;
+};
+
+#endif // PATH_FOLLOWER_OBSTACLE_INDEX_H
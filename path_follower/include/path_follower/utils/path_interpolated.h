@@ -71,6 +71,18 @@ public:
     double curvature_prim(const unsigned int i) const;
     double curvature_sek(const unsigned int i) const;
 
+    /**
+     * @brief index_ahead finds the first index after <i>, that is at least <distance> ahead of <i> in path
+     *        coordinates, or the last index if the path is shorter. O(1), as the path is sampled uniformly.
+     */
+    unsigned int index_ahead(const unsigned int i, const double distance) const;
+
+    /**
+     * @brief curvature_abs_sum sums the absolute curvature of the indices <first> to <last> (inclusive) in O(1).
+     * @return NaN if the curvature is not finite at one of the indices.
+     */
+    double curvature_abs_sum(const unsigned int first, const unsigned int last) const;
+
     inline double theta_p(const unsigned int i) const {
         return atan2(q_prim_.at(i), p_prim_.at(i));
     }
@@ -124,6 +136,9 @@ private:
     std::vector<double> q_sek_;
     //curvature in path coordinates
 	std::vector<double> curvature_;
+    //prefix sums of the absolute curvature and of the number of non-finite curvature values
+    std::vector<double> curvature_abs_sum_;
+    std::vector<unsigned int> curvature_invalid_count_;
 
     //next point
     double s_new_;
@@ -0,0 +1,58 @@
+#ifndef PERCEPTION_SNAPSHOT_H
+#define PERCEPTION_SNAPSHOT_H
+
+/// SYSTEM
+#include <cstdint>
+#include <memory>
+
+class ObstacleCloud;
+class ElevationMap;
+
+/**
+ * @brief The PerceptionSnapshot struct is one immutable generation of all perception inputs.
+ */
+struct PerceptionSnapshot
+{
+    using ConstPtr = std::shared_ptr<PerceptionSnapshot const>;
+
+    //! Incremented by every update of one of the inputs
+    std::uint64_t generation = 0;
+
+    std::shared_ptr<ObstacleCloud const> obstacle_cloud;
+    std::shared_ptr<ElevationMap const> elevation_map;
+};
+
+/**
+ * @brief The PerceptionInputs class holds the latest PerceptionSnapshot (read-copy-update).
+ *
+ * Sensor callbacks replace single inputs from any thread, a control tick takes one snapshot and reads
+ * all inputs from it. A snapshot is never modified after it has been published, so all stages of a
+ * tick see the same generation, even if new data arrives during the tick.
+ */
+class PerceptionInputs
+{
+public:
+    PerceptionInputs();
+
+    /**
+     * @brief snapshot returns the current generation, never nullptr. Does not block writers.
+     */
+    PerceptionSnapshot::ConstPtr snapshot() const;
+
+    void setObstacleCloud(const std::shared_ptr<ObstacleCloud const>& cloud);
+    void setElevationMap(const std::shared_ptr<ElevationMap const>& map);
+
+private:
+    /**
+     * @brief update publishes a copy of the current snapshot, modified by <modify>.
+     *        Concurrent updates are retried, so none of them is lost.
+     */
+    template <typename Modify>
+    void update(Modify modify);
+
+private:
+    //! only accessed with std::atomic_load / std::atomic_compare_exchange_weak
+    PerceptionSnapshot::ConstPtr current_;
+};
+
+#endif // PERCEPTION_SNAPSHOT_H
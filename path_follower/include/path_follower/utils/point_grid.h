@@ -0,0 +1,104 @@
+#ifndef PATH_FOLLOWER_POINT_GRID_H
+#define PATH_FOLLOWER_POINT_GRID_H
+
+/// THIRD PARTY
+#include <opencv2/core/core.hpp>
+
+/// SYSTEM
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Uniform grid over the bounding box of a set of 2d points.
+ *
+ * The point indices are sorted into the cells with a counting sort. Every cell is a contiguous range
+ * of indices, so a box query only touches the cells overlapping the box.
+ */
+class PointGrid
+{
+public:
+    PointGrid();
+
+    /**
+     * @brief build sorts the points into square cells of <cell_size>. If the bounding box of the points
+     *        would need more than <max_cells> cells, the cells are enlarged.
+     *        Buffers are reused between calls.
+     */
+    void build(const std::vector<cv::Point2f>& points, float cell_size, std::size_t max_cells);
+
+    float cellSize() const
+    {
+        return cell_size_;
+    }
+    int width() const
+    {
+        return width_;
+    }
+    int height() const
+    {
+        return height_;
+    }
+
+    //! Cell coordinates, may be outside of the grid.
+    int cellX(float x) const
+    {
+        return static_cast<int>(std::floor((x - origin_x_) / cell_size_));
+    }
+    int cellY(float y) const
+    {
+        return static_cast<int>(std::floor((y - origin_y_) / cell_size_));
+    }
+
+    //! Range of point indices in cell (cx, cy), which has to be inside of the grid.
+    const std::uint32_t* begin(int cx, int cy) const
+    {
+        return indices_.data() + cell_start_[cy * width_ + cx];
+    }
+    const std::uint32_t* end(int cx, int cy) const
+    {
+        return indices_.data() + cell_start_[cy * width_ + cx + 1];
+    }
+
+    /**
+     * @brief forEachInBox calls <callback> with the index of every point in the cells overlapping the box.
+     *        Points near the border of the box may lie outside of it.
+     */
+    template <typename Callback>
+    void forEachInBox(float min_x, float min_y, float max_x, float max_y, Callback callback) const
+    {
+        if(width_ == 0) {
+            return;
+        }
+        int x0 = std::max(0, cellX(min_x));
+        int y0 = std::max(0, cellY(min_y));
+        int x1 = std::min(width_ - 1, cellX(max_x));
+        int y1 = std::min(height_ - 1, cellY(max_y));
+        if(x0 > x1 || y0 > y1) {
+            return;
+        }
+        for(int cy = y0; cy <= y1; ++cy) {
+            // the cells of one row are contiguous
+            const std::uint32_t* it = begin(x0, cy);
+            const std::uint32_t* last = end(x1, cy);
+            for(; it < last; ++it) {
+                callback(*it);
+            }
+        }
+    }
+
+private:
+    float cell_size_;
+    float origin_x_;
+    float origin_y_;
+    int width_;
+    int height_;
+
+    //! cell_start_[c] .. cell_start_[c+1] is the range of cell c = cy * width_ + cx in indices_
+    std::vector<std::uint32_t> cell_start_;
+    std::vector<std::uint32_t> indices_;
+    std::vector<std::uint32_t> cell_of_point_;
+};
+
+#endif // PATH_FOLLOWER_POINT_GRID_H
@@ -5,6 +5,8 @@
 #include <tf/transform_listener.h>
 #include <nav_msgs/Odometry.h>
 #include <Eigen/Core>
+#include <cstdint>
+#include <mutex>
 
 class PathFollowerParameters;
 
@@ -13,6 +15,53 @@ class PathFollowerParameters;
  */
 class PoseTracker
 {
+public:
+    /**
+     * @brief The Tick class takes a snapshot of the transforms for the lifetime of the object, see beginTick().
+     */
+    class Tick
+    {
+    public:
+        explicit Tick(PoseTracker& tracker);
+        ~Tick();
+
+        Tick(const Tick&) = delete;
+        Tick& operator=(const Tick&) = delete;
+
+    private:
+        PoseTracker& tracker_;
+    };
+
+    /**
+     * @brief The Prediction class makes getRobotPose() and getRobotPoseMsg() return the pose predicted
+     *        for <actuation_time> for the lifetime of the object, see beginPrediction().
+     */
+    class Prediction
+    {
+    public:
+        Prediction(PoseTracker& tracker, bool enabled, const ros::Time& actuation_time);
+        ~Prediction();
+
+        Prediction(const Prediction&) = delete;
+        Prediction& operator=(const Prediction&) = delete;
+
+    private:
+        PoseTracker& tracker_;
+        bool enabled_;
+    };
+
+    /**
+     * @brief Lookups answered from the snapshot and lookups that had to query tf.
+     */
+    struct CacheStatistics
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        //! total and longest time spent in tf for misses
+        double wait_ms;
+        double max_wait_ms;
+    };
+
 public:
     PoseTracker(const PathFollowerParameters& opt, ros::NodeHandle& nh);
 
@@ -61,6 +110,13 @@ public:
      */
     geometry_msgs::Twist getVelocity() const;
 
+    /**
+     * @brief setOdometry updates the odometry pose and velocity.
+     *        Is called for every received odometry message, can also be used to feed recorded data.
+     * @param odom the latest odometry
+     */
+    void setOdometry(const nav_msgs::Odometry& odom);
+
     /**
      * @brief getTransform returns the transformation between the two given frames at time <time>.
      *        If the transformation is not availible at time <time>, the latest transform will be returned.
@@ -85,6 +141,22 @@ public:
     tf::Transform getTransformLatest(const std::string &fixed_frame, const std::string &frame) const;
 
 
+    /**
+     * @brief lookupTransform looks up the transform at time <time>. If it is not available yet,
+     *        it waits up to <max_wait> for it.
+     * @return false, iff the transform is not available
+     */
+    bool lookupTransform(const std::string& target_frame, const std::string& source_frame, const ros::Time& time,
+                         const ros::Duration& max_wait, tf::StampedTransform& trafo) const;
+
+    /**
+     * @brief lookupLatestTransform looks up the latest transform. If there is none, it waits up to <max_wait>
+     *        for the transform at time <now>.
+     * @return false, iff the transform is not available
+     */
+    bool lookupLatestTransform(const std::string& target_frame, const std::string& source_frame, const ros::Time& now,
+                               const ros::Duration& max_wait, tf::StampedTransform& trafo) const;
+
     /**
      * @brief getRelativeTransform returns the transformation between the robot frame and the given frame at time <time>.
      *        If the transformation is not availible at time <time>, the latest transform will be returned.
@@ -128,6 +200,32 @@ public:
      */
     bool updateRobotPose();
 
+    /**
+     * @brief beginTick takes a snapshot of all transforms that were used in previous ticks and of the
+     *        transforms between the world, odom and robot frame.
+     *        Until endTick(), lookups for the latest transform or for times not older than the snapshot
+     *        are answered from it without querying tf, transforms that are missing are added on first use.
+     *        Does nothing, if the parameter tf_snapshot is false.
+     */
+    void beginTick();
+    void endTick();
+
+    /**
+     * @brief beginPrediction extrapolates the robot pose from the time stamp of its transform (or odometry
+     *        message) to <actuation_time> with the velocity of the last odometry message.
+     *        Until endPrediction(), getRobotPose() and getRobotPoseMsg() return the predicted pose.
+     */
+    void beginPrediction(const ros::Time& actuation_time);
+    void endPrediction();
+
+    /**
+     * @brief extrapolate moves <pose> for <dt> seconds with the constant body frame velocity <twist>.
+     */
+    static Eigen::Vector3d extrapolate(const Eigen::Vector3d& pose, const geometry_msgs::Twist& twist, double dt);
+
+    CacheStatistics getCacheStatistics() const;
+    void resetCacheStatistics();
+
     /**
      * @brief getTransformListener accesses the underlying tf::TransformListener.
      * @return the underlying tf::TransformListener
@@ -141,7 +239,18 @@ private:
     //! Update the current pose of the robot.
     /** @see robot_pose_, robot_pose_msg_ */
 
-    bool getWorldPose(Eigen::Vector3d *pose_vec, geometry_msgs::Pose* pose_msg = nullptr) const;
+    bool getWorldPose(Eigen::Vector3d *pose_vec, geometry_msgs::Pose* pose_msg = nullptr, ros::Time* stamp = nullptr) const;
+
+    //! Looks up the transform in the snapshot, returns false if it has to be queried from tf.
+    bool lookupSnapshot(const std::string& target_frame, const std::string& source_frame, const ros::Time& time,
+                        tf::StampedTransform& trafo) const;
+    //! Adds a transform that was queried from tf during a tick to the snapshot.
+    void storeSnapshot(const std::string& target_frame, const std::string& source_frame, const ros::Time& time,
+                       const tf::StampedTransform& trafo) const;
+    void countMiss(std::uint64_t start_ns) const;
+
+    tf::StampedTransform lookupTransformUncached(const std::string &fixed_frame, const std::string &frame,
+                                                 const ros::Time &time, const ros::Duration& max_wait) const;
 
 private:
     const PathFollowerParameters& opt_;
@@ -161,7 +270,29 @@ private:
     geometry_msgs::Pose robot_pose_world_msg_;
     geometry_msgs::Pose robot_pose_odom_msg_;
 
+    //! Time stamp of the transform robot_pose_world_ was computed from.
+    ros::Time robot_pose_world_stamp_;
+
+    //! Pose predicted for the actuation time, returned instead of the current pose during a prediction.
+    bool prediction_active_;
+    Eigen::Vector3d robot_pose_predicted_;
+    geometry_msgs::Pose robot_pose_predicted_msg_;
+
     bool local_;
+
+    struct SnapshotEntry
+    {
+        std::string target_frame;
+        std::string source_frame;
+        tf::StampedTransform trafo;
+        bool valid;
+    };
+
+    mutable std::mutex snapshot_mutex_;
+    bool snapshot_active_;
+    //! frame pairs used in the previous ticks, refreshed at the start of every tick
+    mutable std::vector<SnapshotEntry> snapshot_;
+    mutable CacheStatistics statistics_;
 };
 
 #endif // POSE_TRACKER_H
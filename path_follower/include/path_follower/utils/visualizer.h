@@ -3,11 +3,16 @@
 
 /// STL
 #include <string>
+#include <map>
+#include <mutex>
+#include <vector>
 
 /// ROS
 #include <ros/ros.h>
 #include <geometry_msgs/Point.h>
 #include <geometry_msgs/Pose.h>
+#include <visualization_msgs/Marker.h>
+#include <visualization_msgs/MarkerArray.h>
 
 /// OTHER
 #include <Eigen/Core>
@@ -24,10 +29,32 @@
  * <code>
  *    Visualizer *vis = Visualizer::getInstance();
  * </code>
+ *
+ * Markers drawn while a Frame exists are collected and published when the frame ends, each on the topic it is
+ * drawn for: single markers on visualization_marker, marker arrays as one array on visualization_marker_array.
+ * Without subscribers to that topic, the draw functions return before building any marker.
  */
 class Visualizer
 {
 public:
+    /**
+     * @brief Collects all markers drawn during its lifetime (e.g. one control tick) and publishes them at its end.
+     *
+     * <code>
+     *    Visualizer::Frame frame;
+     *    ... // draw calls
+     * </code>
+     */
+    class Frame
+    {
+    public:
+        Frame();
+        ~Frame();
+
+        Frame(const Frame&) = delete;
+        Frame& operator = (const Frame&) = delete;
+    };
+
     //! Get a pointer to the Visualizer object.
     static Visualizer* getInstance();
 
@@ -42,6 +69,17 @@ public:
     bool hasSubscriber();
     bool MarrayhasSubscriber();
 
+    /**
+     * @brief Limit the rate at which markers of a namespace are drawn.
+     *
+     * All markers of the namespace that are drawn in the same frame are either published or skipped together.
+     * Limits can also be set with the parameter `~visualization/rate_limits` (map of namespace to rate).
+     *
+     * @param ns    Namespace of the markers.
+     * @param rate  Maximum rate in Hz, 0 removes the limit.
+     */
+    void setRateLimit(const std::string& ns, double rate);
+
     /**
      * @brief Publish an arrow marker.
      * @param id    ID of the marker.
@@ -138,6 +176,7 @@ public:
 
     /**
      * @brief Draw a moving Frenet-Serret frame with the distance vector.
+     * The markers are rate limited together under the namespace "path_coord".
      * @param id        ID of the marker.
      * @param robot_pose  Pose of the robot.
      * @param xe        Error in F-S frame, x component.
@@ -153,12 +192,40 @@ public:
     ros::Publisher getMarkerArrayPublisher();
 
 private:
+    struct RateLimit
+    {
+        ros::Duration period;
+        ros::Time last;
+        int frame = -1;
+        bool accepted = false;
+    };
+
     ros::NodeHandle nh_;
     ros::NodeHandle private_nh_;
     ros::Publisher vis_pub_;
     ros::Publisher marray_vis_pub_;
 
+    mutable std::mutex mutex_;
+    // nesting depth of frames, markers are batched while > 0
+    int frame_depth_;
+    // incremented for every frame and for every marker drawn outside of a frame
+    mutable int frame_count_;
+    bool frame_has_marker_subscriber_;
+    bool frame_has_array_subscriber_;
+    // markers of the current frame, for vis_pub_ and marray_vis_pub_
+    mutable std::vector<visualization_msgs::Marker> marker_batch_;
+    mutable visualization_msgs::MarkerArray array_batch_;
+    mutable std::map<std::string, RateLimit> rate_limits_;
+
     Visualizer();
+
+    void beginFrame();
+    void endFrame();
+
+    //! Check subscribers of the marker (or array) topic and rate limit of the namespace before a marker is built.
+    bool shouldDraw(const std::string& ns, bool array = false) const;
+    void publish(const visualization_msgs::Marker& marker) const;
+    void publish(const visualization_msgs::MarkerArray& array) const;
 };
 
 #endif // VISUALIZER_H
@@ -0,0 +1,69 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/// SYSTEM
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The WorkerPool class keeps a fixed set of threads alive between parallel loops.
+ *
+ * A control tick is far too short to start and join threads for every loop, so the workers sleep on a
+ * condition variable and are only woken up for each call of parallelFor.
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @brief WorkerPool
+     * @param threads number of threads working on a loop, including the calling thread
+     */
+    explicit WorkerPool(std::size_t threads = 1);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator = (const WorkerPool&) = delete;
+
+    //! Number of threads working on a loop, including the calling thread
+    std::size_t size() const;
+
+    /**
+     * @brief resize stops the workers and starts <threads> - 1 new ones, must not be called during parallelFor
+     */
+    void resize(std::size_t threads);
+
+    /**
+     * @brief parallelFor calls <f> for every index in [0, n) on the workers and the calling thread.
+     *        The indices are handed out one by one, returns when all calls are finished.
+     */
+    void parallelFor(std::size_t n, const std::function<void(std::size_t)>& f);
+
+private:
+    void start(std::size_t threads);
+    void stop();
+
+    void workerLoop(unsigned long generation);
+    void work(const std::function<void(std::size_t)>& f, std::size_t n);
+
+private:
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable job_cond_;
+    std::condition_variable done_cond_;
+
+    //! the current loop, guarded by mutex_
+    const std::function<void(std::size_t)>* job_;
+    std::size_t job_size_;
+    unsigned long generation_;
+    std::size_t busy_;
+    bool stop_;
+
+    std::atomic<std::size_t> next_;
+};
+
+#endif // WORKER_POOL_H
@@ -8,6 +8,7 @@
 #include <path_follower/utils/visualizer.h>
 #include <path_follower/collision_avoidance/collision_avoider.h>
 #include <path_follower/utils/obstacle_cloud.h>
+#include <nav_tracing/tracing.h>
 
 ///SYSTEM
 #include <pcl_ros/point_cloud.h>
@@ -312,18 +313,11 @@ bool RobotController::isGoalReached(MoveCommand *cmd)
 double RobotController::exponentialSpeedControl()
 {
 
-    //compute the curvature, and stop when the look-ahead distance is reached (w.r.t. orthogonal projection)
-    double s_cum_sum = 0;
+    //sum up the curvature from the orthogonal projection up to the look-ahead distance
     curv_sum_ = 0.0;
-
-    for (unsigned int i = proj_ind_ + 1; i < path_interpol.n(); i++){
-
-        s_cum_sum = path_interpol.s(i) - path_interpol.s(proj_ind_);
-        curv_sum_ += std::abs(path_interpol.curvature(i));
-
-        if(s_cum_sum - look_ahead_dist_ >= 0){
-            break;
-        }
+    if(proj_ind_ + 1 < path_interpol.n()) {
+        unsigned int look_ahead_ind = path_interpol.index_ahead(proj_ind_, look_ahead_dist_);
+        curv_sum_ = path_interpol.curvature_abs_sum(proj_ind_ + 1, look_ahead_ind);
     }
 
     //compute the distance from the orthogonal projection to the goal, w.r.t. path
@@ -337,29 +331,24 @@ double RobotController::exponentialSpeedControl()
     double min_dist = std::numeric_limits<double>::infinity();
     if(collision_avoider_->hasObstacles()) {
         auto obstacle_cloud = collision_avoider_->getObstacles();
-        const pcl::PointCloud<pcl::PointXYZ>& cloud = *obstacle_cloud->cloud;
-        if(cloud.header.frame_id == "base_link" || cloud.header.frame_id == "/base_link") {
-            for(const pcl::PointXYZ& pt : cloud) {
-
-                if(std::sqrt(pt.x*pt.x + pt.y*pt.y + pt.z*pt.z) < min_dist){
-
-                    obst_angle = std::atan2(pt.y, pt.x);
-                }
-                min_dist = std::min<double>(min_dist, std::sqrt(pt.x*pt.x + pt.y*pt.y + pt.z*pt.z));
+        obstacle_index_.update(obstacle_cloud);
+
+        const std::string& frame = obstacle_cloud->cloud->header.frame_id;
+        Eigen::Vector3d nearest;
+        if(frame == "base_link" || frame == "/base_link") {
+            if(obstacle_index_.nearest(Eigen::Vector3d::Zero(), nearest)) {
+                min_dist = nearest.norm();
+                obst_angle = std::atan2(nearest.y(), nearest.x());
             }
 
         } else {
-            tf::Transform trafo = pose_tracker_->getTransform(pose_tracker_->getRobotFrameId(), cloud.header.frame_id, ros::Time(0), ros::Duration(0));
-            for(const pcl::PointXYZ& pt : cloud) {
-
-                tf::Point pt_cloud(pt.x, pt.y, pt.z);
-                tf::Point pt_robot = trafo * pt_cloud;
-
-                if(pt_robot.length() < min_dist){
-                    obst_angle = std::atan2(pt_robot.getY(), pt_robot.getX());
-                }
-
-                min_dist = std::min<double>(min_dist, pt_robot.length());
+            tf::Transform trafo = pose_tracker_->getTransform(pose_tracker_->getRobotFrameId(), frame, ros::Time(0), ros::Duration(0));
+            // the distance does not depend on the frame, so the robot is located in the frame of the cloud
+            tf::Point robot = trafo.inverse().getOrigin();
+            if(obstacle_index_.nearest(Eigen::Vector3d(robot.x(), robot.y(), robot.z()), nearest)) {
+                tf::Point pt_robot = trafo * tf::Point(nearest.x(), nearest.y(), nearest.z());
+                min_dist = pt_robot.length();
+                obst_angle = std::atan2(pt_robot.getY(), pt_robot.getX());
             }
         }
     }
@@ -410,10 +399,16 @@ RobotController::ControlStatus RobotController::execute()
        return ControlStatus::ERROR;
     }
 
+    const ControllerParameters& params = getParameters();
+    PoseTracker::Prediction prediction(*pose_tracker_, params.pose_prediction(),
+                                       ros::Time::now() + ros::Duration(params.actuation_delay()));
+
     publishPathMarker();
 
     MoveCommand cmd;
+    nav_tracing::Span move_span("controller/compute_move_command");
     MoveCommandStatus status = computeMoveCommand(&cmd);
+    move_span.end();
 
 
     if (status != MoveCommandStatus::OKAY) {
@@ -421,7 +416,9 @@ RobotController::ControlStatus RobotController::execute()
         return MCS2CS(status);
     } else {
         CollisionAvoider::State state(path_, *PathFollowerParameters::getInstance());
+        nav_tracing::Span avoid_span("controller/collision_avoidance");
         bool cmd_modified = collision_avoider_->avoid(&cmd, state);
+        avoid_span.end();
 
         if (!cmd.isValid()) {
             ROS_ERROR("Invalid move command.");
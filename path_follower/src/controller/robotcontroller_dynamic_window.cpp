@@ -13,7 +13,7 @@
 
 // SYSTEM
 #include <boost/algorithm/clamp.hpp>
-#include <boost/tuple/tuple.hpp>
+#include <thread>
 
 #include <path_follower/factory/controller_factory.h>
 
@@ -22,26 +22,22 @@ REGISTER_ROBOT_CONTROLLER(RobotController_Dynamic_Window, dynamic_window, defaul
 using namespace Eigen;
 using namespace std;
 
+namespace {
+//! Clearance of trajectories without obstacles nearby
+const double NO_OBSTACLE_DIST = 10.0;
+//! Smaller windows are evaluated on the controller thread
+const std::size_t MIN_PARALLEL_CANDIDATES = 32;
+}
+
 RobotController_Dynamic_Window::RobotController_Dynamic_Window():
     vn_(0.0),
     v_cmd_(0.0),
     w_cmd_(0.0),
-    curv_dist_obst_(1e5),
     mGoalPosX(0.0),
     mGoalPosY(0.0),
     x_meas_(0.0),
     y_meas_(0.0),
     theta_meas_(0.0),
-    theta_pred_(0.0),
-    v_iter_(0.0),
-    w_iter_(0.0),
-    x_pred_(0.0),
-    y_pred_(0.0),
-    x_next_(0.0),
-    y_next_(0.0),
-    theta_next_(0.0),
-    obstacle_found(false),
-    m_id_counter(0),
     cmd_(this)
 {
     t_old_ = ros::Time::now();
@@ -128,236 +124,176 @@ void RobotController_Dynamic_Window::setGoalPosition()
 
 
 
-void RobotController_Dynamic_Window::searchMinObstDist(){
-
-    visualization_msgs::Marker obst_dist_marker;
-    obst_dist_marker.header.frame_id = pose_tracker_->getFixedFrameId();
-    obst_dist_marker.header.stamp = ros::Time();
-    obst_dist_marker.ns = "obstacle_distance";
-    obst_dist_marker.id = 1445;
-    obst_dist_marker.type = visualization_msgs::Marker::ARROW;
-    obst_dist_marker.action = visualization_msgs::Marker::ADD;
+void RobotController_Dynamic_Window::updateObstacleDistances(double reach)
+{
+    obstacle_points_.clear();
 
     auto obstacle_cloud = collision_avoider_->getObstacles();
-    const pcl::PointCloud<pcl::PointXYZ>& cloud = *obstacle_cloud->cloud;
-    double min_dist = std::numeric_limits<double>::infinity();
-    tf::Point coll_pt(0.0, 0.0, 0.0);
-    if(cloud.header.frame_id == pose_tracker_->getFixedFrameId()) {
-        for(const pcl::PointXYZ& pt : cloud) {
-            if(std::hypot(pt.x - x_pred_, pt.y - y_pred_) < min_dist){
-                min_dist = std::hypot(pt.x - x_pred_, pt.y - y_pred_);
-                coll_pt.setX(pt.x);
-                coll_pt.setY(pt.y);
+    if(obstacle_cloud && obstacle_cloud->cloud) {
+        const pcl::PointCloud<pcl::PointXYZ>& cloud = *obstacle_cloud->cloud;
+        obstacle_points_.reserve(cloud.size());
+
+        // the points are transformed once per dynamic window instead of once per predicted position
+        if(cloud.header.frame_id == pose_tracker_->getFixedFrameId()) {
+            for(const pcl::PointXYZ& pt : cloud) {
+                if(std::isfinite(pt.x) && std::isfinite(pt.y)) {
+                    obstacle_points_.emplace_back(pt.x, pt.y);
+                }
             }
-        }
-
-    } else {
-        tf::Transform trafo = pose_tracker_->getTransform(pose_tracker_->getFixedFrameId(), cloud.header.frame_id, ros::Time(0), ros::Duration(0));
-        for(const pcl::PointXYZ& pt : cloud) {
-            tf::Point pt_cloud(pt.x, pt.y, pt.z);
-            tf::Point pt_ff = trafo * pt_cloud;
-            if(std::hypot(pt_ff.getX() - x_pred_, pt_ff.getY() - y_pred_)){
-                min_dist = std::hypot(pt_ff.getX() - x_pred_, pt_ff.getY() - y_pred_);
-                coll_pt.setX(pt_ff.getX());
-                coll_pt.setY(pt_ff.getY());
+        } else {
+            tf::Transform trafo = pose_tracker_->getTransform(pose_tracker_->getFixedFrameId(), cloud.header.frame_id, ros::Time(0), ros::Duration(0));
+            for(const pcl::PointXYZ& pt : cloud) {
+                tf::Point pt_ff = trafo * tf::Point(pt.x, pt.y, pt.z);
+                if(std::isfinite(pt_ff.getX()) && std::isfinite(pt_ff.getY())) {
+                    obstacle_points_.emplace_back(pt_ff.getX(), pt_ff.getY());
+                }
             }
         }
     }
 
+    obstacle_grid_.build(obstacle_points_, cv::Point2f(x_meas_, y_meas_), reach,
+                         opt_.obst_dist_thresh(), opt_.grid_resolution());
+}
 
-    if(min_dist > opt_.obst_dist_thresh()){
-        curv_dist_obst_ = 10.0;
-        obst_dist_marker.points.clear();
-    }
-    else{
 
-        geometry_msgs::Point p1, p2;
+bool RobotController_Dynamic_Window::checkAdmissibleVelocities(Candidate& c) const
+{
+    const double step = opt_.step_T();
+    double theta_new = theta_meas_;
+    double t_count = 0.0;
+    double x_pred = x_meas_;
+    double y_pred = y_meas_;
+    double x_next = x_meas_;
+    double y_next = y_meas_;
+    double theta_next = theta_meas_;
+
+    c.curv_dist_obst = NO_OBSTACLE_DIST;
+    c.obstacle_found = false;
+    c.has_next_pos = false;
+    c.positions.clear();
+
+    while(t_count < opt_.fact_T()*opt_.T_dwa()){
+        if(std::abs(c.w) < 1e-1){
+            t_count += step;
+            theta_new += c.w*step;
+            x_pred += c.v * std::cos(theta_new) * step;
+            y_pred += c.v * std::sin(theta_new) * step;
+        }
+        else{
+            x_pred += c.v/c.w * (std::sin(theta_new + c.w*step) - std::sin(theta_new));
+            y_pred += c.v/c.w * (std::cos(theta_new) - std::cos(theta_new + c.w*step));
+            t_count += step;
+            theta_new += c.w*step;
+        }
+        c.positions.emplace_back(x_pred, y_pred);
 
-        p1.x = x_pred_;
-        p1.y = y_pred_;
-        p2.x = coll_pt.getX();
-        p2.y = coll_pt.getY();
+        if(obstacle_grid_.distance(x_pred, y_pred) <= opt_.obst_dist_thresh()){
+            if(std::abs(c.w) < 1e-1){
+                c.curv_dist_obst = std::hypot(y_next - y_pred, x_next - x_pred);
+            }
+            else{
+                //current curvature radius
+                double r = c.v/c.w;
+                //current center of the circle
+                double Cx = x_next - r * std::sin(theta_next);
+                double Cy = y_next + r * std::cos(theta_next);
+
+                //vector from the center of the circle to the predicted robot position
+                Vector2d vec_rob(x_next - Cx, y_next - Cy);
+                //vector from the center of the circle to the far predicted collision point
+                Vector2d vec_coll(x_pred - Cx, y_pred - Cy);
+                //angle difference between the two vectors
+                double angle_diff = MathHelper::Angle(vec_rob, vec_coll);
+
+                //compute the distance on the arc to the nearest obstacle
+                c.curv_dist_obst = std::abs(r * angle_diff);
+            }
+            c.obstacle_found = true;
+            break;
+        }
 
-        obst_dist_marker.pose.position.x = coll_pt.getX();
-        obst_dist_marker.pose.position.y = coll_pt.getY();
-        obst_dist_marker.pose.position.z = 0.0;
+        x_next = x_pred;
+        y_next = y_pred;
+        theta_next = theta_new;
 
-        tf::Quaternion quaternion = tf::createQuaternionFromYaw(std::atan2(y_pred_-coll_pt.getY(), x_pred_-coll_pt.getX()));
-        obst_dist_marker.pose.orientation.x = quaternion.getX();
-        obst_dist_marker.pose.orientation.y = quaternion.getY();
-        obst_dist_marker.pose.orientation.z = quaternion.getZ();
-        obst_dist_marker.pose.orientation.w = quaternion.getW();
-        obst_dist_marker.scale.x = std::hypot(y_pred_-coll_pt.getY(), x_pred_-coll_pt.getX());
-        obst_dist_marker.scale.y = 0.1f;
-        obst_dist_marker.scale.z = 0.1f;
-        obst_dist_marker.color.a = 1.0f;
-        obst_dist_marker.color.r = 0.0f;
-        obst_dist_marker.color.g = 1.0f;
-        obst_dist_marker.color.b = 0.0f;
-
-        if(std::abs(w_iter_) < 1e-1){
-            curv_dist_obst_ = std::hypot(y_next_ - y_pred_, x_next_ - x_pred_);
-        }
-        else{
-            //current curvature radius
-            double r = v_iter_/w_iter_;
-            //current center of the circle
-            double Cx = x_next_ - r * std::sin(theta_next_);
-            double Cy = y_next_ + r * std::cos(theta_next_);
-
-            //vector from the center of the circle to the predicted robot position
-            Vector2d vec_rob(x_next_ - Cx, y_next_ - Cy);
-            //vector from the center of the circle to the far predicted collision point
-            Vector2d vec_coll(x_pred_ - Cx, y_pred_ - Cy);
-            //angle difference between the two vectors
-            double angle_diff = MathHelper::Angle(vec_rob, vec_coll);
-
-            //compute the distance on the arc to the nearest obstacle
-            curv_dist_obst_ = std::abs(r * angle_diff);
+        if(std::abs(t_count - opt_.T_dwa()) < 1e-1){
+            double goal_angle = std::atan2(mGoalPosY - y_pred, mGoalPosX - x_pred);
+            c.theta_pred = MathHelper::AngleDelta(goal_angle, theta_new);
+            c.has_next_pos = true;
+            c.next_pos = cv::Point2d(x_pred, y_pred);
         }
+    }
 
-        obstacle_found = true;
+    // stopped before T_dwa, e.g. by an obstacle: the heading is taken from the last predicted pose, otherwise
+    // trajectories that end early would be favoured
+    if(!c.has_next_pos){
+        double goal_angle = std::atan2(mGoalPosY - y_pred, mGoalPosX - x_pred);
+        c.theta_pred = MathHelper::AngleDelta(goal_angle, theta_new);
     }
-    obst_marker_pub.publish(obst_dist_marker);
 
+    return (c.v <= std::sqrt(2.0 * c.curv_dist_obst * opt_.lin_dec())) && (std::abs(c.w) <= std::sqrt(2.0 * c.curv_dist_obst * opt_.ang_dec()));
 }
 
 
-bool RobotController_Dynamic_Window::checkAdmissibleVelocities(){
-    double x_new = 0.0;
-    double y_new = 0.0;
-    double theta_new = theta_meas_;
-    double t = opt_.step_T();
-    double t_count = 0.0;
-    x_pred_ = x_meas_;
-    y_pred_ = y_meas_;
-    x_next_ = x_meas_;
-    y_next_ = y_meas_;
-    theta_next_ = theta_meas_;
-
-
-    m_id_counter++;
-    visualization_msgs::Marker far_pred_point;
-    far_pred_point.points.clear();
-    far_pred_point.header.frame_id = pose_tracker_->getFixedFrameId();
-    far_pred_point.header.stamp = ros::Time::now();
-    far_pred_point.ns = "far_predictions";
-    far_pred_point.id = 1446 + m_id_counter;
-    far_pred_point.type = visualization_msgs::Marker::LINE_STRIP;
-    far_pred_point.action = visualization_msgs::Marker::ADD;
-    far_pred_point.pose.orientation.w = 1.0;
-    far_pred_point.scale.x = 0.05;
-    far_pred_point.scale.y = 0.05;
-    far_pred_point.scale.z = 0.1f;
-    far_pred_point.color.a = 1.0f;
-    far_pred_point.color.r = 0.0f;
-    far_pred_point.color.g = 1.0f;
-    far_pred_point.color.b = 0.0f;
+void RobotController_Dynamic_Window::visualizeCandidate(const Candidate& c)
+{
+    const std::string& frame = pose_tracker_->getFixedFrameId();
+
+    if(c.has_next_pos){
+        geometry_msgs::PointStamped next_pos;
+        next_pos.point.x = c.next_pos.x;
+        next_pos.point.y = c.next_pos.y;
+        next_pos.header.frame_id = frame;
+        predict_pub.publish(next_pos);
+    }
 
     geometry_msgs::PointStamped obst_point;
-    obst_point.header.frame_id = pose_tracker_->getFixedFrameId();
-
-    if(std::abs(w_iter_) < 1e-1){
-        while(t_count < opt_.fact_T()*opt_.T_dwa()){
-            t_count += opt_.step_T();
-            theta_new += w_iter_*opt_.step_T();
-            x_new = v_iter_ * std::cos(theta_new) * t;
-            y_new = v_iter_ * std::sin(theta_new) * t;
-            x_pred_ += x_new;
-            y_pred_ += y_new;
-            obstacle_found = false;
-            searchMinObstDist();
-            x_next_ = x_pred_;
-            y_next_ = y_pred_;
-            theta_next_ = theta_new;
-
-            geometry_msgs::Point p;
-            p.x = x_pred_;
-            p.y = y_pred_;
-            far_pred_point.points.push_back(p);
-
-            traj_.header.frame_id = pose_tracker_->getFixedFrameId();
-            geometry_msgs::PoseStamped pos_st;
-            pos_st.pose.position.x = x_pred_;
-            pos_st.pose.position.y = y_pred_;
-            traj_.poses.push_back(pos_st);
-            traj_pub.publish(traj_);
-
+    obst_point.header.frame_id = frame;
 
-            if(obstacle_found){
-                obst_point.point.x = x_pred_;
-                obst_point.point.y = y_pred_;
-                break;
-            }
-            if(std::abs(t_count - opt_.T_dwa()) < 1e-1){
-
-                double goal_angle = std::atan2(mGoalPosY - y_pred_, mGoalPosX - x_pred_);
-                theta_pred_ = MathHelper::AngleDelta(goal_angle, theta_new);
+    visualization_msgs::Marker obst_dist_marker;
+    obst_dist_marker.header.frame_id = frame;
+    obst_dist_marker.header.stamp = ros::Time();
+    obst_dist_marker.ns = "obstacle_distance";
+    obst_dist_marker.id = 1445;
+    obst_dist_marker.type = visualization_msgs::Marker::ARROW;
+    obst_dist_marker.action = visualization_msgs::Marker::ADD;
 
-                geometry_msgs::PointStamped next_pos;
-                next_pos.point.x = x_pred_;
-                next_pos.point.y = y_pred_;
-                next_pos.header.frame_id = pose_tracker_->getFixedFrameId();
-                predict_pub.publish(next_pos);
+    if(c.obstacle_found && !obstacle_points_.empty()){
+        const cv::Point2d& pred = c.positions.back();
+        obst_point.point.x = pred.x;
+        obst_point.point.y = pred.y;
+
+        // the grid only knows the distance, the nearest point is searched for this candidate only
+        cv::Point2d coll_pt = obstacle_points_.front();
+        double min_dist = std::numeric_limits<double>::infinity();
+        for(const cv::Point2f& pt : obstacle_points_) {
+            double dist = std::hypot(pt.x - pred.x, pt.y - pred.y);
+            if(dist < min_dist){
+                min_dist = dist;
+                coll_pt = pt;
             }
         }
-    }
-    else{
-        while(t_count < opt_.fact_T()*opt_.T_dwa()){
-            x_new = v_iter_/w_iter_ * (std::sin(theta_new + w_iter_*opt_.step_T()) - std::sin(theta_new));
-            y_new = v_iter_/w_iter_ * (std::cos(theta_new) - std::cos(theta_new + w_iter_*opt_.step_T()));
-            x_pred_ += x_new;
-            y_pred_ += y_new;
-            t_count += opt_.step_T();
-            theta_new += w_iter_*opt_.step_T();
-            obstacle_found = false;
-            searchMinObstDist();
-            x_next_ = x_pred_;
-            y_next_ = y_pred_;
-            theta_next_ = theta_new;
-
-            geometry_msgs::Point p;
-            p.x = x_pred_;
-            p.y = y_pred_;
-            far_pred_point.points.push_back(p);
-
-            traj_.header.frame_id = pose_tracker_->getFixedFrameId();
-            geometry_msgs::PoseStamped pos_st;
-            pos_st.pose.position.x = x_pred_;
-            pos_st.pose.position.y = y_pred_;
-            traj_.poses.push_back(pos_st);
-            traj_pub.publish(traj_);
-
-            if(obstacle_found){
-                obst_point.point.x = x_pred_;
-                obst_point.point.y = y_pred_;
-                break;
-            }
-            if(std::abs(t_count - opt_.T_dwa()) < 1e-1){
 
-                double goal_angle = std::atan2(mGoalPosY - y_pred_, mGoalPosX - x_pred_);
-                theta_pred_ = MathHelper::AngleDelta(goal_angle, theta_new);
+        obst_dist_marker.pose.position.x = coll_pt.x;
+        obst_dist_marker.pose.position.y = coll_pt.y;
+        obst_dist_marker.pose.position.z = 0.0;
 
-                geometry_msgs::PointStamped next_pos;
-                next_pos.point.x = x_pred_;
-                next_pos.point.y = y_pred_;
-                next_pos.header.frame_id = pose_tracker_->getFixedFrameId();
-                predict_pub.publish(next_pos);
-            }
-        }
+        tf::Quaternion quaternion = tf::createQuaternionFromYaw(std::atan2(pred.y - coll_pt.y, pred.x - coll_pt.x));
+        obst_dist_marker.pose.orientation.x = quaternion.getX();
+        obst_dist_marker.pose.orientation.y = quaternion.getY();
+        obst_dist_marker.pose.orientation.z = quaternion.getZ();
+        obst_dist_marker.pose.orientation.w = quaternion.getW();
+        obst_dist_marker.scale.x = min_dist;
+        obst_dist_marker.scale.y = 0.1f;
+        obst_dist_marker.scale.z = 0.1f;
+        obst_dist_marker.color.a = 1.0f;
+        obst_dist_marker.color.r = 0.0f;
+        obst_dist_marker.color.g = 1.0f;
+        obst_dist_marker.color.b = 0.0f;
     }
 
+    obst_marker_pub.publish(obst_dist_marker);
     obst_point_pub.publish(obst_point);
-
-    if((v_iter_ <= std::sqrt(2.0 * curv_dist_obst_ * opt_.lin_dec())) && (std::abs(w_iter_) <= std::sqrt(2.0 * curv_dist_obst_ * opt_.ang_dec()))){
-        far_pred_points.markers.push_back(far_pred_point);
-        far_pred_pub.publish(far_pred_points);
-
-        return true;
-    }
-    else{
-        return false;
-    }
 }
 
 void RobotController_Dynamic_Window::findNextVelocityPair()
@@ -368,49 +304,126 @@ void RobotController_Dynamic_Window::findNextVelocityPair()
     double w_wind_l = std::max(-opt_.max_ang_vel(), w_cmd_ - opt_.ang_acc()*opt_.T_dwa());
     double w_wind_r = std::min(opt_.max_ang_vel(), w_cmd_ + opt_.ang_acc()*opt_.T_dwa());
 
-    v_iter_ = v_wind_b - opt_.v_step();
-    w_iter_ = w_wind_l - opt_.w_step();
+    // the buffers of the candidates are reused
+    std::size_t n = 0;
+    double max_v = 0.0;
+    double v_iter = v_wind_b - opt_.v_step();
+    while(v_iter < v_wind_t){
+        v_iter += opt_.v_step();
+        double w_iter = w_wind_l - opt_.w_step();
+        while(w_iter < w_wind_r){
+            w_iter += opt_.w_step();
+            if(n == candidates_.size()){
+                candidates_.emplace_back();
+            }
+            candidates_[n].v = v_iter;
+            candidates_[n].w = w_iter;
+            ++n;
+            max_v = std::max(max_v, std::abs(v_iter));
+        }
+    }
+    candidates_.resize(n);
 
-    vector< tuple<double,double,double> > vels_and_objfunc;
+    // no prediction can leave the distance grid
+    int steps = 0;
+    for(double t_count = 0.0; t_count < opt_.fact_T()*opt_.T_dwa(); t_count += opt_.step_T()){
+        ++steps;
+    }
+    updateObstacleDistances(max_v * opt_.step_T() * steps);
+
+    // the workers are only restarted if the number of threads changes
+    std::size_t threads = opt_.threads() > 0 ? opt_.threads() : std::max(1u, std::thread::hardware_concurrency());
+    if(workers_.size() != threads) {
+        workers_.resize(threads);
+    }
+
+    auto check = [this](std::size_t i) {
+        candidates_[i].admissible = checkAdmissibleVelocities(candidates_[i]);
+    };
+    if(candidates_.size() < MIN_PARALLEL_CANDIDATES) {
+        for(std::size_t i = 0; i < candidates_.size(); ++i) {
+            check(i);
+        }
+    } else {
+        workers_.parallelFor(candidates_.size(), check);
+    }
+
+    const std::string& frame = pose_tracker_->getFixedFrameId();
+    const ros::Time now = ros::Time::now();
 
     far_pred_points.markers.clear();
     visualization_msgs::Marker clearing_marker;
-    clearing_marker.header.frame_id = pose_tracker_->getFixedFrameId();
-    clearing_marker.header.stamp = ros::Time::now();
+    clearing_marker.header.frame_id = frame;
+    clearing_marker.header.stamp = now;
     clearing_marker.ns = "far_predictions";
     clearing_marker.id = 0;
     clearing_marker.action = 3u; // 3 == visualization_msgs::Marker::DELETEALL, backwards compatibility for indigo
     far_pred_points.markers.push_back(clearing_marker);
-    m_id_counter = 0;
     traj_.poses.clear();
+    traj_.header.frame_id = frame;
 
-    while(v_iter_ < v_wind_t){
-        v_iter_ += opt_.v_step();
-        while(w_iter_ < w_wind_r){
-            w_iter_ += opt_.w_step();
-            if(checkAdmissibleVelocities()){
-                double heading = 1.0 - std::abs(theta_pred_)/M_PI;
-                double obj_func = opt_.angle_fact()*heading + opt_.disobst_fact()*curv_dist_obst_ + opt_.v_fact()*v_iter_;
-                vels_and_objfunc.push_back(tuple<double,double,double>(obj_func,v_iter_,w_iter_));
-            }
+    // select sequentially in the order of the window, so the result does not depend on the threads
+    double max_obj = std::numeric_limits<double>::min();
+    const Candidate* best = nullptr;
+    std::size_t admissible = 0;
+    for(std::size_t i = 0; i < candidates_.size(); ++i){
+        const Candidate& c = candidates_[i];
+
+        for(const cv::Point2d& p : c.positions){
+            geometry_msgs::PoseStamped pos_st;
+            pos_st.pose.position.x = p.x;
+            pos_st.pose.position.y = p.y;
+            traj_.poses.push_back(pos_st);
+        }
+
+        if(!c.admissible){
+            continue;
+        }
+        ++admissible;
+
+        visualization_msgs::Marker far_pred_point;
+        far_pred_point.header.frame_id = frame;
+        far_pred_point.header.stamp = now;
+        far_pred_point.ns = "far_predictions";
+        far_pred_point.id = 1447 + i;
+        far_pred_point.type = visualization_msgs::Marker::LINE_STRIP;
+        far_pred_point.action = visualization_msgs::Marker::ADD;
+        far_pred_point.pose.orientation.w = 1.0;
+        far_pred_point.scale.x = 0.05;
+        far_pred_point.scale.y = 0.05;
+        far_pred_point.scale.z = 0.1f;
+        far_pred_point.color.a = 1.0f;
+        far_pred_point.color.r = 0.0f;
+        far_pred_point.color.g = 1.0f;
+        far_pred_point.color.b = 0.0f;
+        for(const cv::Point2d& p : c.positions){
+            geometry_msgs::Point pt;
+            pt.x = p.x;
+            pt.y = p.y;
+            far_pred_point.points.push_back(pt);
+        }
+        far_pred_points.markers.push_back(far_pred_point);
+
+        double heading = 1.0 - std::abs(c.theta_pred)/M_PI;
+        double obj_func = opt_.angle_fact()*heading + opt_.disobst_fact()*c.curv_dist_obst + opt_.v_fact()*c.v;
+        if(obj_func > max_obj){
+            max_obj = obj_func;
+            best = &c;
         }
-        w_iter_ = w_wind_l - opt_.w_step();
     }
 
-    double max_obj = std::numeric_limits<double>::min();
+    traj_pub.publish(traj_);
+    far_pred_pub.publish(far_pred_points);
 
-    if(vels_and_objfunc.size() < 1){
+    if(admissible == 0){
         ROS_ERROR("There are no admissible velocities!!!");
     }
 
-    for(uint i = 0; i < vels_and_objfunc.size(); i++){
-        if(get<0>(vels_and_objfunc[i]) > max_obj){
-            max_obj = get<0>(vels_and_objfunc[i]);
-            v_cmd_ = boost::algorithm::clamp(get<1>(vels_and_objfunc[i]), 0.0, PathFollowerParameters::getInstance()->max_velocity());
-            w_cmd_ = boost::algorithm::clamp(get<2>(vels_and_objfunc[i]), -opt_.max_ang_vel(), opt_.max_ang_vel());
-        }
+    if(best){
+        v_cmd_ = boost::algorithm::clamp(best->v, 0.0, PathFollowerParameters::getInstance()->max_velocity());
+        w_cmd_ = boost::algorithm::clamp(best->w, -opt_.max_ang_vel(), opt_.max_ang_vel());
+        visualizeCandidate(*best);
     }
-
 }
 
 
@@ -445,9 +458,6 @@ RobotController::MoveCommandStatus RobotController_Dynamic_Window::computeMoveCo
         y_meas_ = current_pose[1];
         theta_meas_ = current_pose[2];
 
-        x_pred_ = x_meas_;
-        y_pred_ = y_meas_;
-
         findNextVelocityPair();
         t_old_ = ros::Time::now();
     }
@@ -78,15 +78,10 @@ bool RobotController_EKM_TT::targetTransform2base(ros::Time& now,Waypoint pathEn
     std::string world_frame = path_->getFrameId();
     std::string robot_frame = PathFollowerParameters::getInstance()->robot_frame();
 
-    try{//Try to get the latest avaiable Transform
-        transformer_->lookupTransform(world_frame, robot_frame, ros::Time(0), now_map_to_base);
-    }catch(tf::TransformException ex){//if not available, then wait
-        (void) ex;
-        if(!transformer_->waitForTransform(world_frame, robot_frame, now, ros::Duration(0.1))){
-            ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
-            return false;
-        }
-        transformer_->lookupTransform(world_frame, robot_frame, now, now_map_to_base);
+    // the latest transform, if there is none, wait for the current one
+    if(!pose_tracker_->lookupLatestTransform(world_frame, robot_frame, now, ros::Duration(0.1), now_map_to_base)){
+        ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
+        return false;
     }
 
     tf::Transform transform_correction = now_map_to_base.inverse();
@@ -153,6 +153,16 @@ void RobotController_ModelBased::start()
         writer_.WriteConfig(config,m_opt_.robot_config_file());
     }
 #endif
+
+    if (opt_.recording_file().length() > 2)
+    {
+        // one recording for all paths of this run, the config is written for every path as it may have changed
+        if (!recorder_.IsOpen() && !recorder_.Open(opt_.recording_file()))
+        {
+            ROS_ERROR_STREAM("Cannot open planner recording " << opt_.recording_file());
+        }
+        recorder_.WriteConfig(config);
+    }
 }
 
 void RobotController_ModelBased::reset()
@@ -266,6 +276,7 @@ RobotController::MoveCommandStatus RobotController_ModelBased::computeMoveComman
 
     model_based_planner_->SetGoalMap(goal);
     model_based_planner_->SetPathMap(currentPath_);
+    recorder_.WritePath(goal, currentPath_);
 
     doPlan_ = true;
 
@@ -287,15 +298,9 @@ void RobotController_ModelBased::publishMoveCommand(const MoveCommand &cmd) cons
 
 bool RobotController_ModelBased::GetTransform(ros::Time time,std::string targetFrame, std::string sourceFrame, tf::StampedTransform &trans)
 {
-    try{//Try to get the latest avaiable Transform
-        transformer_->lookupTransform(targetFrame, sourceFrame, time, trans);
-    }catch(tf::TransformException ex){//if not available, then wait
-        (void) ex;
-        if(!transformer_->waitForTransform(targetFrame, sourceFrame, time, ros::Duration(0.05))){
-            ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
-            return false;
-        }
-        transformer_->lookupTransform(targetFrame, sourceFrame, time, trans);
+    if(!pose_tracker_->lookupTransform(targetFrame, sourceFrame, time, ros::Duration(0.05), trans)){
+        ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
+        return false;
     }
 
     return true;
@@ -333,15 +338,10 @@ bool RobotController_ModelBased::targetTransform2base(ros::Time& now)
     std::string world_frame = PathFollowerParameters::getInstance()->world_frame();
     std::string robot_frame = localMapFrame_;
 
-    try{//Try to get the latest avaiable Transform
-        transformer_->lookupTransform(world_frame, robot_frame, ros::Time(0), now_map_to_base);
-    }catch(tf::TransformException ex){//if not available, then wait
-        (void) ex;
-        if(!transformer_->waitForTransform(world_frame, robot_frame, now, ros::Duration(0.1))){
-            ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
-            return false;
-        }
-        transformer_->lookupTransform(world_frame, robot_frame, now, now_map_to_base);
+    // the latest transform, if there is none, wait for the current one
+    if(!pose_tracker_->lookupLatestTransform(world_frame, robot_frame, now, ros::Duration(0.1), now_map_to_base)){
+        ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
+        return false;
     }
 
     tf::Transform transform_correction = now_map_to_base.inverse();
@@ -500,7 +500,7 @@ void RobotController_ModelBased::imageCallback (const sensor_msgs::ImageConstPtr
     Stopwatch sw;
     sw.restart();
 
-    model_based_planner_->Plan();
+    cv::Point2f plannedCmd = model_based_planner_->Plan();
 
     double curMS = sw.usElapsed()/1000.0;
     totalPlanningTime_ += curMS;
@@ -510,6 +510,19 @@ void RobotController_ModelBased::imageCallback (const sensor_msgs::ImageConstPtr
     //ROS_INFO_STREAM_THROTTLE(1,"Model based planner took " << totalPlanningTime_/(double)frameCounter_ << "ms");
     ROS_INFO_STREAM_THROTTLE(1,"Model based planner took " << curMS << " Avg: " << totalPlanningTime_/(double)frameCounter_ << "ms" << " Frames: " << frameCounter_);
 
+    if (recorder_.IsOpen())
+    {
+        PlanningCycle cycle;
+        cycle.stamp = dTime;
+        cycle.pose = pose;
+        cycle.velocity = nvel;
+        cycle.demPos = model_based_planner_->GetDEMPos();
+        cycle.command = plannedCmd;
+        cycle.planningMS = (float)curMS;
+        cycle.poseCount = model_based_planner_->GetPoseCount();
+        recorder_.WriteCycle(cycle, inputImage);
+    }
+
     Trajectory *result = model_based_planner_->GetBLResultTrajectory();
 
 
@@ -6,6 +6,7 @@
 #include <path_follower/utils/elevation_map.h>
 #include <path_follower/utils/pose_tracker.h>
 #include <path_follower/factory/follower_factory.h>
+#include <nav_tracing/diagnostics_publisher.h>
 #include <pcl_ros/point_cloud.h>
 #include <sensor_msgs/Image.h>
 #include <std_msgs/Int8.h>
@@ -15,6 +16,8 @@
 namespace {
 void importCloud(const ObstacleCloud::Cloud::ConstPtr& sensor_cloud, PathFollower* pf)
 {
+    NAV_TRACE_SCOPE("path_follower/import_cloud");
+
     ros::Time now;
     now.fromNSec(sensor_cloud->header.stamp * 1e3);
 
@@ -40,6 +43,8 @@ void importCloud(const ObstacleCloud::Cloud::ConstPtr& sensor_cloud, PathFollowe
 
 void importElevationMap(const ElevationMap::EMap& sensor_image, PathFollower* pf)
 {
+    NAV_TRACE_SCOPE("path_follower/import_elevation_map");
+
     auto elevation_map = std::make_shared<ElevationMap>(sensor_image);
     pf->setElevationMap(elevation_map);
 }
@@ -150,6 +155,9 @@ int main(int argc, char** argv) {
                 nh.subscribe<std_msgs::Int8>("external_error", 1,
                                             boost::bind(&importExternalErrorStop, _1, &pf));
 
+    ros::NodeHandle nh_private("~");
+    nav_tracing::DiagnosticsPublisher tracing(nh_private);
+
     server.spin();
 
     return 0;
@@ -3,6 +3,7 @@
 #include <path_follower/controller/robotcontroller.h>
 #include <path_follower/utils/obstacle_cloud.h>
 #include <path_follower/utils/pose_tracker.h>
+#include <path_follower/utils/path_smoother.h>
 
 #include <path_follower/parameters/path_follower_parameters.h>
 #include <path_follower/parameters/local_planner_parameters.h>
@@ -216,40 +217,22 @@ SubPath AbstractLocalPlanner::smoothPathSegment(const SubPath& path, double weig
     }
     SubPath new_path(path);
 
-    double last_change = -2 * tolerance;
-    double change = 0;
+    std::vector<double> x(n), y(n);
+    for(unsigned i = 0; i < n; ++i) {
+        x[i] = path[i].x;
+        y[i] = path[i].y;
+    }
 
     int offset = 2;
+    if(!PathSmoother::smooth(x, y, weight_data, weight_smooth, offset)) {
+        ROS_WARN_STREAM_THROTTLE(1, "not smoothing the path, weight_smooth has to be in [0, 0.5) and weight_data positive"
+                                 " (weight_data: " << weight_data << ", weight_smooth: " << weight_smooth << ")");
+        return path;
+    }
 
-    while(change > last_change + tolerance) {
-        last_change = change;
-        change = 0;
-        Waypoint origin(0,0,0);
-
-        for(unsigned i = offset; i < n-offset; ++i){
-            Waypoint path_i = path[i];
-            Waypoint new_path_i = new_path[i];
-            Waypoint new_path_ip1 = new_path[i+1];
-            Waypoint new_path_im1 = new_path[i-1];
-
-            Waypoint deltaData(weight_data*(path_i.x - new_path_i.x),
-                               weight_data*(path_i.y - new_path_i.y),0.0);
-
-            new_path_i.x = new_path_i.x + deltaData.x;
-            new_path_i.y = new_path_i.y + deltaData.y;
-
-            Waypoint deltaSmooth(weight_smooth * (new_path_ip1.x + new_path_im1.x - 2* new_path_i.x),
-                                 weight_smooth * (new_path_ip1.y + new_path_im1.y - 2* new_path_i.y),
-                                 0.0);
-            new_path_i.x = new_path_i.x + deltaSmooth.x;
-            new_path_i.y = new_path_i.y + deltaSmooth.y;
-
-            new_path[i].x = new_path_i.x;
-            new_path[i].y = new_path_i.y;
-
-
-            change += deltaData.distanceTo(origin) + deltaSmooth.distanceTo(origin);
-        }
+    for(int i = offset; i < (int) n-offset; ++i){
+        new_path[i].x = x[i];
+        new_path[i].y = y[i];
     }
 
     // update orientations
@@ -268,11 +251,7 @@ SubPath AbstractLocalPlanner::smoothPathSegment(const SubPath& path, double weig
     bool is_backward = (theta_diff > M_PI_2 || theta_diff < -M_PI_2) ;
 
     for(unsigned i = 1; i < n-1; ++i){
-        Waypoint next = new_path[i+1];
-        Waypoint prev = new_path[i-1];
-
-        Waypoint delta(next.x - prev.x, next.y - prev.y, 0.0);
-        double angle = std::atan2(delta.y, delta.x);
+        double angle = std::atan2(y[i+1] - y[i-1], x[i+1] - x[i-1]);
 
         if(is_backward) {
             angle = MathHelper::AngleClamp(angle + M_PI);
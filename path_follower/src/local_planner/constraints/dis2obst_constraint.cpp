@@ -18,10 +18,7 @@ void Dis2Obst_Constraint::setParams(double obstacle_threshold){
 
 bool Dis2Obst_Constraint::isSatisfied(const LNode& point){
     sw.resume();
-    if(point.d2o <= threshold){
-        sw.stop();
-        return false;
-    }
+    bool sat = check(point, threshold);
     sw.stop();
-    return true;
+    return sat;
 }
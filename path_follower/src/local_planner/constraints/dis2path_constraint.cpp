@@ -34,23 +34,8 @@ void Dis2Path_Constraint::setLimit(double dis2p){
 
 bool Dis2Path_Constraint::isSatisfied(const LNode& point){
     sw.resume();
-
-    limit = DIS2P_;
-
-    //this should be a parameter
-    double obst_min_dist = 4.0;
-    double enhancement_fact = 4.0;
-    if(point.d2o <= obst_min_dist){
-        limit *= enhancement_fact;
-    }
-    else{
-        limit = DIS2P_;
-    }
-
-    if(point.d2p <= limit){
-        sw.stop();
-        return true;
-    }
+    limit = limitAt(point);
+    bool sat = point.d2p <= limit;
     sw.stop();
-    return false;
+    return sat;
 }
@@ -0,0 +1,251 @@
+/// HEADER
+#include <path_follower/local_planner/evaluation_pipeline.h>
+
+/// PROJECT
+#include <path_follower/local_planner/scorers/dis2pathp_scorer.h>
+#include <path_follower/local_planner/scorers/dis2pathd_scorer.h>
+#include <path_follower/local_planner/scorers/curvature_scorer.h>
+#include <path_follower/local_planner/scorers/curvatured_scorer.h>
+#include <path_follower/local_planner/scorers/level_scorer.h>
+#include <path_follower/local_planner/scorers/dis2obst_scorer.h>
+#include <path_follower/local_planner/constraints/dis2path_constraint.h>
+#include <path_follower/local_planner/constraints/dis2obst_constraint.h>
+
+/// SYSTEM
+#include <array>
+#include <utility>
+
+namespace {
+
+constexpr std::size_t BLOCK = 8;
+
+template <unsigned Mask>
+constexpr bool uses(int kernel)
+{
+    return (Mask & (1u << kernel)) != 0;
+}
+
+/*
+ * The terms are summed in the order of EvaluationPipeline::ScorerKernel, which is the order of
+ * AbstractLocalPlanner::scorers, so the results are identical to the virtual interface.
+ */
+
+template <unsigned Mask>
+double scoreOne(const LNode& p, const double* w)
+{
+    double s = 0.0;
+    if(uses<Mask>(EvaluationPipeline::SCORER_DIS2PATH_P)) {
+        s += w[EvaluationPipeline::SCORER_DIS2PATH_P] * Dis2PathP_Scorer::compute(p.d2p);
+    }
+    if(uses<Mask>(EvaluationPipeline::SCORER_DIS2PATH_D)) {
+        s += w[EvaluationPipeline::SCORER_DIS2PATH_D] *
+                (p.parent_ ? Dis2PathD_Scorer::compute(p.d2p, p.parent_->d2p) : 0.0);
+    }
+    if(uses<Mask>(EvaluationPipeline::SCORER_CURVATURE)) {
+        s += w[EvaluationPipeline::SCORER_CURVATURE] * Curvature_Scorer::compute(p.radius_);
+    }
+    if(uses<Mask>(EvaluationPipeline::SCORER_CURVATURE_D)) {
+        s += w[EvaluationPipeline::SCORER_CURVATURE_D] *
+                (p.parent_ ? CurvatureD_Scorer::compute(p.radius_, p.parent_->radius_) : 0.0);
+    }
+    if(uses<Mask>(EvaluationPipeline::SCORER_LEVEL)) {
+        s += w[EvaluationPipeline::SCORER_LEVEL] * Level_Scorer::compute(p.level_);
+    }
+    if(uses<Mask>(EvaluationPipeline::SCORER_DIS2OBST)) {
+        s += w[EvaluationPipeline::SCORER_DIS2OBST] * Dis2Obst_Scorer::compute(p);
+    }
+    return s;
+}
+
+template <unsigned Mask>
+void scoreBatch(const LNode* const* nodes, std::size_t n, const double* w, double* scores)
+{
+    // structure of arrays for the cheap scorers, so that the inner loop can be vectorized
+    double d2p[BLOCK], parent_d2p[BLOCK], radius[BLOCK], parent_radius[BLOCK];
+    bool has_parent[BLOCK];
+    int level[BLOCK];
+
+    for(std::size_t b = 0; b < n; b += BLOCK) {
+        const std::size_t m = std::min(BLOCK, n - b);
+
+        for(std::size_t i = 0; i < m; ++i) {
+            const LNode& p = *nodes[b + i];
+            const LNode& parent = p.parent_ ? *p.parent_ : p;
+            d2p[i] = p.d2p;
+            parent_d2p[i] = parent.d2p;
+            radius[i] = p.radius_;
+            parent_radius[i] = parent.radius_;
+            has_parent[i] = p.parent_ != nullptr;
+            level[i] = p.level_;
+        }
+
+        double* out = scores + b;
+        for(std::size_t i = 0; i < m; ++i) {
+            double s = 0.0;
+            if(uses<Mask>(EvaluationPipeline::SCORER_DIS2PATH_P)) {
+                s += w[EvaluationPipeline::SCORER_DIS2PATH_P] * Dis2PathP_Scorer::compute(d2p[i]);
+            }
+            if(uses<Mask>(EvaluationPipeline::SCORER_DIS2PATH_D)) {
+                s += w[EvaluationPipeline::SCORER_DIS2PATH_D] *
+                        (has_parent[i] ? Dis2PathD_Scorer::compute(d2p[i], parent_d2p[i]) : 0.0);
+            }
+            if(uses<Mask>(EvaluationPipeline::SCORER_CURVATURE)) {
+                s += w[EvaluationPipeline::SCORER_CURVATURE] * Curvature_Scorer::compute(radius[i]);
+            }
+            if(uses<Mask>(EvaluationPipeline::SCORER_CURVATURE_D)) {
+                s += w[EvaluationPipeline::SCORER_CURVATURE_D] *
+                        (has_parent[i] ? CurvatureD_Scorer::compute(radius[i], parent_radius[i]) : 0.0);
+            }
+            if(uses<Mask>(EvaluationPipeline::SCORER_LEVEL)) {
+                s += w[EvaluationPipeline::SCORER_LEVEL] * Level_Scorer::compute(level[i]);
+            }
+            out[i] = s;
+        }
+
+        // the obstacle scorer is the last term and needs the full node
+        if(uses<Mask>(EvaluationPipeline::SCORER_DIS2OBST)) {
+            for(std::size_t i = 0; i < m; ++i) {
+                out[i] += w[EvaluationPipeline::SCORER_DIS2OBST] * Dis2Obst_Scorer::compute(*nodes[b + i]);
+            }
+        }
+    }
+}
+
+template <unsigned Mask>
+bool satisfiedOne(const LNode& p, double obstacle_threshold)
+{
+    if(uses<Mask>(EvaluationPipeline::CONSTRAINT_DIS2PATH) && !Dis2Path_Constraint::check(p)) {
+        return false;
+    }
+    if(uses<Mask>(EvaluationPipeline::CONSTRAINT_DIS2OBST) && !Dis2Obst_Constraint::check(p, obstacle_threshold)) {
+        return false;
+    }
+    return true;
+}
+
+template <unsigned Mask>
+void satisfiedBatch(const LNode* const* nodes, std::size_t n, double obstacle_threshold, char* satisfied)
+{
+    for(std::size_t i = 0; i < n; ++i) {
+        const LNode& p = *nodes[i];
+        bool sat = true;
+        if(uses<Mask>(EvaluationPipeline::CONSTRAINT_DIS2PATH)) {
+            sat &= Dis2Path_Constraint::check(p);
+        }
+        if(uses<Mask>(EvaluationPipeline::CONSTRAINT_DIS2OBST)) {
+            sat &= Dis2Obst_Constraint::check(p, obstacle_threshold);
+        }
+        satisfied[i] = sat;
+    }
+}
+
+template <typename Fn, template <unsigned> class Select, std::size_t... I>
+constexpr std::array<Fn, sizeof...(I)> makeTable(std::index_sequence<I...>)
+{
+    return {{ Select<I>::fn... }};
+}
+
+template <unsigned Mask> struct SelectScoreOne { static constexpr EvaluationPipeline::ScoreOneFn fn = &scoreOne<Mask>; };
+template <unsigned Mask> struct SelectScoreBatch { static constexpr EvaluationPipeline::ScoreBatchFn fn = &scoreBatch<Mask>; };
+template <unsigned Mask> struct SelectSatisfiedOne { static constexpr EvaluationPipeline::SatisfiedOneFn fn = &satisfiedOne<Mask>; };
+template <unsigned Mask> struct SelectSatisfiedBatch { static constexpr EvaluationPipeline::SatisfiedBatchFn fn = &satisfiedBatch<Mask>; };
+
+constexpr std::size_t SCORER_COMBINATIONS = 1u << EvaluationPipeline::SCORER_KERNELS;
+constexpr std::size_t CONSTRAINT_COMBINATIONS = 1u << EvaluationPipeline::CONSTRAINT_KERNELS;
+
+const std::array<EvaluationPipeline::ScoreOneFn, SCORER_COMBINATIONS> SCORE_ONE =
+        makeTable<EvaluationPipeline::ScoreOneFn, SelectScoreOne>(std::make_index_sequence<SCORER_COMBINATIONS>());
+const std::array<EvaluationPipeline::ScoreBatchFn, SCORER_COMBINATIONS> SCORE_BATCH =
+        makeTable<EvaluationPipeline::ScoreBatchFn, SelectScoreBatch>(std::make_index_sequence<SCORER_COMBINATIONS>());
+const std::array<EvaluationPipeline::SatisfiedOneFn, CONSTRAINT_COMBINATIONS> SATISFIED_ONE =
+        makeTable<EvaluationPipeline::SatisfiedOneFn, SelectSatisfiedOne>(std::make_index_sequence<CONSTRAINT_COMBINATIONS>());
+const std::array<EvaluationPipeline::SatisfiedBatchFn, CONSTRAINT_COMBINATIONS> SATISFIED_BATCH =
+        makeTable<EvaluationPipeline::SatisfiedBatchFn, SelectSatisfiedBatch>(std::make_index_sequence<CONSTRAINT_COMBINATIONS>());
+
+int scorerKernel(const Scorer::Ptr& s)
+{
+    const Scorer* p = s.get();
+    if(dynamic_cast<const Dis2PathP_Scorer*>(p)) {
+        return EvaluationPipeline::SCORER_DIS2PATH_P;
+    } else if(dynamic_cast<const Dis2PathD_Scorer*>(p)) {
+        return EvaluationPipeline::SCORER_DIS2PATH_D;
+    } else if(dynamic_cast<const Curvature_Scorer*>(p)) {
+        return EvaluationPipeline::SCORER_CURVATURE;
+    } else if(dynamic_cast<const CurvatureD_Scorer*>(p)) {
+        return EvaluationPipeline::SCORER_CURVATURE_D;
+    } else if(dynamic_cast<const Level_Scorer*>(p)) {
+        return EvaluationPipeline::SCORER_LEVEL;
+    } else if(dynamic_cast<const Dis2Obst_Scorer*>(p)) {
+        return EvaluationPipeline::SCORER_DIS2OBST;
+    }
+    return -1;
+}
+
+}
+
+EvaluationPipeline::EvaluationPipeline()
+    : scorers_valid_(false),
+      constraints_valid_(false),
+      obstacle_threshold_(0.0),
+      score_one_(SCORE_ONE[0]),
+      score_batch_(SCORE_BATCH[0]),
+      satisfied_one_(SATISFIED_ONE[0]),
+      satisfied_batch_(SATISFIED_BATCH[0])
+{
+    for(double& w : weights_) {
+        w = 0.0;
+    }
+}
+
+bool EvaluationPipeline::configureScorers(const std::vector<Scorer::Ptr> &scorers)
+{
+    unsigned mask = 0;
+    int last = -1;
+    for(const Scorer::Ptr& s : scorers) {
+        int kernel = scorerKernel(s);
+        if(kernel <= last) {
+            // unknown, duplicate or out of order
+            scorers_valid_ = false;
+            return false;
+        }
+        last = kernel;
+        mask |= 1u << kernel;
+        weights_[kernel] = s->getWeight();
+    }
+
+    score_one_ = SCORE_ONE[mask];
+    score_batch_ = SCORE_BATCH[mask];
+    scorers_valid_ = true;
+    return true;
+}
+
+bool EvaluationPipeline::configureConstraints(const std::vector<Constraint::Ptr> &constraints)
+{
+    unsigned mask = 0;
+    for(const Constraint::Ptr& c : constraints) {
+        if(dynamic_cast<const Dis2Path_Constraint*>(c.get())) {
+            mask |= 1u << CONSTRAINT_DIS2PATH;
+        } else if(auto d2oc = dynamic_cast<const Dis2Obst_Constraint*>(c.get())) {
+            mask |= 1u << CONSTRAINT_DIS2OBST;
+            obstacle_threshold_ = d2oc->getThreshold();
+        } else {
+            constraints_valid_ = false;
+            return false;
+        }
+    }
+
+    satisfied_one_ = SATISFIED_ONE[mask];
+    satisfied_batch_ = SATISFIED_BATCH[mask];
+    constraints_valid_ = true;
+    return true;
+}
+
+bool EvaluationPipeline::hasScorers() const
+{
+    return scorers_valid_;
+}
+
+bool EvaluationPipeline::hasConstraints() const
+{
+    return constraints_valid_;
+}
@@ -40,40 +40,29 @@ void LocalPlannerClassic::getSuccessors(LNode*& current, std::size_t& nsize, std
     successors.clear();
     twins.resize(nsucc_);
     bool add_n = true;
-    double ori = current->orientation;
-    //translation from the rear axis to the center
-    double trax = L*std::cos(ori)/2.0;
-    double tray = L*std::sin(ori)/2.0;
-    double ox = current->x - trax;
-    double oy = current->y - tray;
-    int j = 0;
-    for(int i = 0; i < nsucc_; ++i){
-        double x,y,theta,rt;
-        if(i == 0){// straight
-            theta = ori;
-            x = ox + step_*std::cos(theta) + trax;
-            y = oy + step_*std::sin(theta) + tray;
-            rt = std::numeric_limits<double>::infinity();
-        }else{
-            if(i % 2 == 1){// right
-                rt = -RT[j];
-                theta = -D_THETA[j];
-            }else{// left
-                rt = RT[j];
-                theta = D_THETA[j];
-                j++;
-            }
-            theta = MathHelper::AngleClamp(ori + theta);
-            trax = L*std::cos(theta)/2.0;
-            tray = L*std::sin(theta)/2.0;
-            x = ox + rt*(std::sin(theta)-std::sin(ori)) + trax;
-            y = oy + rt*(-std::cos(theta)+std::cos(ori)) + tray;
 
-        }
-        LNode succ(x,y,theta,current,rt,current->level_+1);
+    expandPrimitives(*current);
+    for(LNode& succ : candidates_){
         setDistances(succ);
+    }
 
-        if(areConstraintsSAT(succ)){
+    // check the constraints of all candidates at once
+    candidate_sat_.resize(candidates_.size());
+    if(pipeline_.hasConstraints()){
+        candidate_ptrs_.clear();
+        for(const LNode& succ : candidates_){
+            candidate_ptrs_.push_back(&succ);
+        }
+        pipeline_.areSatisfied(candidate_ptrs_.data(), candidate_ptrs_.size(), candidate_sat_.data());
+    }else{
+        for(std::size_t i = 0; i < candidates_.size(); ++i){
+            candidate_sat_[i] = areConstraintsSAT(candidates_[i]);
+        }
+    }
+
+    for(std::size_t i = 0; i < candidates_.size(); ++i){
+        const LNode& succ = candidates_[i];
+        if(candidate_sat_[i]){
             int wo = -1;
             if(!isInGraph(succ,nodes,nsize,wo)){
                 if(add_n){
@@ -346,6 +335,66 @@ void LocalPlannerClassic::setStep(){
     double v_dis = velocity_*velocity_/mudiv_;
     FFL = FL + v_dis;
     beta2 = std::acos(FFL/std::sqrt(FFL*FFL + GW*GW));
+
+    initPrimitives();
+}
+
+void LocalPlannerClassic::initPrimitives(){
+    prim_dx_.clear();
+    prim_dy_.clear();
+    prim_dtheta_.clear();
+    prim_radius_.clear();
+    if(D_THETA.size() != RT.size()){
+        // setStep has not been called for the current parameters yet
+        return;
+    }
+
+    // straight
+    prim_dx_.push_back(step_);
+    prim_dy_.push_back(0.0);
+    prim_dtheta_.push_back(0.0);
+    prim_radius_.push_back(std::numeric_limits<double>::infinity());
+
+    // arcs around the rear axis: right, left for each radius
+    for(std::size_t j = 0; j < RT.size(); ++j){
+        for(int side = -1; side <= 1; side += 2){
+            double rt = side*RT[j];
+            double d_theta = side*D_THETA[j];
+            prim_dx_.push_back(rt*std::sin(d_theta) + L*(std::cos(d_theta) - 1.0)/2.0);
+            prim_dy_.push_back(rt*(1.0 - std::cos(d_theta)) + L*std::sin(d_theta)/2.0);
+            prim_dtheta_.push_back(d_theta);
+            prim_radius_.push_back(rt);
+        }
+    }
+
+    succ_x_.resize(prim_dx_.size());
+    succ_y_.resize(prim_dx_.size());
+}
+
+void LocalPlannerClassic::expandPrimitives(const LNode& current){
+    const std::size_t n = prim_dx_.size();
+    const double ori = current.orientation;
+    const double c = std::cos(ori);
+    const double s = std::sin(ori);
+    const double cx = current.x;
+    const double cy = current.y;
+
+    // rotate all primitives into the frame of the current node at once
+    const double* dx = prim_dx_.data();
+    const double* dy = prim_dy_.data();
+    double* x = succ_x_.data();
+    double* y = succ_y_.data();
+    for(std::size_t i = 0; i < n; ++i){
+        x[i] = cx + dx[i]*c - dy[i]*s;
+        y[i] = cy + dx[i]*s + dy[i]*c;
+    }
+
+    candidates_.clear();
+    LNode* parent = const_cast<LNode*>(&current);
+    for(std::size_t i = 0; i < n; ++i){
+        double theta = prim_dtheta_[i] == 0.0 ? ori : MathHelper::AngleClamp(ori + prim_dtheta_[i]);
+        candidates_.emplace_back(x[i], y[i], theta, parent, prim_radius_[i], current.level_+1);
+    }
 }
 
 
@@ -470,6 +519,9 @@ void LocalPlannerClassic::setNormalizer(){
 }
 
 bool LocalPlannerClassic::areConstraintsSAT(const LNode& current){
+    if(pipeline_.hasConstraints()) {
+        return pipeline_.isSatisfied(current);
+    }
     for(Constraint::Ptr c : constraints) {
         if(!c->isSatisfied(current)) {
             return false;
@@ -502,6 +554,9 @@ double LocalPlannerClassic::Cost(const LNode& current, double& score){
 }
 
 double LocalPlannerClassic::Score(const LNode& current){
+    if(pipeline_.hasScorers()){
+        return pipeline_.score(current);
+    }
     double score = 0.0;
     for(std::size_t i = 0; i < scorers.size(); ++i){
         Scorer::Ptr scorer = scorers.at(i);
@@ -510,6 +565,17 @@ double LocalPlannerClassic::Score(const LNode& current){
     return score;
 }
 
+void LocalPlannerClassic::Score(const std::vector<LNode*>& nodes, std::vector<double>& scores){
+    scores.resize(nodes.size());
+    if(pipeline_.hasScorers()){
+        pipeline_.score(nodes.data(), nodes.size(), scores.data());
+    }else{
+        for(std::size_t i = 0; i < nodes.size(); ++i){
+            scores[i] = Score(*nodes[i]);
+        }
+    }
+}
+
 void LocalPlannerClassic::setLastLocalPaths(std::size_t index){
     SubPath tmp_p = (SubPath)last_local_path_;
     SubPath tmp_p_short;
@@ -710,6 +776,10 @@ bool LocalPlannerClassic::algo(Eigen::Vector3d& pose, SubPath& local_wps,
     setD2P(wpose);
     initConstraints();
 
+    // select the fused evaluation for the current scorers and constraints
+    pipeline_.configureScorers(scorers);
+    pipeline_.configureConstraints(constraints);
+
     std::vector<LNode> nodes(max_num_nodes_);
     LNode* obj = nullptr;
     LNode* best_non_reconf = nullptr;
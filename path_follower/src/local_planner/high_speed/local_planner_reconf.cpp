@@ -75,11 +75,13 @@ void LocalPlannerReconf::reconfigureTree(LNode*& obj, std::vector<LNode>& nodes,
             obj = nullptr;
             return;
         }
-        for(LNode* altern: alts){
-            double current_p = Score(*altern);
+        std::vector<double> scores;
+        Score(alts, scores);
+        for(std::size_t i = 0; i < alts.size(); ++i){
+            double current_p = scores[i];
             if(current_p < best_p){
                 best_p = current_p;
-                obj = altern;
+                obj = alts[i];
             }
         }
     }
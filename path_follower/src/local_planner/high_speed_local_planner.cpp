@@ -25,15 +25,10 @@ bool HighSpeedLocalPlanner::transform2Odo(ros::Time& now)
     std::string world_frame = PathFollowerParameters::getInstance()->world_frame();
     std::string odom_frame = PathFollowerParameters::getInstance()->odom_frame();
 
-    try{//Try to get the latest avaiable Transform
-        transformer_->lookupTransform(world_frame, odom_frame, ros::Time(0), now_map_to_odom);
-    }catch(tf::TransformException ex){//if not available, then wait
-        (void) ex;
-        if(!transformer_->waitForTransform(world_frame, odom_frame, now, ros::Duration(0.1))){
-            ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
-            return false;
-        }
-        transformer_->lookupTransform(world_frame, odom_frame, now, now_map_to_odom);
+    // the latest transform, if there is none, wait for the current one
+    if(!pose_tracker_->lookupLatestTransform(world_frame, odom_frame, now, ros::Duration(0.1), now_map_to_odom)){
+        ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
+        return false;
     }
 
     tf::Transform transform_correction = now_map_to_odom.inverse();
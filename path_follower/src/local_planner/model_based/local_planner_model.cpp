@@ -39,15 +39,9 @@ LocalPlannerModel::LocalPlannerModel()
 
 bool LocalPlannerModel::GetTransform(ros::Time time,std::string targetFrame, std::string sourceFrame, tf::StampedTransform &trans)
 {
-    try{//Try to get the latest avaiable Transform
-        transformer_->lookupTransform(targetFrame, sourceFrame, time, trans);
-    }catch(tf::TransformException ex){//if not available, then wait
-        (void) ex;
-        if(!transformer_->waitForTransform(targetFrame, sourceFrame, time, ros::Duration(0.05))){
-            ROS_WARN_STREAM_THROTTLE_NAMED(1, "LocalPlannerModel", "cannot lookup transform from :" << targetFrame << " to " << sourceFrame);
-            return false;
-        }
-        transformer_->lookupTransform(targetFrame, sourceFrame, time, trans);
+    if(!pose_tracker_->lookupTransform(targetFrame, sourceFrame, time, ros::Duration(0.05), trans)){
+        ROS_WARN_STREAM_THROTTLE_NAMED(1, "LocalPlannerModel", "cannot lookup transform from :" << targetFrame << " to " << sourceFrame);
+        return false;
     }
 
     return true;
@@ -96,6 +90,7 @@ Path::Ptr LocalPlannerModel::updateLocalPath_BaseLink()
 
     if(!transform2base(now)){
         ROS_WARN_THROTTLE(1, "cannot calculate local path, transform to odom not known");
+        model_based_planner_->DiscardRefinedResult();
         return local_path;
     }
 
@@ -124,6 +119,7 @@ Path::Ptr LocalPlannerModel::updateLocalPath_BaseLink()
     }
 
     if(!algo(local_wps)){
+        model_based_planner_->DiscardRefinedResult();
         return local_path;
     }
 
@@ -135,10 +131,13 @@ Path::Ptr LocalPlannerModel::updateLocalPath_BaseLink()
 
     //PublishDebugImage();
 
-    if(!transformWPS(robot_frame,odom_frame,local_wps,now )){
+    tf::Transform transform;
+    if(!transformWPS(robot_frame,odom_frame,local_wps,now,transform)){
         ROS_WARN_THROTTLE(1, "cannot calculate local path, transform to odom not known");
+        model_based_planner_->DiscardRefinedResult();
         return local_path;
     }
+    refinement_transform_ = transform;
     return setPath(odom_frame, local_wps, now);
 
     //return setPath(robot_frame, local_wps, now);
@@ -249,6 +248,7 @@ Path::Ptr LocalPlannerModel::updateLocalPath_LocalMap()
 
     if (sqrt(tGoalDist.dot(tGoalDist)) < opt_->min_distance_to_goal())
     {
+        model_based_planner_->DiscardRefinedResult();
         return local_path;
     }
 
@@ -275,15 +275,19 @@ Path::Ptr LocalPlannerModel::updateLocalPath_LocalMap()
     }
 
     if(!algo(local_wps)){
+        model_based_planner_->DiscardRefinedResult();
         return local_path;
     }
 
     //PublishDebugImage();
 
-    if(!transformWPS(map_frame,odom_frame,local_wps,now )){
+    tf::Transform transform;
+    if(!transformWPS(map_frame,odom_frame,local_wps,now,transform)){
         ROS_WARN_THROTTLE(1, "cannot calculate local path, transform to odom not known");
+        model_based_planner_->DiscardRefinedResult();
         return local_path;
     }
+    refinement_transform_ = transform;
     return setPath(odom_frame, local_wps, now);
 
 }
@@ -337,6 +341,9 @@ Path::Ptr LocalPlannerModel::updateLocalPath()
         }
 
 
+    }
+    else if(!close_to_goal_) {
+        return updateLocalPath_Refined();
     }
     else {
         return nullptr;
@@ -344,6 +351,28 @@ Path::Ptr LocalPlannerModel::updateLocalPath()
 
 }
 
+Path::Ptr LocalPlannerModel::updateLocalPath_Refined()
+{
+    if (!model_based_planner_->FetchRefinedResult()) return nullptr;
+
+    SubPath local_wps;
+    local_wps.forward = true;
+
+    if (!resultToWaypoints(local_wps)) return nullptr;
+
+    ROS_DEBUG_STREAM_NAMED("LocalPlannerModel", "using refined trajectory with " << local_wps.size() << " waypoints");
+
+    applyTransform(refinement_transform_, local_wps);
+
+    // the refined result must not delay the next planning cycle
+    ros::Time last_update = last_update_;
+    std::string odom_frame = PathFollowerParameters::getInstance()->odom_frame();
+    Path::Ptr local_path = setPath(odom_frame, local_wps, ros::Time::now());
+    last_update_ = last_update;
+
+    return local_path;
+}
+
 
 
 void LocalPlannerModel::setVelocity(geometry_msgs::Twist vector)
@@ -474,15 +503,10 @@ bool LocalPlannerModel::transform2base(ros::Time& now)
     std::string world_frame = PathFollowerParameters::getInstance()->world_frame();
     std::string robot_frame = PathFollowerParameters::getInstance()->robot_frame();
 
-    try{//Try to get the latest avaiable Transform
-        transformer_->lookupTransform(world_frame, robot_frame, ros::Time(0), now_map_to_base);
-    }catch(tf::TransformException ex){//if not available, then wait
-        (void) ex;
-        if(!transformer_->waitForTransform(world_frame, robot_frame, now, ros::Duration(0.1))){
-            ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
-            return false;
-        }
-        transformer_->lookupTransform(world_frame, robot_frame, now, now_map_to_base);
+    // the latest transform, if there is none, wait for the current one
+    if(!pose_tracker_->lookupLatestTransform(world_frame, robot_frame, now, ros::Duration(0.1), now_map_to_base)){
+        ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
+        return false;
     }
 
     tf::Transform transform_correction = now_map_to_base.inverse();
@@ -516,20 +540,15 @@ bool LocalPlannerModel::transform2base(ros::Time& now)
 
 
 
-bool LocalPlannerModel::transformWPS(std::string source, std::string target, SubPath &waypoints, ros::Time& now)
+bool LocalPlannerModel::transformWPS(std::string source, std::string target, SubPath &waypoints, ros::Time& now, tf::Transform& transform)
 {
     tf::StampedTransform now_transform;
 
 
-    try{//Try to get the latest avaiable Transform
-        transformer_->lookupTransform(target, source, ros::Time(0), now_transform);
-    }catch(tf::TransformException ex){//if not available, then wait
-        (void) ex;
-        if(!transformer_->waitForTransform(target, source, now, ros::Duration(0.1))){
-            ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
-            return false;
-        }
-        transformer_->lookupTransform(target, source, now, now_transform);
+    // the latest transform, if there is none, wait for the current one
+    if(!pose_tracker_->lookupLatestTransform(target, source, now, ros::Duration(0.1), now_transform)){
+        ROS_WARN_THROTTLE_NAMED(1, "local_path", "cannot transform map to odom");
+        return false;
     }
 
     tf::Transform transform_correction = now_transform;
@@ -546,22 +565,25 @@ bool LocalPlannerModel::transformWPS(std::string source, std::string target, Sub
     */
 
     // transform the waypoints from world to odom
+    transform = transform_correction;
+    applyTransform(transform_correction, waypoints);
 
+    return true;
+}
 
+void LocalPlannerModel::applyTransform(const tf::Transform &transform, SubPath &waypoints) const
+{
     for(Waypoint& wp : waypoints) {
         tf::Point pt(wp.x, wp.y, 0);
-        pt = transform_correction * pt;
+        pt = transform * pt;
         wp.x = pt.x();
         wp.y = pt.y();
 
         tf::Quaternion rot = tf::createQuaternionFromYaw(wp.orientation);
-        rot = transform_correction * rot;
+        rot = transform * rot;
         wp.orientation = tf::getYaw(rot);
 
     }
-
-
-    return true;
 }
 
 
@@ -612,7 +634,11 @@ bool LocalPlannerModel::algo(SubPath& local_wps)
 
     //model_based_planner_->Plan();
 
+    return resultToWaypoints(local_wps);
+}
 
+bool LocalPlannerModel::resultToWaypoints(SubPath& local_wps)
+{
     Trajectory *result = model_based_planner_->GetBLResultTrajectory();
 
     if (result == nullptr) return false;
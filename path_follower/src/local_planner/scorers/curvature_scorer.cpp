@@ -20,11 +20,7 @@ void Curvature_Scorer::setMaxC(double& radius){
 
 double Curvature_Scorer::score(const LNode& point){
     sw.resume();
-    if(point.radius_ < std::numeric_limits<double>::infinity()){
-        double div = std::abs(1.0/point.radius_);
-        sw.stop();
-        return div;
-    }
+    double div = compute(point.radius_);
     sw.stop();
-    return 0.0;
+    return div;
 }
@@ -22,9 +22,7 @@ double CurvatureD_Scorer::score(const LNode& point){
     sw.resume();
     double diff = 0.0;
     if(point.parent_ != nullptr){
-        double c_curv = point.radius_ < std::numeric_limits<double>::infinity() ? 1.0/point.radius_:0.0;
-        double p_curv = point.parent_->radius_ < std::numeric_limits<double>::infinity() ? 1.0/point.parent_->radius_:0.0;
-        diff = c_curv - p_curv ;
+        diff = compute(point.radius_, point.parent_->radius_);
     }
     sw.stop();
     return diff;
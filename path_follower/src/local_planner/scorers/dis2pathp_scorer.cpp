@@ -20,7 +20,7 @@ void Dis2PathP_Scorer::setMaxD(double& dis){
 
 double Dis2PathP_Scorer::score(const LNode& point){
     sw.resume();
-    double p = point.d2p;
+    double p = compute(point.d2p);
     sw.stop();
     return p;
 }
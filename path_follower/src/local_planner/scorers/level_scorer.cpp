@@ -20,7 +20,7 @@ void Level_Scorer::setLevel(const int& m_level){
 
 double Level_Scorer::score(const LNode& point){
     sw.resume();
-    double ls = (double)(max_level  - point.level_);
+    double ls = compute(point.level_);
     sw.stop();
     return ls;
 }
@@ -4,6 +4,7 @@
 /// PROJECT
 #include <path_follower/pathfollower.h>
 #include <path_follower/utils/path_exceptions.h>
+#include <path_follower/utils/visualizer.h>
 
 /// SYSTEM
 #include <boost/variant.hpp>
@@ -51,6 +52,9 @@ void PathFollowerServer::spin()
 
 void PathFollowerServer::update()
 {
+    // publish all markers of this tick together at its end
+    Visualizer::Frame vis_frame;
+
     if (follow_path_server_.isActive()) {
         if(follow_path_server_.isPreemptRequested()) {
             ROS_INFO("preempt is requested");
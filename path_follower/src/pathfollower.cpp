@@ -29,6 +29,7 @@
 #include <path_follower/supervisor/supervisorchain.h>
 #include <path_follower/utils/pose_tracker.h>
 #include <path_follower/collision_avoidance/collision_avoider.h>
+#include <nav_tracing/tracing.h>
 
 
 using namespace path_msgs;
@@ -118,11 +119,8 @@ PathFollower::~PathFollower()
 
 void PathFollower::setObstacles(const std::shared_ptr<ObstacleCloud const> &msg)
 {
-    obstacle_cloud_ = msg;
-
-    if(current_config_) {
-        current_config_->collision_avoider_->setObstacles(msg);
-    }
+    // handed to the collision avoider at the start of the next tick
+    perception_.setObstacleCloud(msg);
 }
 
 void PathFollower::setExternalError(const int &extError)
@@ -136,7 +134,7 @@ void PathFollower::setExternalError(const int &extError)
 
 void PathFollower::setElevationMap(const std::shared_ptr<ElevationMap const> &msg)
 {
-    elevation_map_ = msg;
+    perception_.setElevationMap(msg);
     /*
     if(current_config_) {
         current_config_->collision_avoider_->setElevationMap(msg);
@@ -146,8 +144,19 @@ void PathFollower::setElevationMap(const std::shared_ptr<ElevationMap const> &ms
 
 boost::variant<FollowPathFeedback, FollowPathResult> PathFollower::update()
 {
+    NAV_TRACE_SCOPE("path_follower/update");
+
     ROS_ASSERT(current_config_);
 
+    // all transforms of this tick are answered from one snapshot
+    PoseTracker::Tick tf_tick(*pose_tracker_);
+
+    // all stages of this tick see the same perception inputs, even if new ones arrive meanwhile
+    const PerceptionSnapshot::ConstPtr perception = perception_.snapshot();
+    if(perception->obstacle_cloud) {
+        current_config_->collision_avoider_->setObstacles(perception->obstacle_cloud);
+    }
+
     FollowPathFeedback feedback;
     FollowPathResult result;
 
@@ -161,7 +170,11 @@ boost::variant<FollowPathFeedback, FollowPathResult> PathFollower::update()
         return result;
     }
 
-    if (!pose_tracker_->updateRobotPose()) {
+    nav_tracing::Span pose_span("path_follower/update_robot_pose");
+    bool has_pose = pose_tracker_->updateRobotPose();
+    pose_span.end();
+
+    if (!has_pose) {
         ROS_ERROR("do not known own pose");
         stop(FollowPathResult::RESULT_STATUS_SLAM_FAIL);
 
@@ -173,7 +186,7 @@ boost::variant<FollowPathFeedback, FollowPathResult> PathFollower::update()
     // Ask supervisor whether path following can continue
     Supervisor::State state(pose_tracker_->getRobotPose(),
                             path_,
-                            obstacle_cloud_,
+                            perception->obstacle_cloud,
                             feedback);
 
     Supervisor::Result s_res = supervisors_->supervise(state);
@@ -191,11 +204,11 @@ boost::variant<FollowPathFeedback, FollowPathResult> PathFollower::update()
     } else  {
         //End Constraints and Scorers Construction
         publishPathMarker();
-        if(obstacle_cloud_ != nullptr){
-            current_config_->local_planner_->setObstacleCloud(obstacle_cloud_);
+        if(perception->obstacle_cloud != nullptr){
+            current_config_->local_planner_->setObstacleCloud(perception->obstacle_cloud);
         }
-        if(elevation_map_ != nullptr){
-            current_config_->local_planner_->setElevationMap(elevation_map_);
+        if(perception->elevation_map != nullptr){
+            current_config_->local_planner_->setElevationMap(perception->elevation_map);
         }
 
 
@@ -209,7 +222,9 @@ boost::variant<FollowPathFeedback, FollowPathResult> PathFollower::update()
 
         bool path_search_failure = false;
         try {
+            nav_tracing::Span local_path_span("local_planner/update_local_path");
             Path::Ptr local_path = current_config_->local_planner_->updateLocalPath();
+            local_path_span.end();
             path_search_failure = local_path && local_path->empty();
             if(local_path && !path_search_failure) {
                 path_msgs::PathSequence path;
@@ -451,8 +466,9 @@ void PathFollower::setGoal(const FollowPathGoal &goal)
     }
 
     ROS_ASSERT(current_config_);
-    if(obstacle_cloud_) {
-        current_config_->collision_avoider_->setObstacles(obstacle_cloud_);
+    const PerceptionSnapshot::ConstPtr perception = perception_.snapshot();
+    if(perception->obstacle_cloud) {
+        current_config_->collision_avoider_->setObstacles(perception->obstacle_cloud);
     }
 
     vel_ = goal.follower_options.velocity;
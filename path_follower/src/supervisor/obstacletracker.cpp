@@ -1,155 +1,289 @@
 #include <path_follower/supervisor/obstacletracker.h>
+#include <path_follower/utils/point_grid.h>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
 
 using namespace std;
 
 namespace {
 //! Module name, that is used for ros console output
 const std::string MODULE = "s_obstacle_tracker";
+
+//! Groups with more obstacles on one side are matched greedily, the Hungarian algorithm is O(n^3).
+const size_t MAX_HUNGARIAN_SIZE = 100;
+
+struct Candidate
+{
+    int observed;
+    int tracked;
+    float dist;
+};
+
+int findRoot(vector<int>& parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
 }
 
-void ObstacleTracker::update(std::vector<Obstacle> observed_obstacles)
+/**
+ * @brief Hungarian algorithm (Kuhn-Munkres with potentials) for a rows x cols cost matrix with rows <= cols.
+ * @return For each row the assigned column.
+ */
+vector<int> hungarian(const vector<double>& cost, int rows, int cols)
 {
-    /**
-     * There is a slight difference in the actual implementation of the algorithmn, compared to the description in the
-     * class comment:
-     * Since removing rows/columns from the distance matrix changes the indices of the remaining entries, it would be
-     * quite complicated to keep the connetion between the obstacles and the entries in the matrix. Therefore, instead
-     * of cutting the distance matrix ('dist'), an additional matrix 'd_idx' is constructed, containing indices to the
-     * fields in the distance matrix. This index-matrix is then used to cut away matched obstacles, instead of the
-     * distance matrix itself.
-     */
+    const double inf = numeric_limits<double>::infinity();
 
-    // TODO: exploit enclosing circle of obstacles for matching (match if center is within the circle or something like that)
+    // 1-based, column 0 is a virtual column used to insert the next row
+    vector<double> u(rows + 1, 0.0), v(cols + 1, 0.0);
+    vector<int> row_of_col(cols + 1, 0), way(cols + 1, 0);
+    vector<double> min_v(cols + 1);
+    vector<char> used(cols + 1);
 
+    for (int r = 1; r <= rows; ++r) {
+        row_of_col[0] = r;
+        int col0 = 0;
+        fill(min_v.begin(), min_v.end(), inf);
+        fill(used.begin(), used.end(), 0);
 
-    // Delete "dead" obstacles, which could not be matched for more than the time, specified in lost_lifetime_.
-    // Use ugly c++ version of functional "filter"...
-    // FIXME: I think it's not the best solution to drop old entries before matching, as this will completely crush
-    // any tracking, if lost_lifetime is set to 0 ("do not track obstacles that are out of sight"). Doing it after
-    // matching will cause the same problem though, as there is a small amount of time passing between the two steps.
-    // It has somehow to be guaranteed, that no obstacles are dropped, that could be matched in this iteration.
-    size_t dead_count = obstacles_.size();
-    obstacles_.erase(std::remove_if(obstacles_.begin(), obstacles_.end(),
-                                    [this](TrackedObstacle o) { return isDead(o); }),
-                     obstacles_.end());
-    dead_count = dead_count - obstacles_.size();
+        // find an augmenting path from row r to a free column
+        do {
+            used[col0] = 1;
+            const int row0 = row_of_col[col0];
+            double delta = inf;
+            int col1 = 0;
+            for (int c = 1; c <= cols; ++c) {
+                if (!used[c]) {
+                    double reduced = cost[(row0 - 1) * cols + (c - 1)] - u[row0] - v[c];
+                    if (reduced < min_v[c]) {
+                        min_v[c] = reduced;
+                        way[c] = col0;
+                    }
+                    if (min_v[c] < delta) {
+                        delta = min_v[c];
+                        col1 = c;
+                    }
+                }
+            }
+            for (int c = 0; c <= cols; ++c) {
+                if (used[c]) {
+                    u[row_of_col[c]] += delta;
+                    v[c] -= delta;
+                } else {
+                    min_v[c] -= delta;
+                }
+            }
+            col0 = col1;
+        } while (row_of_col[col0] != 0);
 
+        // flip the path
+        do {
+            const int col1 = way[col0];
+            row_of_col[col0] = row_of_col[col1];
+            col0 = col1;
+        } while (col0 != 0);
+    }
 
-    // construct distanc matrix. D[i,j] = distance between observed obstacle i and tracked obstacle j.
-    cv::Mat dist(observed_obstacles.size(), obstacles_.size(), CV_32F);
-    cv::Mat d_idx(dist.rows, dist.cols, CV_16U);
-    vector<bool> obs_matched(observed_obstacles.size(), false);
+    vector<int> col_of_row(rows, -1);
+    for (int c = 1; c <= cols; ++c) {
+        if (row_of_col[c] != 0) {
+            col_of_row[row_of_col[c] - 1] = c - 1;
+        }
+    }
+    return col_of_row;
+}
 
-    ushort i = 0; // ATTENTION: i is the data-index to dist. Therefore the outer loop must iterate over rows, the inner over columns!
-    for (size_t o = 0; o < observed_obstacles.size(); ++o)
-    for (size_t t = 0; t < obstacles_.size();         ++t) {
-        dist.at<float>(o, t)   = norm(observed_obstacles[o].center - obstacles_[t].obstacle().center);
-        d_idx.at<ushort>(o, t) = i++;
+/**
+ * @brief Matches one group optimally: the maximal number of pairs with the minimal sum of distances.
+ */
+void matchOptimal(const vector<int>& observed, const vector<int>& tracked, const vector<Candidate>& candidates,
+                  float max_dist, vector<int>& result)
+{
+    // rows have to be the smaller side
+    const bool transposed = observed.size() > tracked.size();
+    const vector<int>& row_ids = transposed ? tracked : observed;
+    const vector<int>& col_ids = transposed ? observed : tracked;
+    const int rows = row_ids.size();
+    const int cols = col_ids.size();
 
+    // pairs that are not candidates are more expensive than any set of candidates, so that the number of
+    // matched candidates is maximized first
+    const double not_allowed = (rows + 1) * (double) max_dist + 1.0;
+    vector<double> cost(rows * cols, not_allowed);
+
+    // local indices of the obstacles of this group
+    auto local = [](const vector<int>& ids, int id) {
+        return (int) (lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+    };
+    for (const Candidate& c : candidates) {
+        int r = local(row_ids, transposed ? c.tracked : c.observed);
+        int k = local(col_ids, transposed ? c.observed : c.tracked);
+        cost[r * cols + k] = c.dist;
     }
 
-    //ROS_DEBUG_STREAM_NAMED(MODULE, "D =\n" << dist);
-
-    // now match the points
-    int match_counter = 0;
-    while (!d_idx.empty()) {
-        //ROS_DEBUG_STREAM_NAMED(MODULE, "Didx =\n" << d_idx);
-
-        // min_idx = argmin(D)
-        float min = dist.at<float>(d_idx.at<ushort>(0));
-        int min_idx = 0;
-        for (int i = 1; i < d_idx.rows*d_idx.cols; ++i) {
-            int idx = d_idx.at<ushort>(i);
-            if (dist.at<float>(idx) < min) {
-                min = dist.at<float>(idx);
-                min_idx = i;
-            }
+    vector<int> assignment = hungarian(cost, rows, cols);
+    for (int r = 0; r < rows; ++r) {
+        int k = assignment[r];
+        if (k < 0 || cost[r * cols + k] >= not_allowed) {
+            continue;
         }
+        if (transposed) {
+            result[col_ids[k]] = row_ids[r];
+        } else {
+            result[row_ids[r]] = col_ids[k];
+        }
+    }
+}
+
+/**
+ * @brief Matches one group greedily: the pair with the minimal distance first.
+ */
+void matchGreedy(vector<Candidate> candidates, size_t n_tracked, vector<int>& result)
+{
+    sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.dist < b.dist;
+    });
+    vector<char> tracked_matched(n_tracked, 0);
+    for (const Candidate& c : candidates) {
+        if (result[c.observed] < 0 && !tracked_matched[c.tracked]) {
+            result[c.observed] = c.tracked;
+            tracked_matched[c.tracked] = 1;
+        }
+    }
+}
+}
+
+std::vector<int> ObstacleTracker::match(const std::vector<cv::Point2f> &observed, const std::vector<cv::Point2f> &tracked,
+                                        float max_dist)
+{
+    vector<int> result(observed.size(), -1);
+    if (observed.empty() || tracked.empty()) {
+        return result;
+    }
 
-        //ROS_DEBUG_NAMED(MODULE, "min idx = %d (%d), dist = %g", d_idx.at<ushort>(min_idx), min_idx, dist.at<float>(d_idx.at<ushort>(min_idx)));
+    // gating: find all pairs within max_dist with a grid over the tracked obstacles
+    PointGrid grid;
+    grid.build(tracked, max_dist, 4 * tracked.size() + 64);
 
-        // If the shortest distance is to big, assume that all matchable obstacles are matched.
-        if (min > opt_.max_dist()) {
-            break;
+    const float max_dist2 = max_dist * max_dist;
+    vector<Candidate> candidates;
+    for (size_t o = 0; o < observed.size(); ++o) {
+        const cv::Point2f& p = observed[o];
+        grid.forEachInBox(p.x - max_dist, p.y - max_dist, p.x + max_dist, p.y + max_dist, [&](std::uint32_t t) {
+            const cv::Point2f d = p - tracked[t];
+            const float d2 = d.dot(d);
+            if (d2 <= max_dist2) {
+                candidates.push_back(Candidate { (int) o, (int) t, std::sqrt(d2) });
+            }
+        });
+    }
+    if (candidates.empty()) {
+        return result;
+    }
+
+    // connected components of the candidate graph, tracked obstacle t is node observed.size() + t
+    const int n_observed = observed.size();
+    vector<int> parent(observed.size() + tracked.size());
+    iota(parent.begin(), parent.end(), 0);
+    for (const Candidate& c : candidates) {
+        int a = findRoot(parent, c.observed);
+        int b = findRoot(parent, n_observed + c.tracked);
+        if (a != b) {
+            parent[max(a, b)] = min(a, b);
         }
+    }
 
-        // data-index to distance-matrix coords (mi, mj are the indices of the matched obstacles)
-        int mi = d_idx.at<ushort>(min_idx) / dist.cols;
-        int mj = d_idx.at<ushort>(min_idx) % dist.cols;
-        // ... and to index-matrix coords (those are only needed, to remove the corresponding row and column, a few lines below)
-        int mi_idx = min_idx / d_idx.cols;
-        int mj_idx = min_idx % d_idx.cols;
-
-        //ROS_DEBUG_NAMED(MODULE, "matched %d, %d (%d,%d)", mi, mj, mi_idx, mj_idx);
-
-        // match observed obstacle mi with tracked obstacle mj
-        obstacles_[mj].update(observed_obstacles[mi]);
-        ++match_counter;
-        // mark mi as matched.
-        obs_matched[mi] = true;
-
-        // delete mi and mj from the distances index matrix
-        removeRow(d_idx, mi_idx);
-        if (d_idx.empty())
-            break; // stop before calling removeColumn on an empty matrix will cause a crash.
-        removeColumn(d_idx, mj_idx);
+    // sort the candidates by component, so that every component is a contiguous block
+    vector<int> component(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        component[i] = findRoot(parent, candidates[i].observed);
     }
+    vector<size_t> order(candidates.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&component](size_t a, size_t b) {
+        return component[a] < component[b];
+    });
 
-//    ROS_DEBUG_NAMED(MODULE, "Matched %d obstacles", match_counter);
-//    ROS_DEBUG_NAMED(MODULE, "Lost %zu obstacles", obstacles_.size() - match_counter);
-//    ROS_DEBUG_NAMED(MODULE, "Droped %zu dead obstacles", dead_count);
+    vector<Candidate> group;
+    vector<int> group_observed, group_tracked;
+    for (size_t begin = 0; begin < order.size();) {
+        size_t end = begin;
+        group.clear();
+        group_observed.clear();
+        group_tracked.clear();
+        for (; end < order.size() && component[order[end]] == component[order[begin]]; ++end) {
+            const Candidate& c = candidates[order[end]];
+            group.push_back(c);
+            group_observed.push_back(c.observed);
+            group_tracked.push_back(c.tracked);
+        }
+        begin = end;
 
-    // If there are unmatched obstacles in the observation, add them as new obstacles
-    int add_counter = 0;
-    for (size_t i = 0; i < observed_obstacles.size(); ++i) {
-        if (!obs_matched[i]) {
-            TrackedObstacle to(observed_obstacles[i]);
-            obstacles_.push_back(to);
-            ++add_counter;
+        sort(group_observed.begin(), group_observed.end());
+        group_observed.erase(unique(group_observed.begin(), group_observed.end()), group_observed.end());
+        sort(group_tracked.begin(), group_tracked.end());
+        group_tracked.erase(unique(group_tracked.begin(), group_tracked.end()), group_tracked.end());
+
+        if (group.size() == 1) {
+            result[group[0].observed] = group[0].tracked;
+        } else if (min(group_observed.size(), group_tracked.size()) > MAX_HUNGARIAN_SIZE) {
+            matchGreedy(group, tracked.size(), result);
+        } else {
+            matchOptimal(group_observed, group_tracked, group, max_dist, result);
         }
     }
 
-//    ROS_DEBUG_NAMED(MODULE, "Added %d new obstacles", add_counter);
+    return result;
 }
 
-void ObstacleTracker::reset()
+void ObstacleTracker::update(const std::vector<Obstacle> &observed_obstacles)
 {
-    obstacles_.clear();
-}
+    // TODO: exploit enclosing circle of obstacles for matching (match if center is within the circle or something like that)
 
-bool ObstacleTracker::isDead(ObstacleTracker::TrackedObstacle o)
-{
-    return (ros::Time::now() - o.time_of_last_sight()) > ros::Duration(opt_.lost_lifetime());
+
+    // Delete "dead" obstacles, which could not be matched for more than the time, specified in lost_lifetime_.
+    // FIXME: I think it's not the best solution to drop old entries before matching, as this will completely crush
+    // any tracking, if lost_lifetime is set to 0 ("do not track obstacles that are out of sight"). Doing it after
+    // matching will cause the same problem though, as there is a small amount of time passing between the two steps.
+    // It has somehow to be guaranteed, that no obstacles are dropped, that could be matched in this iteration.
+    const ros::Time now = ros::Time::now();
+    obstacles_.erase(std::remove_if(obstacles_.begin(), obstacles_.end(),
+                                    [this, &now](const TrackedObstacle& o) { return isDead(o, now); }),
+                     obstacles_.end());
+
+
+    vector<cv::Point2f> observed(observed_obstacles.size());
+    for (size_t o = 0; o < observed_obstacles.size(); ++o) {
+        observed[o] = observed_obstacles[o].center;
+    }
+    vector<cv::Point2f> tracked(obstacles_.size());
+    for (size_t t = 0; t < obstacles_.size(); ++t) {
+        tracked[t] = obstacles_[t].obstacle().center;
+    }
+
+    vector<int> matches = match(observed, tracked, opt_.max_dist());
+
+    for (size_t i = 0; i < observed_obstacles.size(); ++i) {
+        if (matches[i] >= 0) {
+            obstacles_[matches[i]].update(observed_obstacles[i]);
+        } else {
+            // If there are unmatched obstacles in the observation, add them as new obstacles
+            obstacles_.push_back(TrackedObstacle(observed_obstacles[i]));
+        }
+    }
 }
 
-void ObstacleTracker::removeRow(cv::Mat &m, int row)
+void ObstacleTracker::reset()
 {
-    assert(row >= 0 && row < m.rows);
-
-    // {v|h}concat can not handle empty matrices, thus there are some nasty case distinctions necessary...
-    // Beware: end row/col of range-methods is exclusive!
-    if (row == 0) {
-        m = m.rowRange(1,m.rows);
-    } else if (row == m.rows-1) {
-        m = m.rowRange(0,row);
-    } else {
-        cv::vconcat(m.rowRange(0,row), m.rowRange(row+1, m.rows),  m);
-    }
+    obstacles_.clear();
 }
 
-void ObstacleTracker::removeColumn(cv::Mat &m, int col)
+bool ObstacleTracker::isDead(const ObstacleTracker::TrackedObstacle &o, const ros::Time &now) const
 {
-    assert(col >= 0 && col < m.cols);
-
-    // {v|h}concat can not handle empty matrices, thus there are some nasty case distinctions necessary...
-    // Beware: end col/col of range-methods is exclusive!
-    if (col == 0) {
-        m = m.colRange(1,m.cols);
-    } else if (col == m.cols-1) {
-        m = m.colRange(0,col);
-    } else {
-        cv::hconcat(m.colRange(0,col), m.colRange(col+1, m.cols),  m);
-    }
+    return (now - o.time_of_last_sight()) > ros::Duration(opt_.lost_lifetime());
 }
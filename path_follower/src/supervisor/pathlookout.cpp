@@ -8,9 +8,11 @@
 #endif
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <cmath>
 
 #include <laser_geometry/laser_geometry.h>
-#include <pcl_ros/transforms.h>
+#include <pcl_conversions/pcl_conversions.h>
 
 #include <path_follower/utils/obstacle_cloud.h>
 #include <pcl_ros/point_cloud.h>
@@ -77,7 +79,7 @@ void PathLookout::supervise(State &state, Supervisor::Result *out)
     // Update tracker
     tracker_.update(observed_obstacles);
 
-    vector<ObstacleTracker::TrackedObstacle> tracked_obs = tracker_.getTrackedObstacles();
+    const vector<ObstacleTracker::TrackedObstacle>& tracked_obs = tracker_.getTrackedObstacles();
     if (tracked_obs.empty()) {
         // no obstacles --> everything is fine.
         return;
@@ -146,11 +148,11 @@ void PathLookout::eventNewGoal()
 
 vector<Obstacle> PathLookout::lookForObstacles()
 {
-    list<cv::Point2f> obs_front = findObstaclesInCloud(obstacle_cloud_);
+    vector<cv::Point2f> obs_front = findObstaclesInCloud(obstacle_cloud_);
 
     // cluster
-    list<list<cv::Point2f> > obstacle_points = clusterPoints(obs_front,
-                                                             opt_.scan_cluster_max_distance());
+    vector<vector<cv::Point2f> > obstacle_points = clusterPoints(obs_front,
+                                                                 opt_.scan_cluster_max_distance());
 
     vector<Obstacle> observed_obstacles;
     observed_obstacles.reserve(obstacle_points.size());
@@ -163,8 +165,7 @@ vector<Obstacle> PathLookout::lookForObstacles()
         try {
             // get obstacle position and size from enclosing circle
             Obstacle obstacle;
-            vector<cv::Point2f> v_obs_points(it->begin(), it->end());
-            cv::minEnclosingCircle(v_obs_points, obstacle.center, obstacle.radius);
+            cv::minEnclosingCircle(*it, obstacle.center, obstacle.radius);
 
             observed_obstacles.push_back(obstacle);
         } catch (const tf::TransformException& ex) {
@@ -184,29 +185,113 @@ void PathLookout::reset()
     tracker_.reset();
 }
 
-std::list<std::list<cv::Point2f> > PathLookout::clusterPoints(const std::list<cv::Point2f> &points,
-                                                              const float dist_threshold)
+std::vector<std::vector<cv::Point2f> > PathLookout::clusterPoints(const std::vector<cv::Point2f> &points,
+                                                                  const float dist_threshold)
 {
+    std::vector<std::vector<cv::Point2f> > clusters;
     if (points.empty())
-        return std::list<std::list<cv::Point2f> >();
+        return clusters;
 
-    auto get_x = [](const cv::Point2f &p) { return p.x; };
-    auto get_y = [](const cv::Point2f &p) { return p.y; };
-    std::list<std::list<cv::Point2f> > clusters, x_clusters;
+    const float threshold2 = dist_threshold * dist_threshold;
 
-    // cluster along x-axis
-    x_clusters = clusterPointsAlongAxis(points, dist_threshold, get_x); // O(n log n), n = |points|
+    // all points in a cell of size threshold/sqrt(2) are connected, if the grid does not have to enlarge it
+    PointGrid grid;
+    grid.build(points, dist_threshold / std::sqrt(2.0f), 4 * points.size() + 64);
+    const bool cells_connected = grid.cellSize() * std::sqrt(2.0f) <= dist_threshold;
+    const int reach = std::max(1, (int) std::ceil(dist_threshold / grid.cellSize()));
 
-    // cluster each cluster along y-axis and merge results together in `clusters`
-    for (const auto &cluster: x_clusters) {
-        std::list<std::list<cv::Point2f> > y_clusters = clusterPointsAlongAxis(cluster, dist_threshold, get_y); // O(|c| log |c|)
-        clusters.splice(clusters.end(), std::move(y_clusters));    // O(1)
+    // union-find over the point indices
+    std::vector<std::uint32_t> parent(points.size());
+    for (std::size_t i = 0; i < parent.size(); ++i) {
+        parent[i] = i;
+    }
+    auto find = [&parent](std::uint32_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    auto unite = [&parent, &find](std::uint32_t a, std::uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a != b) {
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    };
+    auto linked = [&points, threshold2](std::uint32_t a, std::uint32_t b) {
+        const cv::Point2f d = points[a] - points[b];
+        return d.dot(d) <= threshold2;
+    };
+
+    for (int cy = 0; cy < grid.height(); ++cy) {
+        for (int cx = 0; cx < grid.width(); ++cx) {
+            const std::uint32_t* begin = grid.begin(cx, cy);
+            const std::uint32_t* end = grid.end(cx, cy);
+            if (begin == end) {
+                continue;
+            }
+
+            for (const std::uint32_t* i = begin + 1; i < end; ++i) {
+                if (cells_connected) {
+                    unite(*begin, *i);
+                } else {
+                    for (const std::uint32_t* j = begin; j < i; ++j) {
+                        if (linked(*i, *j)) {
+                            unite(*i, *j);
+                        }
+                    }
+                }
+            }
+
+            // compare with the cells in the forward half of the neighbourhood, the other half has
+            // already compared itself with this cell
+            for (int dy = 0; dy <= reach; ++dy) {
+                for (int dx = (dy == 0 ? 1 : -reach); dx <= reach; ++dx) {
+                    const int nx = cx + dx;
+                    const int ny = cy + dy;
+                    if (nx < 0 || nx >= grid.width() || ny >= grid.height()) {
+                        continue;
+                    }
+                    const std::uint32_t* n_begin = grid.begin(nx, ny);
+                    const std::uint32_t* n_end = grid.end(nx, ny);
+                    if (n_begin == n_end || (cells_connected && find(*begin) == find(*n_begin))) {
+                        continue;
+                    }
+
+                    bool joined = false;
+                    for (const std::uint32_t* i = begin; i < end && !joined; ++i) {
+                        for (const std::uint32_t* j = n_begin; j < n_end; ++j) {
+                            if (linked(*i, *j) && find(*i) != find(*j)) {
+                                unite(*i, *j);
+                                // both cells are components, one link is enough
+                                if (cells_connected) {
+                                    joined = true;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // collect the components in order of their smallest point index
+    std::vector<int> cluster_of_root(points.size(), -1);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        std::uint32_t root = find(i);
+        if (cluster_of_root[root] < 0) {
+            cluster_of_root[root] = clusters.size();
+            clusters.emplace_back();
+        }
+        clusters[cluster_of_root[root]].push_back(points[i]);
     }
 
     return clusters;
 }
 
-float PathLookout::weightObstacle(cv::Point2f robot_pos, ObstacleTracker::TrackedObstacle o) const
+float PathLookout::weightObstacle(cv::Point2f robot_pos, const ObstacleTracker::TrackedObstacle& o) const
 {
     float dist_to_robot = cv::norm(robot_pos - o.obstacle().center) - o.obstacle().radius;
     ros::Duration lifetime = ros::Time::now() - o.time_of_first_sight();
@@ -224,35 +309,28 @@ float PathLookout::weightObstacle(cv::Point2f robot_pos, ObstacleTracker::Tracke
     return w_dist + w_time;
 }
 
-std::list<cv::Point2f> PathLookout::findObstaclesInCloud(const std::shared_ptr<ObstacleCloud const> &obstacles_container)
-{    
+std::vector<cv::Point2f> PathLookout::findObstaclesInCloud(const std::shared_ptr<ObstacleCloud const> &obstacles_container)
+{
+    std::vector<cv::Point2f> obstacle_points;
+
     if (path_.size() < 2) {
         ROS_WARN_NAMED(MODULE, "Path has fewer than 2 waypoints. No obstacle lookout is done.");
-        return std::list<cv::Point2f>(); // return empty cloud
+        return obstacle_points; // return empty cloud
     }
 
     ObstacleCloud::Cloud::ConstPtr cloud = obstacles_container->cloud;
 
     //TODO: ensure that obstacle_frame_ is the frame of the path.
-    ObstacleCloud::Cloud trans_cloud;
-    bool has_tf = pose_tracker_.getTransformListener().waitForTransform(obstacle_frame_,
-                                                                        cloud->header.frame_id,
-                                                                        pcl_conversions::fromPCL(cloud->header.stamp),
-                                                                        ros::Duration(0.05));
-    if (!has_tf) {
+    tf::StampedTransform trafo;
+    if (!pose_tracker_.lookupTransform(obstacle_frame_, cloud->header.frame_id,
+                                       pcl_conversions::fromPCL(cloud->header.stamp),
+                                       ros::Duration(0.05), trafo)) {
         ROS_WARN_THROTTLE_NAMED(0.5, MODULE, "Got no transfom for obstacle cloud. %s to %s ",obstacle_frame_.c_str(),
                         cloud->header.frame_id.c_str());
-        return std::list<cv::Point2f>(); // return empty cloud
-    }
-    if (!pcl_ros::transformPointCloud(obstacle_frame_, *cloud, trans_cloud, pose_tracker_.getTransformListener())) {
-        ROS_ERROR_THROTTLE_NAMED(1.0, MODULE, "Failed to transform obstacle cloud");
-        return std::list<cv::Point2f>(); // return empty cloud
+        return obstacle_points; // return empty cloud
     }
 
-    //! Contains an 'is obstacle' flag for each point in the cloud
-    vector<bool> is_point_obs(trans_cloud.size(), false);
-
-    cv::Point2f a(path_[0].x, path_[0].y);
+    const float radius = opt_.path_width()/2.0;
 
     // iterate over second to last point, making steps of size opt_.segment_step_size() (i.e.
     // 'step_size' many segments are approximated by one bigger segment).
@@ -267,10 +345,10 @@ std::list<cv::Point2f> PathLookout::findObstaclesInCloud(const std::shared_ptr<O
     float dist = 0.0;
     cv::Point2f prev(path_[first_idx].x,path_[first_idx].y);
     ROS_INFO_THROTTLE(1.0, "first wp %f %f", prev.x,prev.y);
-  //  size_t i = path_->getWaypointIndex();
 
+    // corners of the segments that are checked
+    vector<cv::Point2f> corners(1, prev);
     for (size_t i = min(first_step, path_.size()-1); i < path_.size(); i += opt_.segment_step_size()) {
-   // for (size_t i = path_->getWaypointIndex(); i < path_.size(); i += opt_.segment_step_size()) {
         cv::Point2f b(path_[i].x, path_[i].y);
         dist += cv::norm(b-prev);
         prev = b;
@@ -278,6 +356,52 @@ std::list<cv::Point2f> PathLookout::findObstaclesInCloud(const std::shared_ptr<O
             ROS_INFO_THROTTLE(1.0,"no obstacles");
             break;
         }
+        corners.push_back(b);
+    }
+    if (corners.size() < 2) {
+        return obstacle_points;
+    }
+
+    // bounding box of the corridor around the path
+    float min_x = corners[0].x, max_x = corners[0].x;
+    float min_y = corners[0].y, max_y = corners[0].y;
+    for (const cv::Point2f& c : corners) {
+        min_x = min(min_x, c.x);
+        max_x = max(max_x, c.x);
+        min_y = min(min_y, c.y);
+        max_y = max(max_y, c.y);
+    }
+    min_x -= radius;
+    min_y -= radius;
+    max_x += radius;
+    max_y += radius;
+
+    // transform only x and y of the points and drop everything outside of the corridor around the path
+    const tf::Matrix3x3& rot = trafo.getBasis();
+    const tf::Vector3& t = trafo.getOrigin();
+    cloud_points_.clear();
+    for (const ObstacleCloud::Cloud::PointType& pt : cloud->points) {
+        const float x = rot[0][0] * pt.x + rot[0][1] * pt.y + rot[0][2] * pt.z + t.x();
+        const float y = rot[1][0] * pt.x + rot[1][1] * pt.y + rot[1][2] * pt.z + t.y();
+        if (x >= min_x && x <= max_x && y >= min_y && y <= max_y) {
+            cloud_points_.emplace_back(x, y);
+        }
+    }
+    if (cloud_points_.empty()) {
+        return obstacle_points;
+    }
+
+    // a grid over the remaining points, so that each segment only checks the points near it
+    cloud_grid_.build(cloud_points_, std::max(radius, 0.1f), 4 * cloud_points_.size() + 64);
+
+    //! Contains an 'is obstacle' flag for each point in cloud_points_
+    is_point_obs_.assign(cloud_points_.size(), 0);
+
+    const float radius2 = radius * radius;
+    for (size_t s = 1; s < corners.size(); ++s) {
+        const cv::Point2f a = corners[s-1];
+        const cv::Point2f b = corners[s];
+
         /**
          * For each point, compute the distance of this point to the current path segment. If the distance is too small,
          * the corresponding field in is_point_obs is set to true (= this point is assumed to be an obstacle).
@@ -291,82 +415,35 @@ std::list<cv::Point2f> PathLookout::findObstaclesInCloud(const std::shared_ptr<O
          * If \lambda < 0:          dist = |\overrightarrow{AP}|
          * If \lambda > 0:          dist = |\overrightarrow{BP}|
          * If \lambda \in [0,1]:    dist = |\overrightarrow{FP}|,  where F = A + \lambda \cdot \overrightarrow{AB}
+         *
+         * Only the points in the grid cells overlapping the bounding box of the segment's corridor are checked.
          */
 
         // precompute AB and AB^2
         const cv::Point2f ab = b - a;
         const float ab2 = ab.dot(ab);
 
-        // check distance of each point
-        for (size_t i = 0; i < trans_cloud.size(); ++i) {
-            const cv::Point2f p(trans_cloud.at(i).x, trans_cloud.at(i).y);
+        cloud_grid_.forEachInBox(min(a.x, b.x) - radius, min(a.y, b.y) - radius,
+                                 max(a.x, b.x) + radius, max(a.y, b.y) + radius,
+                                 [&](std::uint32_t i) {
+            const cv::Point2f& p = cloud_points_[i];
             const cv::Point2f ap = p - a;
-            const float lambda = ap.dot(ab) / ab2;
-
-            float dist;
-            if (lambda < 0) {
-                // A is nearest point
-                dist = cv::norm(ap);
-            } else if (lambda > 1) {
-                // B is nearest point
-                dist = cv::norm(p - b);
-            } else {
-                // F is nearest point
-                cv::Point2f f = a + lambda * ab;
-                dist = cv::norm(p - f);
-            }
+            // a segment of length zero is a point
+            const float lambda = ab2 > 0.0f ? std::max(0.0f, std::min(1.0f, ap.dot(ab) / ab2)) : 0.0f;
 
-            if (dist < opt_.path_width()/2.0) {
-                is_point_obs[i] = true;
+            // F is the nearest point, F = A for lambda = 0 and F = B for lambda = 1
+            const cv::Point2f fp = ap - lambda * ab;
+            if (fp.dot(fp) < radius2) {
+                is_point_obs_[i] = 1;
             }
-        }
-
-        a = b;
+        });
     }
 
-    list<cv::Point2f> obstacle_points;
-    for (size_t i = 0; i < trans_cloud.size(); ++i) {
-        if (is_point_obs[i]) {
-            cv::Point2f p(trans_cloud.at(i).x, trans_cloud.at(i).y);
-            obstacle_points.push_back(p);
+    for (size_t i = 0; i < cloud_points_.size(); ++i) {
+        if (is_point_obs_[i]) {
+            obstacle_points.push_back(cloud_points_[i]);
         }
     }
 
     return obstacle_points;
 }
-
-std::list<std::list<cv::Point2f> > PathLookout::clusterPointsAlongAxis(std::list<cv::Point2f> points,
-                                                                       const float dist_threshold,
-                                                                       std::function<float (const cv::Point2f &)> get_value)
-{
-    auto dist = [&get_value](const cv::Point2f &a, const cv::Point2f &b) {
-        return abs(get_value(a) - get_value(b));
-    };
-
-    // sort points along axis   -> O(n log(n))
-    points.sort([&get_value](const cv::Point2f &a, const cv::Point2f &b) {
-        return get_value(a) < get_value(b);
-    });
-
-    list<list<cv::Point2f> > clusters;
-    list<cv::Point2f> current_cluster;
-
-    // add first point to the current cluster
-    auto p_it = points.cbegin();
-    current_cluster.push_back(*p_it);
-
-    // iterate over the remaining points
-    for (++p_it; p_it != points.end(); ++p_it) {
-        if (dist(current_cluster.back(), *p_it) > dist_threshold) {  // dist and `>` are O(1)
-            // start new cluster
-            clusters.push_back(std::move(current_cluster));          // O(1)
-            current_cluster.clear(); // clear has linear complexity, but after moving the
-                                     // content, the list is empty --> O(1)
-        }
-
-        current_cluster.push_back(*p_it);                            // O(1)
-    } // loop: O(n)
-    clusters.push_back(std::move(current_cluster));                  // O(1)
-
-    return clusters;
-}
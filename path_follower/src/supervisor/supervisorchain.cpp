@@ -1,19 +1,26 @@
 #include <path_follower/supervisor/supervisorchain.h>
 
+#include <nav_tracing/tracing.h>
+
 using namespace std;
 
 void SupervisorChain::addSupervisor(Supervisor::Ptr supervisor)
 {
     ROS_INFO("Use Supervisor '%s'", supervisor->getName().c_str());
     supervisors_.push_back(supervisor);
+    trace_names_.push_back(nav_tracing::Tracer::instance().intern("supervisor/" + supervisor->getName()));
 }
 
 Supervisor::Result SupervisorChain::supervise(Supervisor::State &state)
 {
     list<Supervisor::Ptr>::iterator it;
-    for (it = supervisors_.begin(); it != supervisors_.end(); ++it) {
+    list<const char*>::const_iterator name = trace_names_.begin();
+    for (it = supervisors_.begin(); it != supervisors_.end(); ++it, ++name) {
         Supervisor::Result res;
-        (*it)->supervise(state, &res);
+        {
+            nav_tracing::Span span(*name);
+            (*it)->supervise(state, &res);
+        }
 
         if (!res.can_continue) {
             return res;
@@ -1,5 +1,11 @@
 #include <path_follower/utils/cubic_spline_interpolation.h>
 
+#include <cmath>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 // band_matrix implementation
 // -------------------------
 
@@ -140,7 +146,8 @@ std::vector<double> band_matrix::lu_solve(const std::vector<double>& b,
 
 void spline::set_points(const std::vector<double>& x,
                         const std::vector<double>& y,
-                        bool cubic_spline) {
+                        bool cubic_spline,
+                        bd_type boundary) {
    assert(x.size()==y.size());
    m_x=x;
    m_y=y;
@@ -161,13 +168,23 @@ void spline::set_points(const std::vector<double>& x,
          A(i,i+1)=1.0/3.0*(x[i+1]-x[i]);
          rhs[i]=(y[i+1]-y[i])/(x[i+1]-x[i]) - (y[i]-y[i-1])/(x[i]-x[i-1]);
       }
-      // boundary conditions, zero curvature b[0]=b[n-1]=0
-      A(0,0)=2.0;
-      A(0,1)=0.0;
-      rhs[0]=0.0;
-      A(n-1,n-1)=2.0;
-      A(n-1,n-2)=0.0;
-      rhs[n-1]=0.0;
+      if(boundary==parabolic && n>2) {
+         // boundary conditions, parabolic end segments b[0]=b[1], b[n-1]=b[n-2]
+         A(0,0)=1.0;
+         A(0,1)=-1.0;
+         rhs[0]=0.0;
+         A(n-1,n-1)=1.0;
+         A(n-1,n-2)=-1.0;
+         rhs[n-1]=0.0;
+      } else {
+         // boundary conditions, zero curvature b[0]=b[n-1]=0
+         A(0,0)=2.0;
+         A(0,1)=0.0;
+         rhs[0]=0.0;
+         A(n-1,n-1)=2.0;
+         A(n-1,n-2)=0.0;
+         rhs[n-1]=0.0;
+      }
 
       // solve the equation system to obtain the parameters b[]
       m_b=A.lu_solve(rhs);
@@ -220,3 +237,207 @@ double spline::operator() (double x) const {
    }
    return interpol;
 }
+
+
+
+// spline_curve implementation
+// ---------------------------
+
+namespace {
+
+// samples are evaluated in blocks, so the gathered coefficients stay in the cache
+const std::size_t EVAL_BLOCK = 256;
+
+// minimal SIMD abstraction for the evaluation kernel, scalar is used for the remainder
+template <typename T>
+struct scalar {
+   typedef T v;
+   static const std::size_t lanes = 1;
+   static v load(const T* p) { return *p; }
+   static void store(T* p, v a) { *p = a; }
+   static v set1(T a) { return a; }
+   static v add(v a, v b) { return a + b; }
+   static v sub(v a, v b) { return a - b; }
+   static v mul(v a, v b) { return a * b; }
+   static v div(v a, v b) { return a / b; }
+   static v sqrt(v a) { return std::sqrt(a); }
+};
+
+template <typename T> struct simd;
+
+#if defined(__AVX__)
+template <> struct simd<float> {
+   typedef __m256 v;
+   static const std::size_t lanes = 8;
+   static v load(const float* p) { return _mm256_loadu_ps(p); }
+   static void store(float* p, v a) { _mm256_storeu_ps(p, a); }
+   static v set1(float a) { return _mm256_set1_ps(a); }
+   static v add(v a, v b) { return _mm256_add_ps(a, b); }
+   static v sub(v a, v b) { return _mm256_sub_ps(a, b); }
+   static v mul(v a, v b) { return _mm256_mul_ps(a, b); }
+   static v div(v a, v b) { return _mm256_div_ps(a, b); }
+   static v sqrt(v a) { return _mm256_sqrt_ps(a); }
+};
+template <> struct simd<double> {
+   typedef __m256d v;
+   static const std::size_t lanes = 4;
+   static v load(const double* p) { return _mm256_loadu_pd(p); }
+   static void store(double* p, v a) { _mm256_storeu_pd(p, a); }
+   static v set1(double a) { return _mm256_set1_pd(a); }
+   static v add(v a, v b) { return _mm256_add_pd(a, b); }
+   static v sub(v a, v b) { return _mm256_sub_pd(a, b); }
+   static v mul(v a, v b) { return _mm256_mul_pd(a, b); }
+   static v div(v a, v b) { return _mm256_div_pd(a, b); }
+   static v sqrt(v a) { return _mm256_sqrt_pd(a); }
+};
+#elif defined(__SSE2__)
+template <> struct simd<float> {
+   typedef __m128 v;
+   static const std::size_t lanes = 4;
+   static v load(const float* p) { return _mm_loadu_ps(p); }
+   static void store(float* p, v a) { _mm_storeu_ps(p, a); }
+   static v set1(float a) { return _mm_set1_ps(a); }
+   static v add(v a, v b) { return _mm_add_ps(a, b); }
+   static v sub(v a, v b) { return _mm_sub_ps(a, b); }
+   static v mul(v a, v b) { return _mm_mul_ps(a, b); }
+   static v div(v a, v b) { return _mm_div_ps(a, b); }
+   static v sqrt(v a) { return _mm_sqrt_ps(a); }
+};
+template <> struct simd<double> {
+   typedef __m128d v;
+   static const std::size_t lanes = 2;
+   static v load(const double* p) { return _mm_loadu_pd(p); }
+   static void store(double* p, v a) { _mm_storeu_pd(p, a); }
+   static v set1(double a) { return _mm_set1_pd(a); }
+   static v add(v a, v b) { return _mm_add_pd(a, b); }
+   static v sub(v a, v b) { return _mm_sub_pd(a, b); }
+   static v mul(v a, v b) { return _mm_mul_pd(a, b); }
+   static v div(v a, v b) { return _mm_div_pd(a, b); }
+   static v sqrt(v a) { return _mm_sqrt_pd(a); }
+};
+#else
+template <typename T> struct simd : scalar<T> {};
+#endif
+
+// coefficients of the segment of every sample of a block, structure of arrays
+template <typename T>
+struct segment_block {
+   T h[EVAL_BLOCK];                       // offset to the segment start
+   T pa[EVAL_BLOCK], pb[EVAL_BLOCK], pc[EVAL_BLOCK], pd[EVAL_BLOCK];
+   T qa[EVAL_BLOCK], qb[EVAL_BLOCK], qc[EVAL_BLOCK], qd[EVAL_BLOCK];
+};
+
+// f = ((a*h + b)*h + c)*h + d, f' = (3*a*h + 2*b)*h + c, f'' = 6*a*h + 2*b
+template <typename S>
+inline void eval_cubic(typename S::v h, typename S::v a, typename S::v b,
+                       typename S::v c, typename S::v d,
+                       typename S::v& f, typename S::v& f_prim, typename S::v& f_sek) {
+   const typename S::v two = S::set1(2), three = S::set1(3), six = S::set1(6);
+   f = S::add(S::mul(S::add(S::mul(S::add(S::mul(a, h), b), h), c), h), d);
+   f_prim = S::add(S::mul(S::add(S::mul(S::mul(three, a), h), S::mul(two, b)), h), c);
+   f_sek = S::add(S::mul(S::mul(six, a), h), S::mul(two, b));
+}
+
+// kappa = (p'*q'' - p''*q') / |(p', q')|^3
+template <typename S>
+inline typename S::v eval_curvature(typename S::v p_prim, typename S::v q_prim,
+                                    typename S::v p_sek, typename S::v q_sek) {
+   typename S::v num = S::sub(S::mul(p_prim, q_sek), S::mul(p_sek, q_prim));
+   typename S::v v2 = S::add(S::mul(p_prim, p_prim), S::mul(q_prim, q_prim));
+   return S::div(num, S::mul(v2, S::sqrt(v2)));
+}
+
+template <typename T, typename S>
+void eval_block(const segment_block<T>& c, std::size_t begin, std::size_t end,
+                curve_samples<T>& out, std::size_t offset) {
+   typedef typename S::v V;
+   for(std::size_t i=begin; i+S::lanes<=end; i+=S::lanes) {
+      V h=S::load(c.h+i);
+      V p, p_prim, p_sek, q, q_prim, q_sek;
+      eval_cubic<S>(h, S::load(c.pa+i), S::load(c.pb+i), S::load(c.pc+i), S::load(c.pd+i),
+                    p, p_prim, p_sek);
+      eval_cubic<S>(h, S::load(c.qa+i), S::load(c.qb+i), S::load(c.qc+i), S::load(c.qd+i),
+                    q, q_prim, q_sek);
+
+      const std::size_t o=offset+i;
+      S::store(&out.p[o], p);
+      S::store(&out.q[o], q);
+      S::store(&out.p_prim[o], p_prim);
+      S::store(&out.q_prim[o], q_prim);
+      S::store(&out.p_sek[o], p_sek);
+      S::store(&out.q_sek[o], q_sek);
+      S::store(&out.curvature[o], eval_curvature<S>(p_prim, q_prim, p_sek, q_sek));
+   }
+}
+
+} // namespace
+
+
+template <typename T>
+void curve_samples<T>::resize(std::size_t n) {
+   p.resize(n);
+   q.resize(n);
+   p_prim.resize(n);
+   q_prim.resize(n);
+   p_sek.resize(n);
+   q_sek.resize(n);
+   curvature.resize(n);
+}
+
+void spline_curve::set_points(const std::vector<double>& s,
+                              const std::vector<double>& p,
+                              const std::vector<double>& q,
+                              spline::bd_type boundary) {
+   m_p.set_points(s, p, true, boundary);
+   m_q.set_points(s, q, true, boundary);
+}
+
+template <typename T>
+void spline_curve::evaluate(const std::vector<T>& s, curve_samples<T>& out) const {
+   const std::vector<double>& x=m_p.m_x;
+   const std::size_t n=x.size();
+   const std::size_t m=s.size();
+   out.resize(m);
+   if(n==0) {
+      return;
+   }
+
+   segment_block<T> block;
+   std::size_t below=0;                   // number of knots < s[i]
+   for(std::size_t begin=0; begin<m; begin+=EVAL_BLOCK) {
+      const std::size_t count=std::min(EVAL_BLOCK, m-begin);
+
+      // gather the coefficients, the same segment as in spline::operator()
+      for(std::size_t j=0; j<count; j++) {
+         const std::size_t i=begin+j;
+         const double si=s[i];
+         if(i==0 || si<s[i-1]) {
+            below=std::lower_bound(x.begin(),x.end(),si)-x.begin();
+         } else {
+            while(below<n && x[below]<si) below++;
+         }
+         const std::size_t idx=below>0 ? below-1 : 0;
+         // extrapolation to the left is quadratic
+         const bool left=si<x[0];
+
+         block.h[j]=T(si-x[idx]);
+         block.pa[j]=left ? T(0) : T(m_p.m_a[idx]);
+         block.pb[j]=T(m_p.m_b[idx]);
+         block.pc[j]=T(m_p.m_c[idx]);
+         block.pd[j]=T(m_p.m_y[idx]);
+         block.qa[j]=left ? T(0) : T(m_q.m_a[idx]);
+         block.qb[j]=T(m_q.m_b[idx]);
+         block.qc[j]=T(m_q.m_c[idx]);
+         block.qd[j]=T(m_q.m_y[idx]);
+      }
+
+      const std::size_t vectorized=count-count%simd<T>::lanes;
+      eval_block<T, simd<T> >(block, 0, vectorized, out, begin);
+      eval_block<T, scalar<T> >(block, vectorized, count, out, begin);
+   }
+}
+
+template struct curve_samples<float>;
+template struct curve_samples<double>;
+template void spline_curve::evaluate<float>(const std::vector<float>&, curve_samples<float>&) const;
+template void spline_curve::evaluate<double>(const std::vector<double>&, curve_samples<double>&) const;
@@ -0,0 +1,110 @@
+#include <path_follower/utils/obstacle_distance_grid.h>
+
+#include <algorithm>
+
+namespace {
+//! Upper bound of the cells along each axis
+const int MAX_SIZE = 512;
+
+/**
+ * @brief Squared euclidean distance transform of one line (Felzenszwalb and Huttenlocher),
+ *        f holds 0 for occupied and infinity for free cells.
+ */
+void transformLine(const float* f, int n, float* d, int* v, float* z)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+
+    // lower envelope of the parabolas rooted at the occupied cells
+    int k = -1;
+    for(int q = 0; q < n; ++q) {
+        if(f[q] == inf) {
+            continue;
+        }
+        float s = -inf;
+        while(k >= 0) {
+            const int p = v[k];
+            s = ((f[q] + q * q) - (f[p] + p * p)) / (2.0f * (q - p));
+            if(s > z[k]) {
+                break;
+            }
+            --k;
+        }
+        ++k;
+        v[k] = q;
+        z[k] = k == 0 ? -inf : s;
+    }
+
+    if(k < 0) {
+        std::fill(d, d + n, inf);
+        return;
+    }
+
+    int j = 0;
+    for(int q = 0; q < n; ++q) {
+        while(j < k && z[j + 1] < q) {
+            ++j;
+        }
+        const float dq = q - v[j];
+        d[q] = dq * dq + f[v[j]];
+    }
+}
+}
+
+ObstacleDistanceGrid::ObstacleDistanceGrid()
+    : origin_x_(0), origin_y_(0), resolution_(1), size_(0)
+{
+}
+
+void ObstacleDistanceGrid::build(const std::vector<cv::Point2f> &points, const cv::Point2f &center, float radius,
+                                 float max_distance, float resolution)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+
+    const float half = radius + max_distance;
+    resolution_ = std::max(resolution, 2.0f * half / MAX_SIZE);
+    size_ = std::max(1, static_cast<int>(std::ceil(2.0f * half / resolution_)));
+    origin_x_ = center.x - 0.5f * size_ * resolution_;
+    origin_y_ = center.y - 0.5f * size_ * resolution_;
+
+    distance_.assign(size_ * size_, inf);
+    bool any = false;
+    for(const cv::Point2f& pt : points) {
+        int cx = static_cast<int>(std::floor((pt.x - origin_x_) / resolution_));
+        int cy = static_cast<int>(std::floor((pt.y - origin_y_) / resolution_));
+        if(cx >= 0 && cy >= 0 && cx < size_ && cy < size_) {
+            distance_[cy * size_ + cx] = 0.0f;
+            any = true;
+        }
+    }
+    if(!any) {
+        return;
+    }
+
+    line_.resize(size_);
+    line_out_.resize(size_);
+    parabola_.resize(size_);
+    boundary_.resize(size_);
+
+    // rows, then columns
+    for(int y = 0; y < size_; ++y) {
+        float* row = &distance_[y * size_];
+        std::copy(row, row + size_, line_.begin());
+        transformLine(line_.data(), size_, row, parabola_.data(), boundary_.data());
+    }
+    for(int x = 0; x < size_; ++x) {
+        for(int y = 0; y < size_; ++y) {
+            line_[y] = distance_[y * size_ + x];
+        }
+        transformLine(line_.data(), size_, line_out_.data(), parabola_.data(), boundary_.data());
+        for(int y = 0; y < size_; ++y) {
+            distance_[y * size_ + x] = line_out_[y];
+        }
+    }
+
+    for(float& d : distance_) {
+        d = std::sqrt(d) * resolution_;
+        if(d > max_distance) {
+            d = inf;
+        }
+    }
+}
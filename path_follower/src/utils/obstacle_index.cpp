@@ -0,0 +1,67 @@
+#include <path_follower/utils/obstacle_index.h>
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+#include <cmath>
+#include <limits>
+
+namespace {
+//! Edge length of the grid cells in m
+const float CELL_SIZE = 0.25f;
+}
+
+void ObstacleIndex::update(const ObstacleCloud::ConstPtr &obstacles)
+{
+    if(obstacles == obstacles_) {
+        return;
+    }
+    obstacles_ = obstacles;
+
+    points_.clear();
+    z_.clear();
+    if(obstacles && obstacles->cloud) {
+        for(const pcl::PointXYZ& pt : *obstacles->cloud) {
+            if(std::isfinite(pt.x) && std::isfinite(pt.y) && std::isfinite(pt.z)) {
+                points_.emplace_back(pt.x, pt.y);
+                z_.push_back(pt.z);
+            }
+        }
+    }
+    grid_.build(points_, CELL_SIZE, 4 * points_.size() + 64);
+}
+
+bool ObstacleIndex::nearest(const Eigen::Vector3d &query, Eigen::Vector3d &result) const
+{
+    if(points_.empty()) {
+        return false;
+    }
+
+    double best_dist2 = std::numeric_limits<double>::infinity();
+    std::uint32_t best = 0;
+    auto visit = [&](std::uint32_t i) {
+        const double dx = points_[i].x - query.x();
+        const double dy = points_[i].y - query.y();
+        const double dz = z_[i] - query.z();
+        const double d2 = dx*dx + dy*dy + dz*dz;
+        if(d2 < best_dist2) {
+            best_dist2 = d2;
+            best = i;
+        }
+    };
+
+    // search growing boxes, all points within <radius> in the plane are visited. As the planar distance
+    // is a lower bound of the 3d distance, the search is done if the best distance is within the radius.
+    for(double radius = grid_.cellSize();; radius *= 2.0) {
+        grid_.forEachInBox(query.x() - radius, query.y() - radius, query.x() + radius, query.y() + radius, visit);
+
+        const bool covers_grid = grid_.cellX(query.x() - radius) <= 0 && grid_.cellY(query.y() - radius) <= 0 &&
+                grid_.cellX(query.x() + radius) >= grid_.width() - 1 && grid_.cellY(query.y() + radius) >= grid_.height() - 1;
+        if(best_dist2 <= radius * radius || covers_grid) {
+            break;
+        }
+    }
+
+    result = Eigen::Vector3d(points_[best].x, points_[best].y, z_[best]);
+    return true;
+}
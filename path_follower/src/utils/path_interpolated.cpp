@@ -8,13 +8,35 @@
 
 // SYSTEM
 #include <deque>
+#include <limits>
 #include <nav_msgs/Path.h>
-#pragma GCC diagnostic ignored "-Wignored-qualifiers"
-#include <interpolation.h>
-#pragma GCC diagnostic pop
 
 using namespace Eigen;
 
+namespace {
+/**
+ * @brief evaluateCurve samples the curve at <s> with precision T and stores the samples as double.
+ */
+template <typename T>
+void evaluateCurve(const spline_curve& curve, const std::vector<double>& s,
+                   std::vector<double>& p, std::vector<double>& q,
+                   std::vector<double>& p_prim, std::vector<double>& q_prim,
+                   std::vector<double>& p_sek, std::vector<double>& q_sek,
+                   std::vector<double>& curvature)
+{
+    curve_samples<T> samples;
+    curve.evaluate(std::vector<T>(s.begin(), s.end()), samples);
+
+    p.assign(samples.p.begin(), samples.p.end());
+    q.assign(samples.q.begin(), samples.q.end());
+    p_prim.assign(samples.p_prim.begin(), samples.p_prim.end());
+    q_prim.assign(samples.q_prim.begin(), samples.q_prim.end());
+    p_sek.assign(samples.p_sek.begin(), samples.p_sek.end());
+    q_sek.assign(samples.q_sek.begin(), samples.q_sek.end());
+    curvature.assign(samples.curvature.begin(), samples.curvature.end());
+}
+}
+
 PathInterpolated::PathInterpolated()
     : frame_id_(PathFollowerParameters::getInstance()->world_frame()),
       N_(0),
@@ -78,11 +100,7 @@ void PathInterpolated::interpolatePath(const Path::Ptr path, const bool hack) {
     // why?? limits the number of subpathes to 2!?
     //path->reset();
 
-    try {
-        interpolatePath(waypoints);
-    } catch(const alglib::ap_error& error) {
-        throw std::runtime_error(error.msg);
-    }
+    interpolatePath(waypoints);
 }
 
 void PathInterpolated::interpolatePath(const SubPath& path, const std::string& frame_id){
@@ -108,7 +126,7 @@ void PathInterpolated::interpolatePath(const std::deque<Waypoint>& waypoints){
 		return;
 	}
 
-	double X_arr[N_], Y_arr[N_], l_arr[N_], l_arr_unif[N_];
+	std::vector<double> X_arr(N_), Y_arr(N_), l_arr(N_), l_arr_unif(N_);
 	double L = 0;
 
     X_arr[0] = waypoints[0].x;
@@ -139,6 +157,15 @@ void PathInterpolated::interpolatePath(const std::deque<Waypoint>& waypoints){
 	}
 //	ROS_INFO("Length of the path: %lf m", L);
 
+    if(N_ < 2) {
+        N_ = 0;
+        return;
+    }
+    X_arr.resize(N_);
+    Y_arr.resize(N_);
+    l_arr.resize(N_);
+    l_arr_unif.resize(N_);
+
 
 	double f = std::max(0.0001, L / (double) (N_-1));
 
@@ -148,44 +175,25 @@ void PathInterpolated::interpolatePath(const std::deque<Waypoint>& waypoints){
 
 	}
 
-	//initialization before the interpolation
-	alglib::real_1d_array X_alg, Y_alg, l_alg, l_alg_unif;
-	alglib::real_1d_array x_s, y_s, x_s_prim, y_s_prim, x_s_sek, y_s_sek;
-
-	X_alg.setcontent(N_, X_arr);
-	Y_alg.setcontent(N_, Y_arr);
-	l_alg.setcontent(N_, l_arr);
-	l_alg_unif.setcontent(N_, l_arr_unif);
-
-
-	//interpolate the path and find the derivatives
-    try {
-        alglib::spline1dconvdiff2cubic(l_alg, X_alg, l_alg_unif, x_s, x_s_prim, x_s_sek);
-        alglib::spline1dconvdiff2cubic(l_alg, Y_alg, l_alg_unif, y_s, y_s_prim, y_s_sek);
+    //interpolate the path with parabolically terminated splines and find the derivatives and the curvature
+    spline_curve curve;
+    curve.set_points(l_arr, X_arr, Y_arr, spline::parabolic);
 
-    } catch(const alglib::ap_error& error) {
-        ROS_FATAL_STREAM("alglib error: " << error.msg);
-        throw std::runtime_error(error.msg);
+    s_ = l_arr_unif;
+    if(PathFollowerParameters::getInstance()->interpolation_single_precision()) {
+        evaluateCurve<float>(curve, l_arr_unif, p_, q_, p_prim_, q_prim_, p_sek_, q_sek_, curvature_);
+    } else {
+        evaluateCurve<double>(curve, l_arr_unif, p_, q_, p_prim_, q_prim_, p_sek_, q_sek_, curvature_);
     }
 
-	//define path components, its derivatives, and curvilinear abscissa, then calculate the path curvature
-	for(uint i = 0; i < N_; ++i) {
-
-		s_.push_back(l_arr_unif[i]);
-
-		p_.push_back(x_s[i]);
-		q_.push_back(y_s[i]);
-
-		p_prim_.push_back(x_s_prim[i]);
-		q_prim_.push_back(y_s_prim[i]);
-
-		p_sek_.push_back(x_s_sek[i]);
-		q_sek_.push_back(y_s_sek[i]);
-
-		curvature_.push_back((x_s_prim[i]*y_s_sek[i] - x_s_sek[i]*y_s_prim[i])/
-									(sqrt(pow((x_s_prim[i]*x_s_prim[i] + y_s_prim[i]*y_s_prim[i]), 3))));
-
-	}
+    curvature_abs_sum_.assign(N_ + 1, 0.0);
+    curvature_invalid_count_.assign(N_ + 1, 0);
+    for(std::size_t i = 0; i < N_; ++i) {
+        const double k = std::abs(curvature_[i]);
+        const bool valid = std::isfinite(k);
+        curvature_abs_sum_[i + 1] = curvature_abs_sum_[i] + (valid ? k : 0.0);
+        curvature_invalid_count_[i + 1] = curvature_invalid_count_[i] + (valid ? 0 : 1);
+    }
 
 	assert(p_prim_.size() == N_);
 	assert(q_prim_.size() == N_);
@@ -219,6 +227,41 @@ double PathInterpolated::curvature_sek(const unsigned int i) const {
 	return (curvature_prim(i_1) - curvature_prim(i_0)) / (s(i_1) - s(i_0));
 }
 
+unsigned int PathInterpolated::index_ahead(const unsigned int i, const double distance) const {
+    const unsigned int last = n() - 1;
+    if(n() < 2 || i >= last) {
+        return std::min(i, last);
+    }
+    if(!(distance > 0.0)) {
+        return i + 1;
+    }
+
+    auto reached = [this, i, distance](unsigned int j) {
+        return s_[j] - s_[i] >= distance;
+    };
+
+    // estimate from the uniform sampling, then correct for rounding
+    const double estimate = i + std::ceil(distance / (s_[1] - s_[0]));
+    unsigned int j = estimate >= last ? last : std::max(i + 1, (unsigned int) estimate);
+    while(j > i + 1 && reached(j - 1)) {
+        --j;
+    }
+    while(j < last && !reached(j)) {
+        ++j;
+    }
+    return j;
+}
+
+double PathInterpolated::curvature_abs_sum(const unsigned int first, const unsigned int last) const {
+    if(first > last || last >= n()) {
+        return 0.;
+    }
+    if(curvature_invalid_count_[last + 1] != curvature_invalid_count_[first]) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return curvature_abs_sum_[last + 1] - curvature_abs_sum_[first];
+}
+
 PathInterpolated::operator nav_msgs::Path() const {
 
 	nav_msgs::Path path;
@@ -276,6 +319,8 @@ void PathInterpolated::clearBuffers() {
 	s_prim_ = 0;
 
 	curvature_.clear();
+	curvature_abs_sum_.clear();
+	curvature_invalid_count_.clear();
 
 	interp_path.poses.clear();
 }
@@ -0,0 +1,61 @@
+#include <path_follower/utils/path_smoother.h>
+
+// same solver as path_planner/src/path_smoother.cpp
+
+bool PathSmoother::smooth(std::vector<double>& x, std::vector<double>& y, double weight_data, double weight_smooth, int fixed)
+{
+    int n = x.size();
+    int first = fixed;
+    int last = n - fixed;
+    if(weight_data <= 0.0 || weight_smooth < 0.0 || weight_smooth >= 0.5) {
+        // the iterative smoothing has no stable fixed point for these weights
+        return false;
+    }
+    if(last <= first || fixed < 1) {
+        return true;
+    }
+
+    const double a = weight_data * (1.0 - 2.0 * weight_smooth);
+    const double b = weight_smooth;
+    const double diag = a + 2.0 * b;
+
+    // forward sweep, the coefficients are the same for x and y
+    int m = last - first;
+    std::vector<double> c(m);
+    std::vector<double> dx(m);
+    std::vector<double> dy(m);
+
+    double denom = diag;
+    c[0] = -b / denom;
+    dx[0] = (a * x[first] + b * x[first - 1]) / denom;
+    dy[0] = (a * y[first] + b * y[first - 1]) / denom;
+
+    for(int k = 1; k < m; ++k) {
+        int i = first + k;
+        double rx = a * x[i];
+        double ry = a * y[i];
+        if(k == m - 1) {
+            rx += b * x[last];
+            ry += b * y[last];
+        }
+
+        denom = diag + b * c[k - 1];
+        c[k] = -b / denom;
+        dx[k] = (rx + b * dx[k - 1]) / denom;
+        dy[k] = (ry + b * dy[k - 1]) / denom;
+    }
+    if(m == 1) {
+        dx[0] += b * x[last] / diag;
+        dy[0] += b * y[last] / diag;
+    }
+
+    // back substitution
+    x[last - 1] = dx[m - 1];
+    y[last - 1] = dy[m - 1];
+    for(int k = m - 2; k >= 0; --k) {
+        x[first + k] = dx[k] - c[k] * x[first + k + 1];
+        y[first + k] = dy[k] - c[k] * y[first + k + 1];
+    }
+
+    return true;
+}
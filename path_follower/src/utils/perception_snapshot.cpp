@@ -0,0 +1,41 @@
+#include <path_follower/utils/perception_snapshot.h>
+
+#include <atomic>
+
+PerceptionInputs::PerceptionInputs()
+    : current_(std::make_shared<PerceptionSnapshot>())
+{
+}
+
+PerceptionSnapshot::ConstPtr PerceptionInputs::snapshot() const
+{
+    return std::atomic_load(&current_);
+}
+
+template <typename Modify>
+void PerceptionInputs::update(Modify modify)
+{
+    PerceptionSnapshot::ConstPtr current = std::atomic_load(&current_);
+    PerceptionSnapshot::ConstPtr next;
+    do {
+        auto copy = std::make_shared<PerceptionSnapshot>(*current);
+        copy->generation = current->generation + 1;
+        modify(*copy);
+        next = copy;
+        // on failure, current is reloaded and the copy is made again
+    } while(!std::atomic_compare_exchange_weak(&current_, &current, next));
+}
+
+void PerceptionInputs::setObstacleCloud(const std::shared_ptr<ObstacleCloud const> &cloud)
+{
+    update([&cloud](PerceptionSnapshot& s) {
+        s.obstacle_cloud = cloud;
+    });
+}
+
+void PerceptionInputs::setElevationMap(const std::shared_ptr<ElevationMap const> &map)
+{
+    update([&map](PerceptionSnapshot& s) {
+        s.elevation_map = map;
+    });
+}
@@ -0,0 +1,70 @@
+#include <path_follower/utils/point_grid.h>
+
+#include <limits>
+
+PointGrid::PointGrid()
+    : cell_size_(1.0f),
+      origin_x_(0.0f),
+      origin_y_(0.0f),
+      width_(0),
+      height_(0)
+{
+}
+
+void PointGrid::build(const std::vector<cv::Point2f> &points, float cell_size, std::size_t max_cells)
+{
+    indices_.resize(points.size());
+    cell_of_point_.resize(points.size());
+
+    if(points.empty()) {
+        width_ = height_ = 0;
+        cell_start_.assign(1, 0);
+        return;
+    }
+
+    float min_x = std::numeric_limits<float>::infinity();
+    float min_y = min_x;
+    float max_x = -min_x;
+    float max_y = -min_x;
+    for(const cv::Point2f& p : points) {
+        min_x = std::min(min_x, p.x);
+        min_y = std::min(min_y, p.y);
+        max_x = std::max(max_x, p.x);
+        max_y = std::max(max_y, p.y);
+    }
+
+    // enlarge the cells until the grid is small enough
+    max_cells = std::max<std::size_t>(max_cells, 1);
+    cell_size_ = std::max(cell_size, 1e-4f);
+    while(true) {
+        double w = std::floor((max_x - min_x) / cell_size_) + 1.0;
+        double h = std::floor((max_y - min_y) / cell_size_) + 1.0;
+        if(w * h <= max_cells) {
+            width_ = static_cast<int>(w);
+            height_ = static_cast<int>(h);
+            break;
+        }
+        cell_size_ *= std::sqrt(w * h / max_cells) * 1.01f;
+    }
+    origin_x_ = min_x;
+    origin_y_ = min_y;
+
+    // counting sort of the point indices by cell
+    const std::size_t cells = static_cast<std::size_t>(width_) * height_;
+    cell_start_.assign(cells + 1, 0);
+    for(std::size_t i = 0; i < points.size(); ++i) {
+        int cx = std::min(width_ - 1, cellX(points[i].x));
+        int cy = std::min(height_ - 1, cellY(points[i].y));
+        std::uint32_t c = cy * width_ + cx;
+        cell_of_point_[i] = c;
+        ++cell_start_[c];
+    }
+    for(std::size_t c = 1; c < cells; ++c) {
+        cell_start_[c] += cell_start_[c - 1];
+    }
+    cell_start_[cells] = points.size();
+    // cell_start_[c] is the end of cell c now, filling from the back moves it to the begin
+    for(std::size_t i = points.size(); i-- > 0;) {
+        indices_[--cell_start_[cell_of_point_[i]]] = i;
+    }
+}
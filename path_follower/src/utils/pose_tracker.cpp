@@ -3,14 +3,57 @@
 
 /// PROJECT
 #include <path_follower/parameters/path_follower_parameters.h>
+#include <nav_tracing/tracing.h>
+#include <cslibs_navigation_utilities/MathHelper.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <cmath>
 
 using namespace Eigen;
 
+namespace {
+//! upper bound of frame pairs in the snapshot, so that lookups of arbitrary frames cannot make the refresh expensive
+const std::size_t MAX_SNAPSHOT_ENTRIES = 32;
+//! upper bound of the prediction horizon in s, a stale pose is not extrapolated any further
+const double MAX_PREDICTION_HORIZON = 0.5;
+}
+
+PoseTracker::Tick::Tick(PoseTracker &tracker)
+    : tracker_(tracker)
+{
+    tracker_.beginTick();
+}
+
+PoseTracker::Tick::~Tick()
+{
+    tracker_.endTick();
+}
+
+PoseTracker::Prediction::Prediction(PoseTracker &tracker, bool enabled, const ros::Time &actuation_time)
+    : tracker_(tracker),
+      enabled_(enabled)
+{
+    if(enabled_) {
+        tracker_.beginPrediction(actuation_time);
+    }
+}
+
+PoseTracker::Prediction::~Prediction()
+{
+    if(enabled_) {
+        tracker_.endPrediction();
+    }
+}
+
 PoseTracker::PoseTracker(const PathFollowerParameters &opt, ros::NodeHandle& nh)
     : opt_(opt),
-      local_(false)
+      prediction_active_(false),
+      local_(false),
+      snapshot_active_(false)
 {
     odom_sub_ = nh.subscribe<nav_msgs::Odometry>("odom", 1, &PoseTracker::odometryCB, this);
+    resetCacheStatistics();
 }
 
 bool PoseTracker::isLocal() const
@@ -40,7 +83,12 @@ std::string PoseTracker::getRobotFrameId() const
 
 void PoseTracker::odometryCB(const nav_msgs::OdometryConstPtr &odom)
 {
-    odometry_ = *odom;
+    setOdometry(*odom);
+}
+
+void PoseTracker::setOdometry(const nav_msgs::Odometry &odom)
+{
+    odometry_ = odom;
 
     robot_pose_odom_msg_ = odometry_.pose.pose;
 
@@ -52,7 +100,7 @@ void PoseTracker::odometryCB(const nav_msgs::OdometryConstPtr &odom)
 
 bool PoseTracker::updateRobotPose()
 {
-    if (getWorldPose(&robot_pose_world_, &robot_pose_world_msg_)) {
+    if (getWorldPose(&robot_pose_world_, &robot_pose_world_msg_, &robot_pose_world_stamp_)) {
         return true;
     } else {
         return false;
@@ -64,17 +112,200 @@ tf::TransformListener& PoseTracker::getTransformListener()
     return pose_listener_;
 }
 
-bool PoseTracker::getWorldPose(Vector3d *pose_vec , geometry_msgs::Pose *pose_msg) const
+void PoseTracker::beginTick()
+{
+    if(!opt_.tf_snapshot()) {
+        return;
+    }
+
+    NAV_TRACE_SCOPE("pose_tracker/snapshot");
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if(snapshot_.empty()) {
+        snapshot_.push_back({opt_.world_frame(), opt_.robot_frame(), tf::StampedTransform(), false});
+        snapshot_.push_back({opt_.odom_frame(), opt_.robot_frame(), tf::StampedTransform(), false});
+        snapshot_.push_back({opt_.world_frame(), opt_.odom_frame(), tf::StampedTransform(), false});
+    }
+
+    for(SnapshotEntry& entry : snapshot_) {
+        try {
+            pose_listener_.lookupTransform(entry.target_frame, entry.source_frame, ros::Time(0), entry.trafo);
+            entry.valid = true;
+        } catch(const tf::TransformException& ex) {
+            (void) ex;
+            entry.valid = false;
+        }
+    }
+
+    snapshot_active_ = true;
+}
+
+void PoseTracker::endTick()
+{
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if(snapshot_active_) {
+        ROS_DEBUG_STREAM_THROTTLE_NAMED(5, "tf_snapshot", "tf snapshot: " << statistics_.hits << " hits, " << statistics_.misses
+                                        << " misses, " << statistics_.wait_ms << " ms in tf (max " << statistics_.max_wait_ms << " ms)");
+    }
+    snapshot_active_ = false;
+}
+
+void PoseTracker::beginPrediction(const ros::Time &actuation_time)
+{
+    Eigen::Vector3d pose = local_ ? robot_pose_odom_ : robot_pose_world_;
+    ros::Time stamp = local_ ? odometry_.header.stamp : robot_pose_world_stamp_;
+
+    // without a stamp the age of the pose is unknown, only the actuation delay is compensated then
+    double dt = stamp.isZero() ? (actuation_time - ros::Time::now()).toSec() : (actuation_time - stamp).toSec();
+    dt = std::max(0.0, std::min(dt, MAX_PREDICTION_HORIZON));
+
+    robot_pose_predicted_ = extrapolate(pose, odometry_.twist.twist, dt);
+
+    robot_pose_predicted_msg_ = local_ ? robot_pose_odom_msg_ : robot_pose_world_msg_;
+    robot_pose_predicted_msg_.position.x = robot_pose_predicted_.x();
+    robot_pose_predicted_msg_.position.y = robot_pose_predicted_.y();
+    robot_pose_predicted_msg_.orientation = tf::createQuaternionMsgFromYaw(robot_pose_predicted_(2));
+
+    prediction_active_ = true;
+}
+
+void PoseTracker::endPrediction()
+{
+    prediction_active_ = false;
+}
+
+Eigen::Vector3d PoseTracker::extrapolate(const Eigen::Vector3d &pose, const geometry_msgs::Twist &twist, double dt)
+{
+    const double vx = twist.linear.x;
+    const double vy = twist.linear.y;
+    const double w = twist.angular.z;
+    const double dtheta = w * dt;
+
+    // displacement in the frame of <pose>, integrated exactly along the arc of a constant twist
+    double dx, dy;
+    if(std::abs(dtheta) < 1e-6) {
+        dx = vx * dt;
+        dy = vy * dt;
+    } else {
+        const double s = std::sin(dtheta);
+        const double c = std::cos(dtheta);
+        dx = (vx * s + vy * (c - 1.0)) / w;
+        dy = (vx * (1.0 - c) + vy * s) / w;
+    }
+
+    const double cos_t = std::cos(pose(2));
+    const double sin_t = std::sin(pose(2));
+    return Eigen::Vector3d(pose.x() + cos_t * dx - sin_t * dy,
+                           pose.y() + sin_t * dx + cos_t * dy,
+                           MathHelper::NormalizeAngle(pose(2) + dtheta));
+}
+
+PoseTracker::CacheStatistics PoseTracker::getCacheStatistics() const
+{
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    return statistics_;
+}
+
+void PoseTracker::resetCacheStatistics()
+{
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    statistics_.hits = 0;
+    statistics_.misses = 0;
+    statistics_.wait_ms = 0.0;
+    statistics_.max_wait_ms = 0.0;
+}
+
+bool PoseTracker::lookupSnapshot(const std::string &target_frame, const std::string &source_frame, const ros::Time &time,
+                                 tf::StampedTransform &trafo) const
+{
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if(!snapshot_active_) {
+        return false;
+    }
+
+    for(const SnapshotEntry& entry : snapshot_) {
+        bool same = entry.target_frame == target_frame && entry.source_frame == source_frame;
+        bool inverse = entry.target_frame == source_frame && entry.source_frame == target_frame;
+        if(!same && !inverse) {
+            continue;
+        }
+
+        // the snapshot is the latest transform, it cannot answer requests for older times
+        if(!entry.valid || (!time.isZero() && (entry.trafo.stamp_ - time).toSec() > opt_.tf_snapshot_tolerance())) {
+            return false;
+        }
+
+        if(same) {
+            trafo = entry.trafo;
+        } else {
+            trafo = tf::StampedTransform(entry.trafo.inverse(), entry.trafo.stamp_, target_frame, source_frame);
+        }
+        ++statistics_.hits;
+        return true;
+    }
+    return false;
+}
+
+void PoseTracker::storeSnapshot(const std::string &target_frame, const std::string &source_frame, const ros::Time &time,
+                                const tf::StampedTransform &trafo) const
+{
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if(!snapshot_active_) {
+        return;
+    }
+
+    // results for older times are not stored, but the frames are refreshed from the next tick on
+    bool recent = time.isZero() || (ros::Time::now() - time).toSec() <= opt_.tf_snapshot_tolerance();
+
+    for(SnapshotEntry& entry : snapshot_) {
+        if(entry.target_frame == target_frame && entry.source_frame == source_frame) {
+            if(recent) {
+                entry.trafo = trafo;
+                entry.valid = true;
+            }
+            return;
+        }
+    }
+
+    if(snapshot_.size() < MAX_SNAPSHOT_ENTRIES) {
+        snapshot_.push_back({target_frame, source_frame, trafo, recent});
+    }
+}
+
+void PoseTracker::countMiss(std::uint64_t start_ns) const
+{
+    std::uint64_t end_ns = nav_tracing::Tracer::now();
+    nav_tracing::Tracer& tracer = nav_tracing::Tracer::instance();
+    if(tracer.isEnabled()) {
+        tracer.record("pose_tracker/tf_lookup", start_ns, end_ns - start_ns);
+    }
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if(snapshot_active_) {
+        double ms = (end_ns - start_ns) * 1e-6;
+        ++statistics_.misses;
+        statistics_.wait_ms += ms;
+        statistics_.max_wait_ms = std::max(statistics_.max_wait_ms, ms);
+    }
+}
+
+bool PoseTracker::getWorldPose(Vector3d *pose_vec , geometry_msgs::Pose *pose_msg, ros::Time* stamp) const
 {
     tf::StampedTransform transform;
     geometry_msgs::TransformStamped msg;
 
-    try {
-        pose_listener_.lookupTransform(opt_.world_frame(), opt_.robot_frame(), ros::Time(0), transform);
+    if(!lookupSnapshot(opt_.world_frame(), opt_.robot_frame(), ros::Time(0), transform)) {
+        std::uint64_t start = nav_tracing::Tracer::now();
+        try {
+            pose_listener_.lookupTransform(opt_.world_frame(), opt_.robot_frame(), ros::Time(0), transform);
 
-    } catch (tf::TransformException& ex) {
-        ROS_ERROR("error with transform robot pose: %s", ex.what());
-        return false;
+        } catch (tf::TransformException& ex) {
+            countMiss(start);
+            ROS_ERROR("error with transform robot pose: %s", ex.what());
+            return false;
+        }
+        countMiss(start);
+        storeSnapshot(opt_.world_frame(), opt_.robot_frame(), ros::Time(0), transform);
     }
     tf::transformStampedTFToMsg(transform, msg);
 
@@ -88,6 +319,9 @@ bool PoseTracker::getWorldPose(Vector3d *pose_vec , geometry_msgs::Pose *pose_ms
         pose_msg->position.z = msg.transform.translation.z;
         pose_msg->orientation = msg.transform.rotation;
     }
+    if(stamp != nullptr) {
+        *stamp = transform.stamp_;
+    }
     return true;
 }
 
@@ -108,6 +342,16 @@ bool PoseTracker::transformToLocal(const geometry_msgs::PoseStamped &global, Vec
 
 bool PoseTracker::transformToLocal(const geometry_msgs::PoseStamped &global_org, geometry_msgs::PoseStamped &local)
 {
+    tf::StampedTransform trafo;
+    if(lookupSnapshot(opt_.robot_frame(), getFixedFrameId(), ros::Time(0), trafo)) {
+        tf::Pose pose;
+        tf::poseMsgToTF(global_org.pose, pose);
+        tf::poseTFToMsg(trafo * pose, local.pose);
+        local.header.frame_id = opt_.robot_frame();
+        local.header.stamp = trafo.stamp_;
+        return true;
+    }
+
     geometry_msgs::PoseStamped global(global_org);
     try {
         global.header.frame_id = getFixedFrameId();
@@ -122,6 +366,16 @@ bool PoseTracker::transformToLocal(const geometry_msgs::PoseStamped &global_org,
 
 bool PoseTracker::transformToGlobal(const geometry_msgs::PoseStamped &local_org, geometry_msgs::PoseStamped &global)
 {
+    tf::StampedTransform trafo;
+    if(lookupSnapshot(getFixedFrameId(), opt_.robot_frame(), ros::Time(0), trafo)) {
+        tf::Pose pose;
+        tf::poseMsgToTF(local_org.pose, pose);
+        tf::poseTFToMsg(trafo * pose, global.pose);
+        global.header.frame_id = getFixedFrameId();
+        global.header.stamp = trafo.stamp_;
+        return true;
+    }
+
     geometry_msgs::PoseStamped local(local_org);
     try {
         local.header.frame_id=opt_.robot_frame();
@@ -141,7 +395,9 @@ geometry_msgs::Twist PoseTracker::getVelocity() const
 
 Eigen::Vector3d PoseTracker::getRobotPose() const
 {
-    if(!local_) {
+    if(prediction_active_) {
+        return robot_pose_predicted_;
+    } else if(!local_) {
         return robot_pose_world_;
     } else {
         return robot_pose_odom_;
@@ -150,7 +406,9 @@ Eigen::Vector3d PoseTracker::getRobotPose() const
 
 const geometry_msgs::Pose &PoseTracker::getRobotPoseMsg() const
 {
-    if(!local_) {
+    if(prediction_active_) {
+        return robot_pose_predicted_msg_;
+    } else if(!local_) {
         return robot_pose_world_msg_;
     } else {
         return robot_pose_odom_msg_;
@@ -166,18 +424,98 @@ tf::Transform PoseTracker::getTransformLatest(const std::string &fixed_frame, co
 {
     tf::StampedTransform trafo;
     ros::Time zero = ros::Time(0);
+    if(lookupSnapshot(fixed_frame, frame, zero, trafo)) {
+        return trafo;
+    }
+
+    std::uint64_t start = nav_tracing::Tracer::now();
     if(!pose_listener_.canTransform(fixed_frame, frame, zero)) {
+        countMiss(start);
         throw std::runtime_error(std::string("the transformation between ") + fixed_frame +
                                  " and " + frame + " does not exist.");
     }
 
     pose_listener_.lookupTransform(fixed_frame, frame, zero, trafo);
+    countMiss(start);
+    storeSnapshot(fixed_frame, frame, zero, trafo);
 
     return trafo;
 }
 
 
 tf::Transform PoseTracker::getTransform(const std::string &fixed_frame, const std::string &frame, const ros::Time &time, const ros::Duration& max_wait) const
+{
+    tf::StampedTransform trafo;
+    if(lookupSnapshot(fixed_frame, frame, time, trafo)) {
+        return trafo;
+    }
+
+    std::uint64_t start = nav_tracing::Tracer::now();
+    try {
+        trafo = lookupTransformUncached(fixed_frame, frame, time, max_wait);
+    } catch(...) {
+        countMiss(start);
+        throw;
+    }
+    countMiss(start);
+    storeSnapshot(fixed_frame, frame, time, trafo);
+    return trafo;
+}
+
+bool PoseTracker::lookupTransform(const std::string &target_frame, const std::string &source_frame, const ros::Time &time,
+                                  const ros::Duration &max_wait, tf::StampedTransform &trafo) const
+{
+    if(lookupSnapshot(target_frame, source_frame, time, trafo)) {
+        return true;
+    }
+
+    std::uint64_t start = nav_tracing::Tracer::now();
+    bool found = true;
+    try {
+        pose_listener_.lookupTransform(target_frame, source_frame, time, trafo);
+    } catch(const tf::TransformException& ex) {
+        (void) ex;
+        found = pose_listener_.waitForTransform(target_frame, source_frame, time, max_wait);
+        if(found) {
+            pose_listener_.lookupTransform(target_frame, source_frame, time, trafo);
+        }
+    }
+    countMiss(start);
+
+    if(found) {
+        storeSnapshot(target_frame, source_frame, time, trafo);
+    }
+    return found;
+}
+
+bool PoseTracker::lookupLatestTransform(const std::string &target_frame, const std::string &source_frame, const ros::Time &now,
+                                        const ros::Duration &max_wait, tf::StampedTransform &trafo) const
+{
+    if(lookupSnapshot(target_frame, source_frame, ros::Time(0), trafo)) {
+        return true;
+    }
+
+    std::uint64_t start = nav_tracing::Tracer::now();
+    bool found = true;
+    try {
+        pose_listener_.lookupTransform(target_frame, source_frame, ros::Time(0), trafo);
+    } catch(const tf::TransformException& ex) {
+        (void) ex;
+        found = pose_listener_.waitForTransform(target_frame, source_frame, now, max_wait);
+        if(found) {
+            pose_listener_.lookupTransform(target_frame, source_frame, now, trafo);
+        }
+    }
+    countMiss(start);
+
+    if(found) {
+        storeSnapshot(target_frame, source_frame, ros::Time(0), trafo);
+    }
+    return found;
+}
+
+tf::StampedTransform PoseTracker::lookupTransformUncached(const std::string &fixed_frame, const std::string &frame,
+                                                          const ros::Time &time, const ros::Duration& max_wait) const
 {
     tf::StampedTransform trafo;
     if(pose_listener_.waitForTransform(fixed_frame, frame, time, max_wait)) {
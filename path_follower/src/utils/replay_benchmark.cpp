@@ -0,0 +1,624 @@
+/**
+ * Offline replay benchmark for robot controllers and local planners.
+ *
+ * Recorded paths, poses and obstacle clouds are fed directly into the components (tf buffer, odometry, obstacle
+ * cloud) using a simulated clock, so no ROS master and no running robot is needed.
+ * For every tick the latency of the local planner and the controller, the number of heap allocations and the
+ * distance of the recorded pose to the path are recorded.
+ *
+ * File formats (whitespace separated, '#' starts a comment):
+ *  - path:      "x y theta" per line in the world frame. A line "forward" or "backward" starts a new sub path.
+ *  - poses:     "t x y theta [v omega]" per line, t in seconds, pose in the world frame.
+ *  - obstacles: "t x1 y1 x2 y2 ..." per line, one cloud per line in the robot frame.
+ */
+
+/// PROJECT
+#include <path_follower/factory/controller_factory.h>
+#include <path_follower/factory/local_planner_factory.h>
+#include <path_follower/factory/collision_avoider_factory.h>
+#include <path_follower/controller/robotcontroller.h>
+#include <path_follower/local_planner/abstract_local_planner.h>
+#include <path_follower/collision_avoidance/collision_avoider.h>
+#include <path_follower/parameters/path_follower_parameters.h>
+#include <path_follower/parameters/local_planner_parameters.h>
+#include <path_follower/utils/pose_tracker.h>
+#include <path_follower/utils/obstacle_cloud.h>
+#include <path_follower/utils/path.h>
+
+/// SYSTEM
+#include <ros/ros.h>
+#include <ros/master.h>
+#include <pcl_ros/point_cloud.h>
+#include <tf/tf.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <sstream>
+
+namespace {
+
+std::atomic<bool> g_count_allocations(false);
+std::atomic<std::size_t> g_allocations(0);
+std::atomic<std::size_t> g_allocated_bytes(0);
+
+}
+
+void* operator new(std::size_t size)
+{
+    if(g_count_allocations.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if(!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+struct RecordedPose
+{
+    double t;
+    double x, y, theta;
+    double v, omega;
+};
+
+struct RecordedCloud
+{
+    double t;
+    std::vector<std::pair<double, double>> points;
+};
+
+struct TickSample
+{
+    double planner_ms;
+    double controller_ms;
+    double total_ms;
+    std::size_t allocations;
+    std::size_t allocated_bytes;
+    double tracking_error;
+};
+
+struct Options
+{
+    std::string controller;
+    std::string local_planner;
+    std::string collision_avoider;
+    std::string path_file;
+    std::string poses_file;
+    std::string obstacles_file;
+    std::string csv_file;
+    double velocity = 1.0;
+    int repeat = 1;
+    int warmup = 10;
+};
+
+//! Reads the non-empty, non-comment lines of <file>.
+std::vector<std::string> readLines(const std::string& file)
+{
+    std::ifstream in(file);
+    if(!in.is_open()) {
+        throw std::runtime_error(std::string("cannot open ") + file);
+    }
+
+    std::vector<std::string> lines;
+    std::string line;
+    while(std::getline(in, line)) {
+        std::size_t comment = line.find('#');
+        if(comment != std::string::npos) {
+            line.erase(comment);
+        }
+        if(line.find_first_not_of(" \t\r") != std::string::npos) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+std::vector<SubPath> loadPath(const std::string& file)
+{
+    std::vector<SubPath> path;
+    for(const std::string& line : readLines(file)) {
+        std::istringstream in(line);
+        std::string first;
+        in >> first;
+        if(first == "forward" || first == "backward") {
+            path.emplace_back(first == "forward");
+            continue;
+        }
+
+        double x, y, theta;
+        std::istringstream wp(line);
+        if(!(wp >> x >> y >> theta)) {
+            throw std::runtime_error(std::string("invalid waypoint in ") + file + ": " + line);
+        }
+        if(path.empty()) {
+            path.emplace_back(true);
+        }
+        path.back().wps.emplace_back(x, y, theta);
+    }
+    return path;
+}
+
+std::vector<RecordedPose> loadPoses(const std::string& file)
+{
+    std::vector<RecordedPose> poses;
+    for(const std::string& line : readLines(file)) {
+        std::istringstream in(line);
+        RecordedPose p;
+        if(!(in >> p.t >> p.x >> p.y >> p.theta)) {
+            throw std::runtime_error(std::string("invalid pose in ") + file + ": " + line);
+        }
+        if(!(in >> p.v >> p.omega)) {
+            p.v = 0.0;
+            p.omega = 0.0;
+        }
+        poses.push_back(p);
+    }
+    return poses;
+}
+
+std::vector<RecordedCloud> loadClouds(const std::string& file)
+{
+    std::vector<RecordedCloud> clouds;
+    for(const std::string& line : readLines(file)) {
+        std::istringstream in(line);
+        RecordedCloud c;
+        if(!(in >> c.t)) {
+            throw std::runtime_error(std::string("invalid cloud in ") + file + ": " + line);
+        }
+        double x, y;
+        while(in >> x >> y) {
+            c.points.emplace_back(x, y);
+        }
+        clouds.push_back(c);
+    }
+    return clouds;
+}
+
+//! Distance of (x,y) to the polyline of all sub paths.
+double distanceToPath(const std::vector<SubPath>& path, double x, double y)
+{
+    double best = std::numeric_limits<double>::infinity();
+    Eigen::Vector2d p(x, y);
+    for(const SubPath& sub : path) {
+        for(std::size_t i = 1; i < sub.wps.size(); ++i) {
+            Eigen::Vector2d a(sub.wps[i-1].x, sub.wps[i-1].y);
+            Eigen::Vector2d b(sub.wps[i].x, sub.wps[i].y);
+            Eigen::Vector2d ab = b - a;
+            double len2 = ab.squaredNorm();
+            double s = len2 > 0.0 ? std::max(0.0, std::min(1.0, (p - a).dot(ab) / len2)) : 0.0;
+            best = std::min(best, (a + s * ab - p).norm());
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Replays the recordings against one follower configuration.
+ */
+class Replay
+{
+public:
+    Replay(const Options& opt, ros::NodeHandle& nh)
+        : opt_(opt),
+          params_(*PathFollowerParameters::getInstance()),
+          pose_tracker_(params_, nh),
+          controller_factory_(params_),
+          local_planner_factory_(*LocalPlannerParameters::getInstance())
+    {
+        std::string controller = opt.controller.empty() ? params_.controller() : opt.controller;
+        std::string local_planner = opt.local_planner.empty() ? LocalPlannerParameters::getInstance()->local_planner()
+                                                              : opt.local_planner;
+        ROS_INFO_STREAM("replaying with controller " << controller << " and local planner " << local_planner);
+
+        controller_ = controller_factory_.makeController(controller);
+        local_planner_ = local_planner_factory_.makeConstrainedLocalPlanner(local_planner);
+
+        std::string collision_avoider = opt.collision_avoider;
+        if(collision_avoider.empty()) {
+            collision_avoider = params_.collision_avoider();
+        }
+        if(collision_avoider.empty()) {
+            collision_avoider = controller_factory_.getDefaultCollisionAvoider(controller);
+        }
+        collision_avoider_ = collision_avoider_factory_.makeObstacleAvoider(collision_avoider);
+
+        // same wiring as in FollowerFactory::construct
+        collision_avoider_->setTransformListener(&pose_tracker_.getTransformListener());
+        collision_avoider_->setRobotFrameId(pose_tracker_.getRobotFrameId());
+        local_planner_->init(controller_.get(), &pose_tracker_);
+        controller_->init(&pose_tracker_, collision_avoider_.get());
+        pose_tracker_.setLocal(!local_planner_->isNull());
+    }
+
+    /**
+     * @brief run replays all poses once
+     * @param start_time simulated time of the first pose, has to increase between runs
+     * @param samples [out] one sample per tick is appended
+     */
+    void run(double start_time, const std::vector<SubPath>& subpaths, const std::vector<RecordedPose>& poses,
+             const std::vector<RecordedCloud>& clouds, std::vector<TickSample>& samples)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const double t0 = poses.front().t;
+        std::size_t next_cloud = 0;
+
+        for(std::size_t i = 0; i < poses.size(); ++i) {
+            const RecordedPose& pose = poses[i];
+            ros::Time now(start_time + pose.t - t0);
+            ros::Time::setNow(now);
+
+            publishPose(pose, now);
+
+            if(i == 0) {
+                start(subpaths);
+            }
+
+            while(next_cloud < clouds.size() && clouds[next_cloud].t <= pose.t) {
+                setObstacles(clouds[next_cloud], now);
+                ++next_cloud;
+            }
+
+            TickSample sample;
+            std::size_t allocations = g_allocations.load();
+            std::size_t allocated_bytes = g_allocated_bytes.load();
+            g_count_allocations = true;
+
+            Clock::time_point tick_start = Clock::now();
+
+            PoseTracker::Tick tf_tick(pose_tracker_);
+            pose_tracker_.updateRobotPose();
+            controller_->setCurrentPose(pose_tracker_.getRobotPose());
+
+            bool path_search_failure = false;
+            if(!local_planner_->isNull()) {
+                if(obstacle_cloud_) {
+                    local_planner_->setObstacleCloud(obstacle_cloud_);
+                }
+                if(LocalPlannerParameters::getInstance()->use_velocity()) {
+                    local_planner_->setVelocity(pose_tracker_.getVelocity());
+                }
+                try {
+                    Path::Ptr local_path = local_planner_->updateLocalPath();
+                    path_search_failure = local_path && local_path->empty();
+                } catch(const std::runtime_error&) {
+                    path_search_failure = true;
+                }
+            }
+
+            Clock::time_point planner_end = Clock::now();
+
+            RobotController::ControlStatus status = RobotController::ControlStatus::OKAY;
+            if(path_search_failure) {
+                controller_->stopMotion();
+            } else {
+                status = controller_->execute();
+            }
+
+            Clock::time_point tick_end = Clock::now();
+
+            g_count_allocations = false;
+
+            sample.planner_ms = std::chrono::duration<double, std::milli>(planner_end - tick_start).count();
+            sample.controller_ms = std::chrono::duration<double, std::milli>(tick_end - planner_end).count();
+            sample.total_ms = std::chrono::duration<double, std::milli>(tick_end - tick_start).count();
+            sample.allocations = g_allocations.load() - allocations;
+            sample.allocated_bytes = g_allocated_bytes.load() - allocated_bytes;
+            sample.tracking_error = distanceToPath(subpaths, pose.x, pose.y);
+            samples.push_back(sample);
+
+            if(status == RobotController::ControlStatus::REACHED_GOAL ||
+                    status == RobotController::ControlStatus::ERROR) {
+                ROS_INFO_STREAM("replay finished after " << (i+1) << " of " << poses.size() << " poses ("
+                                << (status == RobotController::ControlStatus::ERROR ? "error" : "goal reached") << ")");
+                break;
+            }
+        }
+
+        controller_->stopMotion();
+    }
+
+    PoseTracker::CacheStatistics getCacheStatistics() const
+    {
+        return pose_tracker_.getCacheStatistics();
+    }
+
+private:
+    void start(const std::vector<SubPath>& subpaths)
+    {
+        path_ = std::make_shared<Path>(params_.world_frame());
+        path_->setPath(subpaths);
+        obstacle_cloud_.reset();
+
+        controller_->setVelocity(opt_.velocity);
+        controller_->reset();
+        controller_->start();
+
+        local_planner_->setGlobalPath(path_);
+        local_planner_->setVelocity(opt_.velocity);
+    }
+
+    //! Inserts the recorded pose into the tf buffer and the odometry.
+    void publishPose(const RecordedPose& pose, const ros::Time& now)
+    {
+        tf::TransformListener& tf = pose_tracker_.getTransformListener();
+
+        // the recorded pose is used for map and odom, map -> odom is the identity
+        tf::StampedTransform map_to_odom(tf::Transform::getIdentity(), now,
+                                         params_.world_frame(), params_.odom_frame());
+        tf::StampedTransform odom_to_robot(tf::Transform(tf::createQuaternionFromYaw(pose.theta),
+                                                         tf::Vector3(pose.x, pose.y, 0.0)),
+                                           now, params_.odom_frame(), params_.robot_frame());
+        tf.setTransform(map_to_odom, "replay");
+        tf.setTransform(odom_to_robot, "replay");
+
+        nav_msgs::Odometry odom;
+        odom.header.stamp = now;
+        odom.header.frame_id = params_.odom_frame();
+        odom.child_frame_id = params_.robot_frame();
+        odom.pose.pose.position.x = pose.x;
+        odom.pose.pose.position.y = pose.y;
+        odom.pose.pose.orientation = tf::createQuaternionMsgFromYaw(pose.theta);
+        odom.twist.twist.linear.x = pose.v;
+        odom.twist.twist.angular.z = pose.omega;
+        pose_tracker_.setOdometry(odom);
+    }
+
+    //! Transforms the recorded cloud into the fixed frame, as the follower node does.
+    void setObstacles(const RecordedCloud& recorded, const ros::Time& now)
+    {
+        ObstacleCloud::Cloud::Ptr cloud(new ObstacleCloud::Cloud);
+        cloud->header.frame_id = params_.robot_frame();
+        cloud->header.stamp = now.toNSec() / 1000ull;
+        for(const auto& pt : recorded.points) {
+            cloud->points.emplace_back(pt.first, pt.second, 0.0f);
+        }
+        cloud->width = cloud->points.size();
+        cloud->height = 1;
+
+        tf::Transform fixed_to_robot = pose_tracker_.getTransform(pose_tracker_.getFixedFrameId(),
+                                                                  params_.robot_frame(), now, ros::Duration(0));
+
+        auto obstacle_cloud = std::make_shared<ObstacleCloud>(cloud);
+        obstacle_cloud->transformCloud(fixed_to_robot, pose_tracker_.getFixedFrameId());
+        obstacle_cloud_ = obstacle_cloud;
+
+        collision_avoider_->setObstacles(obstacle_cloud_);
+    }
+
+private:
+    const Options& opt_;
+    const PathFollowerParameters& params_;
+
+    PoseTracker pose_tracker_;
+
+    ControllerFactory controller_factory_;
+    LocalPlannerFactory local_planner_factory_;
+    CollisionAvoiderFactory collision_avoider_factory_;
+
+    std::shared_ptr<RobotController> controller_;
+    std::shared_ptr<AbstractLocalPlanner> local_planner_;
+    std::shared_ptr<CollisionAvoider> collision_avoider_;
+
+    Path::Ptr path_;
+    std::shared_ptr<ObstacleCloud const> obstacle_cloud_;
+};
+
+//! Nearest rank percentile of the sorted values.
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if(sorted.empty()) {
+        return 0.0;
+    }
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+template <typename Getter>
+void printLatency(const std::string& name, const std::vector<TickSample>& samples, Getter get)
+{
+    std::vector<double> values;
+    values.reserve(samples.size());
+    for(const TickSample& s : samples) {
+        values.push_back(get(s));
+    }
+    std::sort(values.begin(), values.end());
+
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << percentile(values, 50)
+              << std::setw(10) << percentile(values, 90)
+              << std::setw(10) << percentile(values, 99)
+              << std::setw(10) << (values.empty() ? 0.0 : values.back()) << '\n';
+}
+
+void printReport(const std::vector<TickSample>& samples)
+{
+    std::cout << "ticks: " << samples.size() << "\n\n";
+    std::cout << std::left << std::setw(12) << "latency [ms]" << std::right
+              << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "max" << '\n';
+    printLatency("planner", samples, [](const TickSample& s) { return s.planner_ms; });
+    printLatency("controller", samples, [](const TickSample& s) { return s.controller_ms; });
+    printLatency("total", samples, [](const TickSample& s) { return s.total_ms; });
+
+    std::size_t allocations = 0, max_allocations = 0, bytes = 0;
+    double error_sum = 0.0, error_sq_sum = 0.0, max_error = 0.0;
+    for(const TickSample& s : samples) {
+        allocations += s.allocations;
+        max_allocations = std::max(max_allocations, s.allocations);
+        bytes += s.allocated_bytes;
+        error_sum += s.tracking_error;
+        error_sq_sum += s.tracking_error * s.tracking_error;
+        max_error = std::max(max_error, s.tracking_error);
+    }
+    double n = std::max<std::size_t>(1, samples.size());
+
+    std::cout << "\nallocations per tick: mean " << std::setprecision(1) << allocations / n
+              << ", max " << max_allocations << ", bytes " << std::setprecision(0) << bytes / n << '\n';
+    std::cout << "tracking error [m]:   mean " << std::setprecision(3) << error_sum / n
+              << ", rms " << std::sqrt(error_sq_sum / n) << ", max " << max_error << std::endl;
+}
+
+void writeCsv(const std::string& file, const std::vector<TickSample>& samples)
+{
+    std::ofstream out(file);
+    if(!out.is_open()) {
+        throw std::runtime_error(std::string("cannot open ") + file + " for writing");
+    }
+    out << "tick,planner_ms,controller_ms,total_ms,allocations,allocated_bytes,tracking_error\n";
+    for(std::size_t i = 0; i < samples.size(); ++i) {
+        const TickSample& s = samples[i];
+        out << i << ',' << s.planner_ms << ',' << s.controller_ms << ',' << s.total_ms << ','
+            << s.allocations << ',' << s.allocated_bytes << ',' << s.tracking_error << '\n';
+    }
+}
+
+void showHelp(const std::string& program)
+{
+    std::cout << "Usage:\n";
+    std::cout << program << " --path FILE --poses FILE [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --controller NAME         robot controller to use (default: parameter controller_type)\n";
+    std::cout << "  --local-planner NAME      local planner to use (default: parameter local_planner/algorithm)\n";
+    std::cout << "  --collision-avoider NAME  collision avoider (default: parameter or controller default)\n";
+    std::cout << "  --obstacles FILE          recorded obstacle clouds\n";
+    std::cout << "  --velocity V              desired velocity (default: 1.0)\n";
+    std::cout << "  --repeat N                replay the recording N times (default: 1)\n";
+    std::cout << "  --warmup N                ignore the first N ticks in the report (default: 10)\n";
+    std::cout << "  --csv FILE                write all tick samples to FILE\n";
+    std::cout << std::flush;
+}
+
+bool parseOptions(int argc, char** argv, Options& opt)
+{
+    for(int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if(arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if(i + 1 >= argc) {
+            std::cerr << "missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if(arg == "--controller") {
+            opt.controller = value;
+        } else if(arg == "--local-planner") {
+            opt.local_planner = value;
+        } else if(arg == "--collision-avoider") {
+            opt.collision_avoider = value;
+        } else if(arg == "--path") {
+            opt.path_file = value;
+        } else if(arg == "--poses") {
+            opt.poses_file = value;
+        } else if(arg == "--obstacles") {
+            opt.obstacles_file = value;
+        } else if(arg == "--csv") {
+            opt.csv_file = value;
+        } else if(arg == "--velocity") {
+            opt.velocity = std::stod(value);
+        } else if(arg == "--repeat") {
+            opt.repeat = std::stoi(value);
+        } else if(arg == "--warmup") {
+            opt.warmup = std::stoi(value);
+        } else {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return !opt.path_file.empty() && !opt.poses_file.empty();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "path_follower_replay_benchmark",
+              ros::init_options::AnonymousName | ros::init_options::NoRosout | ros::init_options::NoSigintHandler);
+
+    Options opt;
+    if(!parseOptions(argc, argv, opt)) {
+        showHelp(argv[0]);
+        return 1;
+    }
+
+    if(!ros::master::check()) {
+        // publishers and subscribers cannot register, do not wait for a master
+        ros::master::setRetryTimeout(ros::WallDuration(0.01));
+        ROS_INFO("no ROS master available, using default parameters");
+    }
+
+    // replay with a simulated clock
+    ros::Time::init();
+    ros::Time::setNow(ros::Time(1.0));
+
+    try {
+        std::vector<SubPath> path = loadPath(opt.path_file);
+        std::vector<RecordedPose> poses = loadPoses(opt.poses_file);
+        std::vector<RecordedCloud> clouds;
+        if(!opt.obstacles_file.empty()) {
+            clouds = loadClouds(opt.obstacles_file);
+        }
+        if(path.empty() || poses.empty()) {
+            std::cerr << "path and poses must not be empty" << std::endl;
+            return 1;
+        }
+
+        ros::NodeHandle nh;
+        Replay replay(opt, nh);
+
+        double duration = poses.back().t - poses.front().t;
+        double start_time = 1.0;
+
+        std::vector<TickSample> samples;
+        for(int r = 0; r < opt.repeat; ++r) {
+            std::vector<TickSample> run_samples;
+            replay.run(start_time, path, poses, clouds, run_samples);
+
+            int skip = std::min<int>(std::max(opt.warmup, 0), run_samples.size());
+            samples.insert(samples.end(), run_samples.begin() + skip, run_samples.end());
+
+            // the tf buffer only accepts increasing time stamps
+            start_time += duration + 1.0;
+        }
+
+        printReport(samples);
+
+        PoseTracker::CacheStatistics tf_stats = replay.getCacheStatistics();
+        std::cout << "tf snapshot:          " << tf_stats.hits << " hits, " << tf_stats.misses << " misses, "
+                  << std::setprecision(3) << tf_stats.wait_ms << " ms in tf (max " << tf_stats.max_wait_ms << " ms)\n"
+                  << std::flush;
+
+        if(!opt.csv_file.empty()) {
+            writeCsv(opt.csv_file, samples);
+        }
+
+    } catch(const std::exception& e) {
+        std::cerr << "replay failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
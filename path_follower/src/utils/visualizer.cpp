@@ -6,11 +6,31 @@
 
 using namespace Eigen;
 
+Visualizer::Frame::Frame()
+{
+    Visualizer::getInstance()->beginFrame();
+}
+
+Visualizer::Frame::~Frame()
+{
+    Visualizer::getInstance()->endFrame();
+}
+
 Visualizer::Visualizer() :
-    private_nh_("~")
+    private_nh_("~"),
+    frame_depth_(0),
+    frame_count_(0),
+    frame_has_marker_subscriber_(false),
+    frame_has_array_subscriber_(false)
 {
     vis_pub_ = nh_.advertise<visualization_msgs::Marker>("visualization_marker", 100);
     marray_vis_pub_ = nh_.advertise<visualization_msgs::MarkerArray>("visualization_marker_array", 100);
+
+    std::map<std::string, double> rate_limits;
+    private_nh_.getParam("visualization/rate_limits", rate_limits);
+    for(const auto& limit : rate_limits) {
+        setRateLimit(limit.first, limit.second);
+    }
 }
 
 Visualizer *Visualizer::getInstance()
@@ -30,8 +50,119 @@ bool Visualizer::MarrayhasSubscriber()
     return marray_vis_pub_.getNumSubscribers() > 0;
 }
 
+void Visualizer::setRateLimit(const std::string &ns, double rate)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(rate > 0.0) {
+        rate_limits_[ns].period = ros::Duration(1.0 / rate);
+    } else {
+        rate_limits_.erase(ns);
+    }
+}
+
+void Visualizer::beginFrame()
+{
+    bool has_marker_subscriber = vis_pub_.getNumSubscribers() > 0;
+    bool has_array_subscriber = marray_vis_pub_.getNumSubscribers() > 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(frame_depth_++ == 0) {
+        ++frame_count_;
+        frame_has_marker_subscriber_ = has_marker_subscriber;
+        frame_has_array_subscriber_ = has_array_subscriber;
+        marker_batch_.clear();
+        array_batch_.markers.clear();
+    }
+}
+
+void Visualizer::endFrame()
+{
+    std::vector<visualization_msgs::Marker> markers;
+    visualization_msgs::MarkerArray array;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(--frame_depth_ > 0) {
+            return;
+        }
+        markers.swap(marker_batch_);
+        array.markers.swap(array_batch_.markers);
+    }
+
+    // every marker stays on the topic it is drawn for
+    for(const visualization_msgs::Marker& marker : markers) {
+        vis_pub_.publish(marker);
+    }
+    if(!array.markers.empty()) {
+        marray_vis_pub_.publish(array);
+    }
+}
+
+bool Visualizer::shouldDraw(const std::string &ns, bool array) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if(frame_depth_ > 0) {
+        if(!(array ? frame_has_array_subscriber_ : frame_has_marker_subscriber_)) {
+            return false;
+        }
+    } else {
+        const ros::Publisher& pub = array ? marray_vis_pub_ : vis_pub_;
+        if(pub.getNumSubscribers() == 0) {
+            return false;
+        }
+        ++frame_count_;
+    }
+
+    auto limit = rate_limits_.find(ns);
+    if(limit == rate_limits_.end()) {
+        return true;
+    }
+
+    // decide once per frame, so that all markers of a namespace stay consistent
+    RateLimit& l = limit->second;
+    if(l.frame != frame_count_) {
+        ros::Time now = ros::Time::now();
+        l.frame = frame_count_;
+        l.accepted = now - l.last >= l.period || now < l.last;
+        if(l.accepted) {
+            l.last = now;
+        }
+    }
+    return l.accepted;
+}
+
+void Visualizer::publish(const visualization_msgs::Marker &marker) const
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(frame_depth_ > 0) {
+            marker_batch_.push_back(marker);
+            return;
+        }
+    }
+
+    vis_pub_.publish(marker);
+}
+
+void Visualizer::publish(const visualization_msgs::MarkerArray &array) const
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(frame_depth_ > 0) {
+            array_batch_.markers.insert(array_batch_.markers.end(), array.markers.begin(), array.markers.end());
+            return;
+        }
+    }
+
+    marray_vis_pub_.publish(array);
+}
+
 void Visualizer::drawArrow(const std::string& frame, int id, const geometry_msgs::Pose &pose, const std::string &ns, float r, float g, float b, double live, double scale) const
 {
+    if(!shouldDraw(ns)) {
+        return;
+    }
+
     visualization_msgs::Marker marker;
     marker.pose = pose;
     marker.ns = ns;
@@ -49,12 +180,16 @@ void Visualizer::drawArrow(const std::string& frame, int id, const geometry_msgs
     marker.scale.z = 0.05 * scale;
     marker.type = visualization_msgs::Marker::ARROW;
 
-    vis_pub_.publish(marker);
+    publish(marker);
 }
 
 void Visualizer::drawLine(int id, const geometry_msgs::Point &from, const geometry_msgs::Point &to, const std::string &frame,
                           const std::string &ns, float r, float g, float b, double live, float scale) const
 {
+    if(!shouldDraw(ns)) {
+        return;
+    }
+
     visualization_msgs::Marker marker;
     marker.ns = ns;
     marker.header.frame_id = frame;
@@ -72,7 +207,7 @@ void Visualizer::drawLine(int id, const geometry_msgs::Point &from, const geomet
     marker.scale.x = scale;
     marker.type = visualization_msgs::Marker::LINE_LIST;
 
-    vis_pub_.publish(marker);
+    publish(marker);
 }
 
 void Visualizer::drawLine(int id, const Eigen::Vector2d &from, const Eigen::Vector2d &to, const std::string &frame, const std::string &ns, float r, float g, float b, double live, float scale) const
@@ -89,6 +224,10 @@ void Visualizer::drawLine(int id, const Eigen::Vector2d &from, const Eigen::Vect
 void Visualizer::drawCircle(int id, const geometry_msgs::Point &center, double radius, const std::string &frame,
                             const std::string &ns, float r, float g, float b, float alpha, double live) const
 {
+    if(!shouldDraw(ns)) {
+        return;
+    }
+
     visualization_msgs::Marker marker;
     marker.ns = ns;
     marker.header.frame_id = frame;
@@ -107,12 +246,16 @@ void Visualizer::drawCircle(int id, const geometry_msgs::Point &center, double r
     marker.scale.z = 0.1;
     marker.type = visualization_msgs::Marker::CYLINDER;
 
-    vis_pub_.publish(marker);
+    publish(marker);
 }
 
 void Visualizer::drawMark(int id, const geometry_msgs::Point &pos, const std::string &ns, float r, float g, float b,
                           const std::string &frame) const
 {
+    if(!shouldDraw(ns)) {
+        return;
+    }
+
     std::string fixed_frame = frame;
     if(fixed_frame.empty()) {
         fixed_frame = PathFollowerParameters::getInstance()->world_frame();
@@ -135,12 +278,16 @@ void Visualizer::drawMark(int id, const geometry_msgs::Point &pos, const std::st
     marker.scale.z = 0.5;
     marker.type = visualization_msgs::Marker::CUBE;
 
-    vis_pub_.publish(marker);
+    publish(marker);
 }
 
 void Visualizer::drawText(int id, const geometry_msgs::Point &pos, const std::string &text, const std::string &ns,
                           float r, float g, float b, const std::string &frame, double live) const
 {
+    if(!shouldDraw(ns)) {
+        return;
+    }
+
     std::string fixed_frame = frame;
     if(fixed_frame.empty()) {
         fixed_frame = PathFollowerParameters::getInstance()->world_frame();
@@ -162,7 +309,7 @@ void Visualizer::drawText(int id, const geometry_msgs::Point &pos, const std::st
     marker.type = visualization_msgs::Marker::TEXT_VIEW_FACING;
     marker.text = text;
 
-    vis_pub_.publish(marker);
+    publish(marker);
 }
 
 
@@ -189,6 +336,10 @@ void Visualizer::visualizeLine(const Line2d &line)
 void Visualizer::drawFrenetSerretFrame(const std::string& frame, int id, Eigen::Vector3d robot_pose, double xe, double ye, double p_ind,
                                        double q_ind, double theta_p)
 {
+    if(!shouldDraw("path_coord", true)) {
+        return;
+    }
+
     visualization_msgs::MarkerArray path_coord_marray;
 
     visualization_msgs::Marker prototype;
@@ -296,7 +447,7 @@ void Visualizer::drawFrenetSerretFrame(const std::string& frame, int id, Eigen::
     path_coord_marray.markers.push_back(visualization_msgs::Marker(path_ordinate_marker));
     path_coord_marray.markers.push_back(visualization_msgs::Marker(ordinate_distance_marker));
 
-    marray_vis_pub_.publish(path_coord_marray);
+    publish(path_coord_marray);
 }
 
 ros::Publisher Visualizer::getMarkerPublisher()
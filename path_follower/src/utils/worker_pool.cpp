@@ -0,0 +1,108 @@
+#include <path_follower/utils/worker_pool.h>
+
+WorkerPool::WorkerPool(std::size_t threads)
+    : job_(nullptr),
+      job_size_(0),
+      generation_(0),
+      busy_(0),
+      stop_(false),
+      next_(0)
+{
+    start(threads);
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+std::size_t WorkerPool::size() const
+{
+    return workers_.size() + 1;
+}
+
+void WorkerPool::resize(std::size_t threads)
+{
+    stop();
+    start(threads);
+}
+
+void WorkerPool::start(std::size_t threads)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = false;
+    for(std::size_t t = 1; t < threads; ++t) {
+        // the worker only waits for loops started after it was created
+        workers_.emplace_back(&WorkerPool::workerLoop, this, generation_);
+    }
+}
+
+void WorkerPool::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    job_cond_.notify_all();
+
+    for(std::thread& t : workers_) {
+        t.join();
+    }
+    workers_.clear();
+}
+
+void WorkerPool::parallelFor(std::size_t n, const std::function<void(std::size_t)>& f)
+{
+    if(workers_.empty() || n <= 1) {
+        for(std::size_t i = 0; i < n; ++i) {
+            f(i);
+        }
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = &f;
+        job_size_ = n;
+        next_ = 0;
+        busy_ = workers_.size();
+        ++generation_;
+    }
+    job_cond_.notify_all();
+
+    work(f, n);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cond_.wait(lock, [this]() { return busy_ == 0; });
+    job_ = nullptr;
+}
+
+void WorkerPool::workerLoop(unsigned long generation)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true) {
+        job_cond_.wait(lock, [this, generation]() { return stop_ || generation_ != generation; });
+        if(stop_) {
+            return;
+        }
+        generation = generation_;
+
+        const std::function<void(std::size_t)>& f = *job_;
+        std::size_t n = job_size_;
+
+        lock.unlock();
+        work(f, n);
+        lock.lock();
+
+        if(--busy_ == 0) {
+            done_cond_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::work(const std::function<void(std::size_t)>& f, std::size_t n)
+{
+    for(std::size_t i = next_++; i < n; i = next_++) {
+        f(i);
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * Test of the batched evaluation of spline_curve.
+ */
+#include <gtest/gtest.h>
+#include <path_follower/utils/cubic_spline_interpolation.h>
+#include <cmath>
+
+namespace {
+void makeCurve(spline_curve& curve, spline::bd_type boundary, std::vector<double>& s)
+{
+    std::vector<double> p, q;
+    double l = 0;
+    for(int i = 0; i < 40; ++i) {
+        l += 0.1 + 0.05 * std::sin(i);
+        s.push_back(l);
+        p.push_back(3.0 * std::cos(0.2 * l));
+        q.push_back(2.0 * std::sin(0.3 * l) + 0.5 * l);
+    }
+    curve.set_points(s, p, q, boundary);
+}
+}
+
+TEST(TestCubicSpline, batchMatchesScalarEvaluation)
+{
+    std::vector<double> knots;
+    spline_curve curve;
+    makeCurve(curve, spline::natural, knots);
+
+    // ascending, including extrapolation at both ends, followed by some descending values
+    std::vector<double> s;
+    for(int i = 0; i < 301; ++i) {
+        s.push_back(-0.5 + (knots.back() + 1.0) * i / 300.0);
+    }
+    for(int i = 0; i < 7; ++i) {
+        s.push_back(knots.back() - i * 0.7);
+    }
+
+    curve_samples<double> out;
+    curve.evaluate(s, out);
+    ASSERT_EQ(s.size(), out.p.size());
+
+    for(std::size_t i = 0; i < s.size(); ++i) {
+        EXPECT_NEAR(curve.p()(s[i]), out.p[i], 1e-9);
+        EXPECT_NEAR(curve.q()(s[i]), out.q[i], 1e-9);
+
+        const double h = 1e-6;
+        EXPECT_NEAR((curve.p()(s[i] + h) - curve.p()(s[i] - h)) / (2 * h), out.p_prim[i], 1e-4);
+        EXPECT_NEAR((curve.q()(s[i] + h) - curve.q()(s[i] - h)) / (2 * h), out.q_prim[i], 1e-4);
+
+        double v2 = out.p_prim[i] * out.p_prim[i] + out.q_prim[i] * out.q_prim[i];
+        double k = (out.p_prim[i] * out.q_sek[i] - out.p_sek[i] * out.q_prim[i]) / std::pow(v2, 1.5);
+        EXPECT_NEAR(k, out.curvature[i], 1e-9);
+    }
+}
+
+TEST(TestCubicSpline, parabolicEndSegments)
+{
+    std::vector<double> knots;
+    spline_curve curve;
+    makeCurve(curve, spline::parabolic, knots);
+
+    const std::size_t n = knots.size();
+    std::vector<double> s = { knots[0], 0.5 * (knots[0] + knots[1]),
+                              0.5 * (knots[n-2] + knots[n-1]), knots[n-1] };
+    curve_samples<double> out;
+    curve.evaluate(s, out);
+
+    // the second derivative is constant on the first and on the last segment
+    EXPECT_NEAR(out.p_sek[0], out.p_sek[1], 1e-9);
+    EXPECT_NEAR(out.q_sek[0], out.q_sek[1], 1e-9);
+    EXPECT_NEAR(out.p_sek[2], out.p_sek[3], 1e-9);
+    EXPECT_NEAR(out.q_sek[2], out.q_sek[3], 1e-9);
+}
+
+TEST(TestCubicSpline, singlePrecisionIsClose)
+{
+    std::vector<double> knots;
+    spline_curve curve;
+    makeCurve(curve, spline::parabolic, knots);
+
+    std::vector<double> s;
+    for(int i = 0; i < 100; ++i) {
+        s.push_back(knots.front() + (knots.back() - knots.front()) * i / 99.0);
+    }
+    curve_samples<double> out;
+    curve.evaluate(s, out);
+    curve_samples<float> out_f;
+    curve.evaluate(std::vector<float>(s.begin(), s.end()), out_f);
+
+    for(std::size_t i = 0; i < s.size(); ++i) {
+        EXPECT_NEAR(out.p[i], out_f.p[i], 1e-4);
+        EXPECT_NEAR(out.q[i], out_f.q[i], 1e-4);
+        EXPECT_NEAR(out.curvature[i], out_f.curvature[i], 1e-3);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
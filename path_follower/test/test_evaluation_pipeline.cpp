@@ -0,0 +1,125 @@
+/**
+ * Test of EvaluationPipeline against the virtual scorers and constraints.
+ */
+#include <gtest/gtest.h>
+#include <random>
+#include <path_follower/local_planner/evaluation_pipeline.h>
+#include <path_follower/local_planner/scorers/dis2pathp_scorer.h>
+#include <path_follower/local_planner/scorers/dis2pathd_scorer.h>
+#include <path_follower/local_planner/scorers/curvature_scorer.h>
+#include <path_follower/local_planner/scorers/curvatured_scorer.h>
+#include <path_follower/local_planner/scorers/level_scorer.h>
+#include <path_follower/local_planner/scorers/dis2obst_scorer.h>
+#include <path_follower/local_planner/constraints/dis2path_constraint.h>
+#include <path_follower/local_planner/constraints/dis2obst_constraint.h>
+
+namespace {
+
+std::vector<LNode> makeTree(std::size_t n)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> u(-3.0, 3.0);
+
+    std::vector<LNode> nodes(n);
+    for(std::size_t i = 0; i < n; ++i) {
+        double radius = (i % 3 == 0) ? std::numeric_limits<double>::infinity() : 3.0 * u(rng);
+        nodes[i] = LNode(u(rng), u(rng), u(rng), i > 0 ? &nodes[i / 2] : nullptr, radius, i % 7);
+        nodes[i].d2p = std::abs(u(rng));
+        nodes[i].d2o = 2.0 * std::abs(u(rng));
+        nodes[i].nop = Waypoint(u(rng), u(rng), u(rng));
+        nodes[i].npp = Waypoint(u(rng), u(rng), u(rng));
+    }
+    return nodes;
+}
+
+}
+
+TEST(TestEvaluationPipeline, scoresMatchVirtualScorers)
+{
+    std::vector<LNode> nodes = makeTree(50);
+    std::vector<const LNode*> ptrs;
+    for(const LNode& n : nodes) {
+        ptrs.push_back(&n);
+    }
+
+    for(unsigned mask = 0; mask < (1u << EvaluationPipeline::SCORER_KERNELS); ++mask) {
+        std::vector<Scorer::Ptr> scorers;
+        if(mask & 1)  scorers.emplace_back(new Dis2PathP_Scorer);
+        if(mask & 2)  scorers.emplace_back(new Dis2PathD_Scorer);
+        if(mask & 4)  scorers.emplace_back(new Curvature_Scorer);
+        if(mask & 8)  scorers.emplace_back(new CurvatureD_Scorer);
+        if(mask & 16) scorers.emplace_back(new Level_Scorer);
+        if(mask & 32) scorers.emplace_back(new Dis2Obst_Scorer);
+        for(std::size_t i = 0; i < scorers.size(); ++i) {
+            scorers[i]->setWeight(0.5 + i);
+        }
+
+        EvaluationPipeline pipeline;
+        ASSERT_TRUE(pipeline.configureScorers(scorers));
+
+        std::vector<double> batch(nodes.size());
+        pipeline.score(ptrs.data(), ptrs.size(), batch.data());
+
+        for(std::size_t i = 0; i < nodes.size(); ++i) {
+            double expected = 0.0;
+            for(const Scorer::Ptr& s : scorers) {
+                expected += s->calculateScore(nodes[i]);
+            }
+            EXPECT_EQ(expected, pipeline.score(nodes[i])) << "mask " << mask << ", node " << i;
+            EXPECT_EQ(expected, batch[i]) << "mask " << mask << ", node " << i;
+        }
+    }
+}
+
+TEST(TestEvaluationPipeline, constraintsMatchVirtualConstraints)
+{
+    std::vector<LNode> nodes = makeTree(50);
+    std::vector<const LNode*> ptrs;
+    for(const LNode& n : nodes) {
+        ptrs.push_back(&n);
+    }
+
+    for(unsigned mask = 0; mask < (1u << EvaluationPipeline::CONSTRAINT_KERNELS); ++mask) {
+        std::vector<Constraint::Ptr> constraints;
+        if(mask & 1) {
+            constraints.emplace_back(new Dis2Path_Constraint);
+        }
+        if(mask & 2) {
+            auto d2o = std::make_shared<Dis2Obst_Constraint>();
+            d2o->setParams(0.7);
+            constraints.push_back(d2o);
+        }
+
+        EvaluationPipeline pipeline;
+        ASSERT_TRUE(pipeline.configureConstraints(constraints));
+
+        std::vector<char> batch(nodes.size());
+        pipeline.areSatisfied(ptrs.data(), ptrs.size(), batch.data());
+
+        for(std::size_t i = 0; i < nodes.size(); ++i) {
+            bool expected = true;
+            for(const Constraint::Ptr& c : constraints) {
+                expected = expected && c->isSatisfied(nodes[i]);
+            }
+            EXPECT_EQ(expected, pipeline.isSatisfied(nodes[i])) << "mask " << mask << ", node " << i;
+            EXPECT_EQ(expected, batch[i] != 0) << "mask " << mask << ", node " << i;
+        }
+    }
+}
+
+TEST(TestEvaluationPipeline, rejectsUnorderedScorers)
+{
+    std::vector<Scorer::Ptr> scorers;
+    scorers.emplace_back(new Level_Scorer);
+    scorers.emplace_back(new Dis2PathP_Scorer);
+
+    EvaluationPipeline pipeline;
+    EXPECT_FALSE(pipeline.configureScorers(scorers));
+    EXPECT_FALSE(pipeline.hasScorers());
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,72 @@
+/**
+ * Test of the ObstacleDistanceGrid.
+ */
+#include <gtest/gtest.h>
+#include <path_follower/utils/obstacle_distance_grid.h>
+#include <random>
+
+namespace {
+float bruteForce(const std::vector<cv::Point2f>& points, float x, float y)
+{
+    float best = std::numeric_limits<float>::infinity();
+    for(const cv::Point2f& p : points) {
+        best = std::min(best, std::hypot(p.x - x, p.y - y));
+    }
+    return best;
+}
+}
+
+TEST(TestObstacleDistanceGrid, matchesBruteForce)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coord(-4.0f, 4.0f);
+
+    const cv::Point2f center(0.5f, -0.25f);
+    const float radius = 2.0f;
+    const float max_distance = 0.6f;
+    const float resolution = 0.05f;
+    const float tolerance = resolution * std::sqrt(2.0f) + 1e-4f;
+
+    ObstacleDistanceGrid grid;
+    for(int n : { 0, 1, 20, 300 }) {
+        std::vector<cv::Point2f> points;
+        for(int i = 0; i < n; ++i) {
+            points.emplace_back(coord(rng), coord(rng));
+        }
+        grid.build(points, center, radius, max_distance, resolution);
+
+        for(int i = 0; i < 2000; ++i) {
+            const float x = center.x + coord(rng) * radius / 4.0f;
+            const float y = center.y + coord(rng) * radius / 4.0f;
+            const float expected = bruteForce(points, x, y);
+            const float d = grid.distance(x, y);
+            if(expected < max_distance - tolerance) {
+                EXPECT_NEAR(expected, d, tolerance);
+            } else if(expected > max_distance + tolerance) {
+                EXPECT_TRUE(std::isinf(d));
+            }
+        }
+    }
+}
+
+TEST(TestObstacleDistanceGrid, outsideOfWindowIsFree)
+{
+    ObstacleDistanceGrid grid;
+    grid.build({ cv::Point2f(0.0f, 0.0f) }, cv::Point2f(0.0f, 0.0f), 1.0f, 0.5f, 0.1f);
+    EXPECT_FLOAT_EQ(0.0f, grid.distance(0.0f, 0.0f));
+    EXPECT_TRUE(std::isinf(grid.distance(10.0f, 0.0f)));
+}
+
+TEST(TestObstacleDistanceGrid, resolutionIsReducedForLargeWindows)
+{
+    ObstacleDistanceGrid grid;
+    grid.build({}, cv::Point2f(0.0f, 0.0f), 1000.0f, 1.0f, 0.01f);
+    EXPECT_LE(grid.size(), 512);
+    EXPECT_GE(grid.resolution() * grid.size(), 2000.0f);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,62 @@
+/**
+ * Test of the ObstacleIndex.
+ */
+#include <gtest/gtest.h>
+#include <path_follower/utils/obstacle_index.h>
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <random>
+
+namespace {
+ObstacleCloud::ConstPtr makeCloud(const std::vector<Eigen::Vector3d>& points)
+{
+    boost::shared_ptr<ObstacleCloud::Cloud> cloud(new ObstacleCloud::Cloud);
+    for(const Eigen::Vector3d& p : points) {
+        cloud->push_back(pcl::PointXYZ(p.x(), p.y(), p.z()));
+    }
+    return std::make_shared<ObstacleCloud>(cloud);
+}
+}
+
+TEST(TestObstacleIndex, emptyCloudHasNoNearest)
+{
+    ObstacleIndex index;
+    index.update(makeCloud({}));
+
+    Eigen::Vector3d nearest;
+    EXPECT_FALSE(index.nearest(Eigen::Vector3d::Zero(), nearest));
+}
+
+TEST(TestObstacleIndex, nearestMatchesBruteForce)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coord(-10.0, 10.0);
+    std::uniform_real_distribution<double> height(-1.0, 1.0);
+
+    std::vector<Eigen::Vector3d> points;
+    for(int i = 0; i < 500; ++i) {
+        points.emplace_back(coord(rng), 0.1 * coord(rng), height(rng));
+    }
+    ObstacleIndex index;
+    index.update(makeCloud(points));
+
+    for(int q = 0; q < 200; ++q) {
+        // queries outside of the cloud as well
+        Eigen::Vector3d query(2.0 * coord(rng), 2.0 * coord(rng), height(rng));
+
+        double best = std::numeric_limits<double>::infinity();
+        for(const Eigen::Vector3d& p : points) {
+            best = std::min(best, (p - query).norm());
+        }
+
+        Eigen::Vector3d nearest;
+        ASSERT_TRUE(index.nearest(query, nearest));
+        EXPECT_NEAR(best, (nearest - query).norm(), 1e-5);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
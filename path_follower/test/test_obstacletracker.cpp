@@ -96,6 +96,21 @@ TEST(TestPathLookout, obstacleTracker)
     ASSERT_LT(tracked2[1].time_of_last_sight(), tracked3[1].time_of_last_sight());
 }
 
+TEST(TestPathLookout, obstacleTrackerMatchesOptimal)
+{
+    vector<cv::Point2f> tracked = {cv::Point2f(0,0), cv::Point2f(1,0), cv::Point2f(10,10)};
+    // matching the closest pair first (0.6,0) -> (1,0) would leave (1.5,0) without partner
+    vector<cv::Point2f> observed = {cv::Point2f(0.6,0), cv::Point2f(1.5,0), cv::Point2f(5,5), cv::Point2f(10,10.2)};
+
+    vector<int> matches = ObstacleTracker::match(observed, tracked, 0.7);
+
+    ASSERT_EQ(4, matches.size());
+    EXPECT_EQ(0, matches[0]);
+    EXPECT_EQ(1, matches[1]);
+    EXPECT_EQ(-1, matches[2]);
+    EXPECT_EQ(2, matches[3]);
+}
+
 
 // Run all the tests that were declared with TEST()
 int main(int argc, char **argv){
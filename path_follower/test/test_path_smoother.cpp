@@ -0,0 +1,131 @@
+/**
+ * Test of PathSmoother.
+ */
+#include <gtest/gtest.h>
+#include <cmath>
+#include <path_follower/utils/path_smoother.h>
+
+TEST(TestPathSmoother, straightLineIsKept)
+{
+    std::vector<double> x, y;
+    for (int i = 0; i < 20; ++i) {
+        x.push_back(0.1 * i);
+        y.push_back(0.05 * i);
+    }
+    std::vector<double> sx(x), sy(y);
+
+    PathSmoother::smooth(sx, sy, 0.6, 0.15);
+
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        EXPECT_NEAR(x[i], sx[i], 1e-9);
+        EXPECT_NEAR(y[i], sy[i], 1e-9);
+    }
+}
+
+TEST(TestPathSmoother, matchesIterativeSmoothing)
+{
+    const double weight_data = 0.6, weight_smooth = 0.15;
+
+    std::vector<double> x, y;
+    for (int i = 0; i < 50; ++i) {
+        x.push_back(0.1 * i);
+        y.push_back(std::sin(0.3 * i) + ((i % 2) ? 0.05 : -0.05));
+    }
+
+    // run the iterative smoothing until it has converged
+    std::vector<double> ix(x), iy(y);
+    for (int it = 0; it < 10000; ++it) {
+        for (std::size_t i = 2; i < x.size() - 2; ++i) {
+            ix[i] += weight_data * (x[i] - ix[i]);
+            ix[i] += weight_smooth * (ix[i+1] + ix[i-1] - 2 * ix[i]);
+            iy[i] += weight_data * (y[i] - iy[i]);
+            iy[i] += weight_smooth * (iy[i+1] + iy[i-1] - 2 * iy[i]);
+        }
+    }
+
+    std::vector<double> sx(x), sy(y);
+    PathSmoother::smooth(sx, sy, weight_data, weight_smooth);
+
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        EXPECT_NEAR(ix[i], sx[i], 1e-9);
+        EXPECT_NEAR(iy[i], sy[i], 1e-9);
+    }
+    // the end points are fixed
+    EXPECT_EQ(y[0], sy[0]);
+    EXPECT_EQ(y[1], sy[1]);
+    EXPECT_EQ(y[48], sy[48]);
+    EXPECT_EQ(y[49], sy[49]);
+}
+
+TEST(TestPathSmoother, isCloseToPreviousSmoothing)
+{
+    std::vector<double> x, y;
+    for (int i = 0; i < 50; ++i) {
+        x.push_back(0.1 * i);
+        y.push_back(std::sin(0.3 * i) + ((i % 2) ? 0.05 : -0.05));
+    }
+
+    // weights of the global and the final smoothing of the planner
+    const double weights[2][2] = { { 0.6, 0.15 }, { 2.0, 0.4 } };
+    for (const auto& w : weights) {
+        const double weight_data = w[0], weight_smooth = w[1], tolerance = 0.000001;
+
+        // the previous smoothing stopped as soon as the change was no longer growing
+        std::vector<double> ix(x), iy(y);
+        double last_change = -2 * tolerance;
+        double change = 0;
+        while (change > last_change + tolerance) {
+            last_change = change;
+            change = 0;
+            for (std::size_t i = 2; i < x.size() - 2; ++i) {
+                double ddx = weight_data * (x[i] - ix[i]);
+                double ddy = weight_data * (y[i] - iy[i]);
+                ix[i] += ddx;
+                iy[i] += ddy;
+                double dsx = weight_smooth * (ix[i+1] + ix[i-1] - 2 * ix[i]);
+                double dsy = weight_smooth * (iy[i+1] + iy[i-1] - 2 * iy[i]);
+                ix[i] += dsx;
+                iy[i] += dsy;
+                change += std::hypot(ddx, ddy) + std::hypot(dsx, dsy);
+            }
+        }
+
+        std::vector<double> sx(x), sy(y);
+        ASSERT_TRUE(PathSmoother::smooth(sx, sy, weight_data, weight_smooth));
+
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            EXPECT_NEAR(ix[i], sx[i], 0.01);
+            EXPECT_NEAR(iy[i], sy[i], 0.01);
+        }
+    }
+}
+
+TEST(TestPathSmoother, unstableWeightsAreRejected)
+{
+    std::vector<double> x = {0, 1, 2, 3, 4, 5, 6}, y = {0, 1, 0, 1, 0, 1, 0};
+    std::vector<double> sx(x), sy(y);
+
+    EXPECT_FALSE(PathSmoother::smooth(sx, sy, 0.6, 0.5));
+    EXPECT_FALSE(PathSmoother::smooth(sx, sy, 0.0, 0.15));
+    EXPECT_FALSE(PathSmoother::smooth(sx, sy, -1.0, 0.6));
+
+    EXPECT_EQ(x, sx);
+    EXPECT_EQ(y, sy);
+}
+
+TEST(TestPathSmoother, shortPathIsUnchanged)
+{
+    std::vector<double> x = {0, 1, 2, 3}, y = {0, 1, 0, 1};
+    std::vector<double> sx(x), sy(y);
+
+    EXPECT_TRUE(PathSmoother::smooth(sx, sy, 0.6, 0.15));
+
+    EXPECT_EQ(x, sx);
+    EXPECT_EQ(y, sy);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
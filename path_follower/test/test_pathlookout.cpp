@@ -1,5 +1,5 @@
 #include <gtest/gtest.h>
-#include <list>
+#include <vector>
 #include <algorithm>
 #include <opencv2/core/core.hpp>
 #include <path_follower/supervisor/pathlookout.h>
@@ -9,7 +9,7 @@ using namespace std;
 // Declare a test
 TEST(TestPathLookout, clusterPoints)
 {
-    list<cv::Point2f> obs1; // size = 6
+    vector<cv::Point2f> obs1; // size = 6
     obs1.push_back(cv::Point2f(1,1));
     obs1.push_back(cv::Point2f(1,3));
     obs1.push_back(cv::Point2f(2,1));
@@ -17,14 +17,14 @@ TEST(TestPathLookout, clusterPoints)
     obs1.push_back(cv::Point2f(3,2));
     obs1.push_back(cv::Point2f(4,2));
 
-    list<cv::Point2f> obs2; // size = 5
+    vector<cv::Point2f> obs2; // size = 5
     obs2.push_back(cv::Point2f(2,6));
     obs2.push_back(cv::Point2f(3,6));
     obs2.push_back(cv::Point2f(4,6));
     obs2.push_back(cv::Point2f(5,7));
     obs2.push_back(cv::Point2f(6,6));
 
-    list<cv::Point2f> obs3; // size = 8
+    vector<cv::Point2f> obs3; // size = 8
     obs3.push_back(cv::Point2f( 9,2));
     obs3.push_back(cv::Point2f(10,2));
     obs3.push_back(cv::Point2f(11,2));
@@ -34,14 +34,14 @@ TEST(TestPathLookout, clusterPoints)
     obs3.push_back(cv::Point2f(11,6));
     obs3.push_back(cv::Point2f(13,2));
 
-    list<cv::Point2f> obs4; // size = 1
+    vector<cv::Point2f> obs4; // size = 1
     obs4.push_back(cv::Point2f(16,4));
 
-    list<cv::Point2f> obs5; // size = 2
+    vector<cv::Point2f> obs5; // size = 2
     obs5.push_back(cv::Point2f(11,8.5));
     obs5.push_back(cv::Point2f(11,10));
 
-    list<list<cv::Point2f> > ordered_obstacles;
+    vector<vector<cv::Point2f> > ordered_obstacles;
     ordered_obstacles.push_back(obs4);
     ordered_obstacles.push_back(obs5);
     ordered_obstacles.push_back(obs2);
@@ -50,30 +50,28 @@ TEST(TestPathLookout, clusterPoints)
 
 
     // merge all obstacles together
-    list<cv::Point2f> points;
-    points.splice(points.end(), obs1);
-    points.splice(points.end(), obs2);
-    points.splice(points.end(), obs3);
-    points.splice(points.end(), obs4);
-    points.splice(points.end(), obs5);
+    vector<cv::Point2f> points;
+    points.insert(points.end(), obs1.begin(), obs1.end());
+    points.insert(points.end(), obs2.begin(), obs2.end());
+    points.insert(points.end(), obs3.begin(), obs3.end());
+    points.insert(points.end(), obs4.begin(), obs4.end());
+    points.insert(points.end(), obs5.begin(), obs5.end());
 
     // shuffle points
-    vector<cv::Point2f> v_points(points.begin(), points.end());
-    random_shuffle(v_points.begin(), v_points.end());
-    points.assign(v_points.begin(), v_points.end());
+    random_shuffle(points.begin(), points.end());
 
     // cluster with threshold 2
-    list<list<cv::Point2f> > clusters = PathLookout::clusterPoints(points, 2);
+    vector<vector<cv::Point2f> > clusters = PathLookout::clusterPoints(points, 2);
 
     // expect 5 clusters
     ASSERT_EQ(5, clusters.size());
 
     // order clusters by size
-    clusters.sort([](list<cv::Point2f> &a, list<cv::Point2f> &b) { return a.size() < b.size(); });
+    sort(clusters.begin(), clusters.end(), [](const vector<cv::Point2f> &a, const vector<cv::Point2f> &b) { return a.size() < b.size(); });
 
     // order each cluster by (x,y)
-    for_each(clusters.begin(), clusters.end(), [](list<cv::Point2f> &c) {
-        c.sort([](cv::Point2f &a, cv::Point2f &b){
+    for_each(clusters.begin(), clusters.end(), [](vector<cv::Point2f> &c) {
+        sort(c.begin(), c.end(), [](const cv::Point2f &a, const cv::Point2f &b){
             return (a.x < b.x) || ((a.x == b.x) && (a.y < b.y));
         });
     });
@@ -91,6 +89,40 @@ TEST(TestPathLookout, clusterPoints)
     }
 }
 
+TEST(TestPathLookout, clusterPointsSeparatesDiagonalNeighbours)
+{
+    // cluster 1 bridges the gap between 2 and 3 along x, so all points form one cluster along x.
+    // 2 and 3 overlap along y, but they are more than the threshold apart.
+    //
+    //              1 1 1 1 1 1
+    //
+    // y  2 2 2 2 2 2           3 3 3 3 3 3
+    // |
+    // +--x
+    vector<cv::Point2f> points;
+    for (int i = 0; i < 6; ++i) {
+        points.push_back(cv::Point2f(6 + i, 10));   // 1
+        points.push_back(cv::Point2f(i, 0));        // 2
+        points.push_back(cv::Point2f(12 + i, 0));   // 3
+    }
+
+    vector<vector<cv::Point2f> > clusters = PathLookout::clusterPoints(points, 2);
+
+    ASSERT_EQ(3, clusters.size());
+    for (const vector<cv::Point2f> &c : clusters) {
+        EXPECT_EQ(6, c.size());
+    }
+}
+
+TEST(TestPathLookout, clusterPointsDuplicates)
+{
+    vector<cv::Point2f> points(10, cv::Point2f(1, 1));
+    points.push_back(cv::Point2f(5, 5));
+
+    ASSERT_EQ(2, PathLookout::clusterPoints(points, 0).size());
+    ASSERT_TRUE(PathLookout::clusterPoints(vector<cv::Point2f>(), 1).empty());
+}
+
 
 // Run all the tests that were declared with TEST()
 int main(int argc, char **argv){
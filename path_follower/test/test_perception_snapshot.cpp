@@ -0,0 +1,85 @@
+/**
+ * Test of the PerceptionInputs snapshot exchange.
+ */
+#include <gtest/gtest.h>
+#include <path_follower/utils/perception_snapshot.h>
+#include <path_follower/utils/obstacle_cloud.h>
+#include <path_follower/utils/elevation_map.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(TestPerceptionSnapshot, snapshotIsNotAffectedByUpdates)
+{
+    PerceptionInputs inputs;
+    PerceptionSnapshot::ConstPtr empty = inputs.snapshot();
+    ASSERT_NE(nullptr, empty);
+    EXPECT_EQ(0u, empty->generation);
+
+    auto cloud = std::make_shared<ObstacleCloud>();
+    inputs.setObstacleCloud(cloud);
+    PerceptionSnapshot::ConstPtr first = inputs.snapshot();
+    EXPECT_EQ(1u, first->generation);
+    EXPECT_EQ(cloud, first->obstacle_cloud);
+
+    auto map = std::make_shared<ElevationMap>();
+    inputs.setElevationMap(map);
+    PerceptionSnapshot::ConstPtr second = inputs.snapshot();
+    EXPECT_EQ(2u, second->generation);
+    EXPECT_EQ(cloud, second->obstacle_cloud);
+    EXPECT_EQ(map, second->elevation_map);
+
+    // older snapshots stay unchanged
+    EXPECT_EQ(nullptr, empty->obstacle_cloud);
+    EXPECT_EQ(nullptr, first->elevation_map);
+}
+
+TEST(TestPerceptionSnapshot, concurrentUpdatesAreNotLost)
+{
+    PerceptionInputs inputs;
+    const int writers = 4;
+    const int updates = 2000;
+
+    std::atomic<bool> done(false);
+    std::atomic<bool> monotonic(true);
+    std::thread reader([&]() {
+        std::uint64_t last = 0;
+        while(!done) {
+            PerceptionSnapshot::ConstPtr s = inputs.snapshot();
+            if(s->generation < last) {
+                monotonic = false;
+            }
+            last = s->generation;
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for(int w = 0; w < writers; ++w) {
+        threads.emplace_back([&inputs, w, updates]() {
+            for(int i = 0; i < updates; ++i) {
+                if(w % 2 == 0) {
+                    inputs.setObstacleCloud(std::make_shared<ObstacleCloud>());
+                } else {
+                    inputs.setElevationMap(std::make_shared<ElevationMap>());
+                }
+            }
+        });
+    }
+    for(std::thread& t : threads) {
+        t.join();
+    }
+    done = true;
+    reader.join();
+
+    PerceptionSnapshot::ConstPtr last = inputs.snapshot();
+    EXPECT_EQ((std::uint64_t) writers * updates, last->generation);
+    EXPECT_NE(nullptr, last->obstacle_cloud);
+    EXPECT_NE(nullptr, last->elevation_map);
+    EXPECT_TRUE(monotonic);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
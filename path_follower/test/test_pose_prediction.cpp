@@ -0,0 +1,61 @@
+/**
+ * Test of the pose extrapolation of PoseTracker.
+ */
+#include <gtest/gtest.h>
+#include <path_follower/utils/pose_tracker.h>
+
+namespace {
+geometry_msgs::Twist twist(double vx, double vy, double w)
+{
+    geometry_msgs::Twist t;
+    t.linear.x = vx;
+    t.linear.y = vy;
+    t.angular.z = w;
+    return t;
+}
+}
+
+TEST(TestPosePrediction, straightMotionInBodyFrame)
+{
+    Eigen::Vector3d pose(1.0, 2.0, M_PI / 2);
+    Eigen::Vector3d p = PoseTracker::extrapolate(pose, twist(1.0, 0.5, 0.0), 0.1);
+
+    EXPECT_NEAR(1.0 - 0.05, p.x(), 1e-9);
+    EXPECT_NEAR(2.0 + 0.1, p.y(), 1e-9);
+    EXPECT_NEAR(M_PI / 2, p(2), 1e-9);
+}
+
+TEST(TestPosePrediction, arcOfConstantTwist)
+{
+    // a quarter circle of radius 1
+    Eigen::Vector3d pose(0.0, 0.0, 0.0);
+    Eigen::Vector3d p = PoseTracker::extrapolate(pose, twist(M_PI / 2, 0.0, M_PI / 2), 1.0);
+
+    EXPECT_NEAR(1.0, p.x(), 1e-9);
+    EXPECT_NEAR(1.0, p.y(), 1e-9);
+    EXPECT_NEAR(M_PI / 2, p(2), 1e-9);
+}
+
+TEST(TestPosePrediction, matchesFineIntegration)
+{
+    Eigen::Vector3d pose(-0.5, 0.3, 2.5);
+    geometry_msgs::Twist t = twist(0.8, -0.2, 1.3);
+
+    Eigen::Vector3d fine = pose;
+    const int steps = 10000;
+    for(int i = 0; i < steps; ++i) {
+        fine = PoseTracker::extrapolate(fine, twist(t.linear.x, t.linear.y, 0.0), 0.08 / steps);
+        fine(2) += t.angular.z * 0.08 / steps;
+    }
+    Eigen::Vector3d p = PoseTracker::extrapolate(pose, t, 0.08);
+
+    EXPECT_NEAR(fine.x(), p.x(), 1e-5);
+    EXPECT_NEAR(fine.y(), p.y(), 1e-5);
+    EXPECT_NEAR(std::atan2(std::sin(fine(2)), std::cos(fine(2))), p(2), 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
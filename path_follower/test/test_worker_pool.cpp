@@ -0,0 +1,91 @@
+/**
+ * Test of the WorkerPool.
+ */
+#include <gtest/gtest.h>
+#include <path_follower/utils/worker_pool.h>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(TestWorkerPool, everyIndexIsVisitedOnce)
+{
+    WorkerPool pool(4);
+    ASSERT_EQ(4u, pool.size());
+
+    // repeated loops reuse the same workers
+    for (int run = 0; run < 100; ++run) {
+        std::vector<std::atomic<int>> visits(257);
+        for (auto& v : visits) {
+            v = 0;
+        }
+
+        pool.parallelFor(visits.size(), [&visits](std::size_t i) {
+            ++visits[i];
+        });
+
+        for (std::size_t i = 0; i < visits.size(); ++i) {
+            ASSERT_EQ(1, visits[i]) << "index " << i << " in run " << run;
+        }
+    }
+}
+
+TEST(TestWorkerPool, usesTheWorkerThreads)
+{
+    WorkerPool pool(3);
+
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    std::atomic<int> waiting(0);
+    pool.parallelFor(3, [&](std::size_t) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        }
+        // keep every thread busy until all three indices are taken
+        ++waiting;
+        while (waiting < 3) {
+            std::this_thread::yield();
+        }
+    });
+
+    EXPECT_EQ(3u, ids.size());
+}
+
+TEST(TestWorkerPool, singleThreadRunsOnTheCaller)
+{
+    WorkerPool pool;
+    ASSERT_EQ(1u, pool.size());
+
+    std::vector<std::thread::id> ids;
+    pool.parallelFor(10, [&ids](std::size_t) {
+        ids.push_back(std::this_thread::get_id());
+    });
+
+    ASSERT_EQ(10u, ids.size());
+    for (const auto& id : ids) {
+        EXPECT_EQ(std::this_thread::get_id(), id);
+    }
+}
+
+TEST(TestWorkerPool, canBeResized)
+{
+    WorkerPool pool(2);
+    pool.resize(5);
+    EXPECT_EQ(5u, pool.size());
+
+    std::atomic<int> sum(0);
+    pool.parallelFor(100, [&sum](std::size_t i) {
+        sum += i;
+    });
+    EXPECT_EQ(4950, sum);
+
+    pool.resize(1);
+    EXPECT_EQ(1u, pool.size());
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
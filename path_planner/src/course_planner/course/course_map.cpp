@@ -3,15 +3,30 @@
 #include <ros/console.h>
 #include <visualization_msgs/MarkerArray.h>
 #include <XmlRpcValue.h>
+#include <algorithm>
 
 using namespace Eigen;
 
+namespace {
+const double intersection_eps = 0.0005;
+
+// maximum number of cells of the segment index, the cell size is increased for larger maps
+const double max_index_cells = 1 << 20;
+
+int clampCell(double v, int size)
+{
+    return (int) std::max(0.0, std::min((double) size - 1, std::floor(v)));
+}
+}
+
 CourseMap::CourseMap(ros::NodeHandle &nh)
-    : nh_(nh), pnh_("~")
+    : nh_(nh), pnh_("~"),
+      index_width_(0), index_height_(0)
 {
     pub_viz_ = nh.advertise<visualization_msgs::MarkerArray>("visualization_marker_array", 100, true);
 
     pnh_.param("course/radius", curve_radius, 1.0);
+    pnh_.param("course/index_cell_size", index_cell_size_, 2.0);
 }
 
 CourseMap::~CourseMap()
@@ -58,11 +73,31 @@ const Segment* CourseMap::findClosestSegment(const path_geom::PathPose &pose, do
     double best_dist = max_dist + std::numeric_limits<double>::epsilon();
     const Segment* best_segment = nullptr;
 
-    for(const Segment& segment : segments_) {
-        Eigen::Vector2d delta = segment.line.endPoint() - segment.line.startPoint();
-        double s_yaw = std::atan2(delta(1), delta(0));
+    if(index_offsets_.empty()) {
+        return nullptr;
+    }
 
-        if(std::abs(MathHelper::NormalizeAngle(yaw - s_yaw)) > yaw_tolerance) {
+    // only segments in the cells around pt can be closer than max_dist
+    int min_x = clampCell((pt(0) - best_dist - index_origin_(0)) / index_cell_size_, index_width_);
+    int max_x = clampCell((pt(0) + best_dist - index_origin_(0)) / index_cell_size_, index_width_);
+    int min_y = clampCell((pt(1) - best_dist - index_origin_(1)) / index_cell_size_, index_height_);
+    int max_y = clampCell((pt(1) + best_dist - index_origin_(1)) / index_cell_size_, index_height_);
+
+    std::vector<int> candidates;
+    for(int y = min_y; y <= max_y; ++y) {
+        for(int x = min_x; x <= max_x; ++x) {
+            int cell = y * index_width_ + x;
+            candidates.insert(candidates.end(), index_segments_.begin() + index_offsets_[cell], index_segments_.begin() + index_offsets_[cell + 1]);
+        }
+    }
+    // keep the order of the segments so that ties are resolved as before
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for(int id : candidates) {
+        const Segment& segment = segments_[id];
+
+        if(std::abs(MathHelper::NormalizeAngle(yaw - segment.yaw)) > yaw_tolerance) {
             continue;
         }
 
@@ -81,10 +116,21 @@ void CourseMap::load(const XmlRpc::XmlRpcValue &map_segment_array)
 {
     for(int i =0; i < map_segment_array.size(); i++) {
         segments_.emplace_back(readSegment(map_segment_array, i));
+        segments_.back().id = segments_.size() - 1;
     }
 
+    buildIndex();
+
     for(std::size_t i = 0; i < segments_.size(); ++i) {
-        for(std::size_t j = 0; j < segments_.size(); ++j) {
+        // only segments sharing a cell of the index can intersect
+        std::vector<int> candidates;
+        for(int cell : findIndexCells(segments_.at(i).line, 2 * intersection_eps)) {
+            candidates.insert(candidates.end(), index_segments_.begin() + index_offsets_[cell], index_segments_.begin() + index_offsets_[cell + 1]);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for(std::size_t j : candidates) {
             if(i == j) {
                 continue;
             }
@@ -93,7 +139,7 @@ void CourseMap::load(const XmlRpc::XmlRpcValue &map_segment_array)
             Segment &si = segments_.at(i);
             Segment &sj = segments_.at(j);
 
-            double eps = 0.0005;
+            double eps = intersection_eps;
 
             Eigen::Vector2d intersection;
             if(path_geom::Intersector::intersect(si.line, sj.line, intersection, eps)) {
@@ -111,6 +157,102 @@ void CourseMap::load(const XmlRpc::XmlRpcValue &map_segment_array)
             }
         }
     }
+
+    buildGraph();
+}
+
+void CourseMap::buildIndex()
+{
+    index_offsets_.clear();
+    index_segments_.clear();
+    index_width_ = 0;
+    index_height_ = 0;
+
+    if(segments_.empty()) {
+        return;
+    }
+
+    Eigen::Vector2d min = segments_.front().line.startPoint();
+    Eigen::Vector2d max = min;
+    for(const Segment& segment : segments_) {
+        min = min.cwiseMin(segment.line.startPoint()).cwiseMin(segment.line.endPoint());
+        max = max.cwiseMax(segment.line.startPoint()).cwiseMax(segment.line.endPoint());
+    }
+
+    Eigen::Vector2d extent = max - min;
+    while((extent(0) / index_cell_size_ + 1) * (extent(1) / index_cell_size_ + 1) > max_index_cells) {
+        index_cell_size_ *= 2;
+    }
+
+    index_origin_ = min;
+    index_width_ = (int) std::floor(extent(0) / index_cell_size_) + 1;
+    index_height_ = (int) std::floor(extent(1) / index_cell_size_) + 1;
+
+    std::vector<std::vector<int>> segment_cells(segments_.size());
+    index_offsets_.assign(index_width_ * index_height_ + 1, 0);
+    for(std::size_t i = 0; i < segments_.size(); ++i) {
+        segment_cells[i] = findIndexCells(segments_[i].line, 2 * intersection_eps);
+        for(int cell : segment_cells[i]) {
+            ++index_offsets_[cell + 1];
+        }
+    }
+    for(std::size_t cell = 1; cell < index_offsets_.size(); ++cell) {
+        index_offsets_[cell] += index_offsets_[cell - 1];
+    }
+
+    index_segments_.resize(index_offsets_.back());
+    std::vector<int> fill(index_offsets_.begin(), index_offsets_.end() - 1);
+    for(std::size_t i = 0; i < segments_.size(); ++i) {
+        for(int cell : segment_cells[i]) {
+            index_segments_[fill[cell]++] = i;
+        }
+    }
+}
+
+std::vector<int> CourseMap::findIndexCells(const path_geom::Line& line, double margin) const
+{
+    std::vector<int> cells;
+
+    Eigen::Vector2d s = line.startPoint();
+    Eigen::Vector2d e = line.endPoint();
+
+    int min_x = clampCell((std::min(s(0), e(0)) - margin - index_origin_(0)) / index_cell_size_, index_width_);
+    int max_x = clampCell((std::max(s(0), e(0)) + margin - index_origin_(0)) / index_cell_size_, index_width_);
+    int min_y = clampCell((std::min(s(1), e(1)) - margin - index_origin_(1)) / index_cell_size_, index_height_);
+    int max_y = clampCell((std::max(s(1), e(1)) + margin - index_origin_(1)) / index_cell_size_, index_height_);
+
+    // a cell is touched by the line if its center is at most half a diagonal away
+    double max_dist = index_cell_size_ * std::sqrt(0.5) + margin;
+
+    for(int y = min_y; y <= max_y; ++y) {
+        for(int x = min_x; x <= max_x; ++x) {
+            Eigen::Vector2d center = index_origin_ + Eigen::Vector2d(x + 0.5, y + 0.5) * index_cell_size_;
+            if(line.distanceTo(center) <= max_dist) {
+                cells.push_back(y * index_width_ + x);
+            }
+        }
+    }
+
+    return cells;
+}
+
+void CourseMap::buildGraph()
+{
+    graph_offsets_.assign(segments_.size() + 1, 0);
+    graph_transitions_.clear();
+
+    // the transitions leaving a segment are its forward transitions (to the target) and its backward transitions (to the source)
+    for(Segment& segment : segments_) {
+        for(Transition& t : segment.forward_transitions) {
+            t.id = graph_transitions_.size();
+            graph_transitions_.push_back(&t);
+        }
+        for(Transition& t : segment.backward_transitions) {
+            t.id = graph_transitions_.size();
+            graph_transitions_.push_back(&t);
+        }
+        graph_offsets_[segment.id + 1] = graph_transitions_.size();
+    }
 }
 
 
@@ -385,3 +527,18 @@ const std::vector<Segment>& CourseMap::getSegments() const
 {
     return segments_;
 }
+
+std::size_t CourseMap::getTransitionCount() const
+{
+    return graph_transitions_.size();
+}
+
+const Transition& CourseMap::getTransition(int id) const
+{
+    return *graph_transitions_.at(id);
+}
+
+std::pair<int, int> CourseMap::getTransitionIds(const Segment& segment) const
+{
+    return std::make_pair(graph_offsets_.at(segment.id), graph_offsets_.at(segment.id + 1));
+}
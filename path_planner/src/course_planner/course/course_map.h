@@ -7,6 +7,7 @@
 #include <visualization_msgs/MarkerArray.h>
 
 #include "segment.h"
+#include <utility>
 
 class CourseMap
 {
@@ -22,12 +23,21 @@ public:
     bool hasSegments() const;
     const std::vector<Segment> &getSegments() const;
 
+    std::size_t getTransitionCount() const;
+    const Transition& getTransition(int id) const;
+    // transitions leaving a segment have the ids [first, second)
+    std::pair<int, int> getTransitionIds(const Segment& segment) const;
+
 private:
     static Eigen::Vector2d readPoint(const XmlRpc::XmlRpcValue& value, int index);
     static Segment readSegment(const XmlRpc::XmlRpcValue& value, int index);
 
     void addTransition(Segment &from, Segment &to, const Eigen::Vector2d &intersection);
 
+    void buildIndex();
+    void buildGraph();
+    std::vector<int> findIndexCells(const path_geom::Line& line, double margin) const;
+
     Eigen::Vector2d calculateICR(const Segment &from, const Segment &to, const Eigen::Vector2d& intersection) const;
     double calculateSpan(const Segment &from, const Segment &to, const Eigen::Vector2d &icr) const;
     std::vector<Eigen::Vector2d> calculateCurvePoints(const Segment &from, const Segment &to, const Eigen::Vector2d &icr, double dtheta) const;
@@ -40,6 +50,18 @@ private:
     std::vector<Segment> segments_;
     std::vector<Eigen::Vector2d> intersections_;
 
+    // uniform grid over the segments, cell i contains index_segments_[index_offsets_[i] .. index_offsets_[i+1])
+    Eigen::Vector2d index_origin_;
+    double index_cell_size_;
+    int index_width_;
+    int index_height_;
+    std::vector<int> index_offsets_;
+    std::vector<int> index_segments_;
+
+    // transition graph, the transitions leaving segment s have the ids [graph_offsets_[s], graph_offsets_[s+1])
+    std::vector<int> graph_offsets_;
+    std::vector<const Transition*> graph_transitions_;
+
     ros::NodeHandle& nh_;
     ros::NodeHandle pnh_;
     ros::Publisher pub_viz_;
@@ -0,0 +1,127 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <vector>
+
+/**
+ * @brief Min-heap with D children per node over the ids [0, n).
+ * Keeps the position of every id in the heap, so that the key of a queued id can be changed in place.
+ */
+template <int D>
+class IndexedHeap
+{
+public:
+    void reset(std::size_t n)
+    {
+        heap_.clear();
+        position_.assign(n, -1);
+    }
+
+    bool empty() const
+    {
+        return heap_.empty();
+    }
+
+    bool contains(int id) const
+    {
+        return position_[id] >= 0;
+    }
+
+    /**
+     * @brief push inserts <id> or changes its key if it is already queued
+     */
+    void push(int id, double key)
+    {
+        int pos = position_[id];
+        if(pos < 0) {
+            pos = heap_.size();
+            heap_.push_back(Entry { key, id });
+            position_[id] = pos;
+            siftUp(pos);
+
+        } else if(key < heap_[pos].key) {
+            heap_[pos].key = key;
+            siftUp(pos);
+
+        } else {
+            heap_[pos].key = key;
+            siftDown(pos);
+        }
+    }
+
+    double topKey() const
+    {
+        return heap_.front().key;
+    }
+
+    int pop()
+    {
+        int id = heap_.front().id;
+        position_[id] = -1;
+
+        Entry last = heap_.back();
+        heap_.pop_back();
+        if(!heap_.empty()) {
+            heap_[0] = last;
+            position_[last.id] = 0;
+            siftDown(0);
+        }
+
+        return id;
+    }
+
+private:
+    struct Entry {
+        double key;
+        int id;
+    };
+
+    void siftUp(int pos)
+    {
+        Entry e = heap_[pos];
+        while(pos > 0) {
+            int parent = (pos - 1) / D;
+            if(!(e.key < heap_[parent].key)) {
+                break;
+            }
+            heap_[pos] = heap_[parent];
+            position_[heap_[pos].id] = pos;
+            pos = parent;
+        }
+        heap_[pos] = e;
+        position_[e.id] = pos;
+    }
+
+    void siftDown(int pos)
+    {
+        Entry e = heap_[pos];
+        int n = heap_.size();
+        while(true) {
+            int first = pos * D + 1;
+            if(first >= n) {
+                break;
+            }
+            int last = first + D < n ? first + D : n;
+            int best = first;
+            for(int c = first + 1; c < last; ++c) {
+                if(heap_[c].key < heap_[best].key) {
+                    best = c;
+                }
+            }
+            if(!(heap_[best].key < e.key)) {
+                break;
+            }
+            heap_[pos] = heap_[best];
+            position_[heap_[pos].id] = pos;
+            pos = best;
+        }
+        heap_[pos] = e;
+        position_[e.id] = pos;
+    }
+
+private:
+    std::vector<Entry> heap_;
+    std::vector<int> position_;
+};
+
+#endif // INDEXED_HEAP_H
@@ -0,0 +1,158 @@
+#ifndef ROUTE_CACHE_H
+#define ROUTE_CACHE_H
+
+#include <Eigen/Core>
+#include <cmath>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Least recently used cache of course routes (the chain of transition ids).
+ * Routes are keyed by the start / end segment and the start / end point on these segments,
+ * quantised to cells of <resolution> meters. Only the transition chain is cached, the caller
+ * has to rebuild the geometry of the route from the exact start and end point.
+ */
+class RouteCache
+{
+public:
+    struct Key {
+        int start_segment;
+        int end_segment;
+        long start_x, start_y;
+        long end_x, end_y;
+
+        bool operator == (const Key& other) const {
+            return start_segment == other.start_segment && end_segment == other.end_segment &&
+                    start_x == other.start_x && start_y == other.start_y &&
+                    end_x == other.end_x && end_y == other.end_y;
+        }
+    };
+
+    RouteCache(int capacity = 0, double resolution = 0.2)
+        : capacity_(capacity), resolution_(resolution),
+          hits_(0), misses_(0)
+    {
+    }
+
+    void configure(int capacity, double resolution)
+    {
+        capacity_ = capacity;
+        resolution_ = resolution;
+        clear();
+    }
+
+    bool enabled() const
+    {
+        return capacity_ > 0;
+    }
+
+    Key makeKey(int start_segment, const Eigen::Vector2d& start_pt,
+                int end_segment, const Eigen::Vector2d& end_pt) const
+    {
+        return Key { start_segment, end_segment,
+                    quantise(start_pt.x()), quantise(start_pt.y()),
+                    quantise(end_pt.x()), quantise(end_pt.y()) };
+    }
+
+    /**
+     * @brief find returns the cached route for <key> and marks it as most recently used
+     * @return nullptr, if the key is not cached
+     */
+    const std::vector<int>* find(const Key& key)
+    {
+        if(!enabled()) {
+            return nullptr;
+        }
+
+        auto pos = index_.find(key);
+        if(pos == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, pos->second);
+        return &pos->second->second;
+    }
+
+    /**
+     * @brief insert caches <route> for <key>, evicting the least recently used route if the cache is full
+     */
+    void insert(const Key& key, const std::vector<int>& route)
+    {
+        if(!enabled() || route.empty()) {
+            return;
+        }
+
+        auto pos = index_.find(key);
+        if(pos != index_.end()) {
+            pos->second->second = route;
+            entries_.splice(entries_.begin(), entries_, pos->second);
+            return;
+        }
+
+        if((int) entries_.size() >= capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+
+        entries_.emplace_front(key, route);
+        index_[key] = entries_.begin();
+    }
+
+    void clear()
+    {
+        entries_.clear();
+        index_.clear();
+    }
+
+    std::size_t size() const
+    {
+        return entries_.size();
+    }
+
+    long getHits() const
+    {
+        return hits_;
+    }
+
+    long getMisses() const
+    {
+        return misses_;
+    }
+
+private:
+    long quantise(double v) const
+    {
+        return std::lround(std::floor(v / resolution_));
+    }
+
+    struct KeyHash {
+        std::size_t operator () (const Key& key) const {
+            std::size_t h = key.start_segment;
+            h = h * 31 + key.end_segment;
+            h = h * 31 + key.start_x;
+            h = h * 31 + key.start_y;
+            h = h * 31 + key.end_x;
+            h = h * 31 + key.end_y;
+            return h;
+        }
+    };
+
+    typedef std::list<std::pair<Key, std::vector<int>>> EntryList;
+
+private:
+    int capacity_;
+    double resolution_;
+
+    // most recently used route first
+    EntryList entries_;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+
+    long hits_;
+    long misses_;
+};
+
+#endif // ROUTE_CACHE_H
@@ -4,24 +4,18 @@
 #include <ros/console.h>
 #include <nav_msgs/OccupancyGrid.h>
 #include <nav_msgs/GetMap.h>
-#include <set>
 #include <tf/tf.h>
 
 #include "course_map.h"
 
 #include "near_course_test.hpp"
 
-namespace {
-bool comp (const Node* lhs, const Node* rhs)
-{
-    return lhs->cost<rhs->cost;
-}
-}
-
 Search::Search(const CourseMap& generator)
     : pnh_("~"),
       cost_calculator_(*this),
-      generator_(generator)
+      generator_(generator),
+      expansions(0),
+      search_time(0.0)
 {    
     pnh_.param("size/forward", size_forward, 0.4);
     pnh_.param("size/backward", size_backward, -0.6);
@@ -29,6 +23,36 @@ Search::Search(const CourseMap& generator)
 
     pnh_.param("max_distance_for_direct_try", max_distance_for_direct_try, 7.0);
     pnh_.param("max_time_for_direct_try", max_time_for_direct_try, 1.0);
+
+    // A* with the euclidean distance to the end point, admissible as long as course/penalty/backwards >= 1
+    pnh_.param("course/use_astar", use_astar, false);
+
+    // repeated requests between (nearly) the same poses reuse the transitions of a previous search
+    int route_cache_size;
+    double route_cache_resolution;
+    pnh_.param("course/route_cache/size", route_cache_size, 256);
+    pnh_.param("course/route_cache/resolution", route_cache_resolution, 0.2);
+    route_cache.configure(route_cache_size, route_cache_resolution);
+}
+
+int Search::getExpansions() const
+{
+    return expansions;
+}
+
+double Search::getSearchTime() const
+{
+    return search_time;
+}
+
+long Search::getRouteCacheHits() const
+{
+    return route_cache.getHits();
+}
+
+long Search::getRouteCacheMisses() const
+{
+    return route_cache.getMisses();
 }
 
 
@@ -39,6 +63,9 @@ path_msgs::PathSequence Search::findPath(lib_path::SimpleGridMap2d * map,
 {
     map_info = map;
 
+    expansions = 0;
+    search_time = 0.0;
+
     options_ = goal.options;
     world_frame_ = goal.goal.pose.header.frame_id;
     time_stamp_ = goal.goal.pose.header.stamp;
@@ -116,50 +143,73 @@ path_msgs::PathSequence Search::tryDirectPath(const path_geom::PathPose& start,
 
 path_msgs::PathSequence Search::performDijkstraSearch()
 {
+    ros::WallTime search_start = ros::WallTime::now();
+
+    RouteCache::Key route_key = route_cache.makeKey(start_segment->id, start_pt, end_segment->id, end_pt);
+    if(findCachedRoute(route_key)) {
+        search_time = (ros::WallTime::now() - search_start).toSec();
+        ROS_DEBUG_STREAM("course search reused cached route with " << best_route.size() << " transitions");
+
+        PathBuilder path_builder(*this);
+        path_builder.addPath(start_appendix);
+        path_builder.addPath(best_path);
+        path_builder.addPath(end_appendix);
+
+        return path_builder;
+    }
+
     initNodes();
 
-    std::set<Node*, bool(*)(const Node*, const Node*)> priority_queue(&comp);
+    queue.reset(nodes.size());
 
-    enqueueStartingNodes(priority_queue);
+    enqueueStartingNodes();
 
     min_cost = std::numeric_limits<double>::infinity();
+    best_path = path_msgs::PathSequence();
+    best_route.clear();
 
-    while(!priority_queue.empty()) {
-        Node* current_node = *priority_queue.begin();
-        priority_queue.erase(priority_queue.begin());
+    while(!queue.empty()) {
+        // costs never decrease along a path -> no queued node can lead to a cheaper candidate
+        if(queue.topKey() >= min_cost) {
+            break;
+        }
+
+        Node* current_node = &nodes[queue.pop()];
+        ++expansions;
 
         if(current_node->next_segment == end_segment) {
             generatePathCandidate(current_node);
             continue;
         }
 
-        for(int i = 0; i <= 1; ++i) {
-            const auto& transitions =  i == 0 ? current_node->next_segment->forward_transitions : current_node->next_segment->backward_transitions;
-            for(const Transition& next_transition : transitions) {
-                Node* neighbor = &nodes.at(&next_transition);
+        std::pair<int, int> ids = generator_.getTransitionIds(*current_node->next_segment);
+        for(int id = ids.first; id < ids.second; ++id) {
+            Node* neighbor = &nodes[id];
+            const Transition& next_transition = *neighbor->transition;
 
-                double curve_cost = cost_calculator_.calculateCurveCost(current_node);
-                double straight_cost = cost_calculator_.calculateStraightCost(current_node,
-                                                                      cost_calculator_.findStartPointOnSegment(current_node),
-                                                                      cost_calculator_.findEndPointOnSegment(current_node, &next_transition));
+            double curve_cost = cost_calculator_.calculateCurveCost(current_node);
+            double straight_cost = cost_calculator_.calculateStraightCost(current_node,
+                                                                  cost_calculator_.findStartPointOnSegment(current_node),
+                                                                  cost_calculator_.findEndPointOnSegment(current_node, &next_transition));
 
-                double new_cost = current_node->cost + curve_cost + straight_cost;
+            double new_cost = current_node->cost + curve_cost + straight_cost;
 
-                if(new_cost < neighbor->cost) {
-                    neighbor->cost = new_cost;
+            if(new_cost < neighbor->cost) {
+                neighbor->cost = new_cost;
 
-                    neighbor->prev = current_node;
-                    current_node->next = neighbor;
+                neighbor->prev = current_node;
+                current_node->next = neighbor;
 
-                    if(priority_queue.find(neighbor) != priority_queue.end()) {
-                        priority_queue.erase(neighbor);
-                    }
-                    priority_queue.insert(neighbor);
-                }
+                enqueue(neighbor);
             }
         }
     }
 
+    search_time = (ros::WallTime::now() - search_start).toSec();
+    ROS_DEBUG_STREAM("course search expanded " << expansions << " nodes in " << search_time * 1e3 << "ms");
+
+    route_cache.insert(route_key, best_route);
+
     PathBuilder path_builder(*this);
     path_builder.addPath(start_appendix);
     path_builder.addPath(best_path);
@@ -168,37 +218,84 @@ path_msgs::PathSequence Search::performDijkstraSearch()
     return path_builder;
 }
 
-void Search::enqueueStartingNodes(std::set<Node*, bool(*)(const Node*, const Node*)>& queue)
+bool Search::findCachedRoute(const RouteCache::Key& key)
 {
-    for(int i = 0; i <= 1; ++i) {
-        const auto& transitions = i == 0 ? start_segment->forward_transitions : start_segment->backward_transitions;
-        for(const Transition& next_transition : transitions) {
+    const std::vector<int>* route = route_cache.find(key);
+    if(!route) {
+        return false;
+    }
+
+    best_route = *route;
 
-            Node* node = &nodes.at(&next_transition);
+    if(nodes.size() != generator_.getTransitionCount()) {
+        initNodes();
+    }
 
-            // distance from start_pt to transition
-            Eigen::Vector2d  end_point_on_segment = node->curve_forward ? next_transition.path.front() : next_transition.path.back();
-            node->cost = cost_calculator_.calculateStraightCost(node, start_pt, end_point_on_segment);
-            queue.insert(node);
+    // only the chain of the route is needed to build the path
+    std::deque<const Node*> transitions;
+    Node* prev = nullptr;
+    for(int id : best_route) {
+        Node* node = &nodes[id];
+        node->prev = prev;
+        node->next = nullptr;
+        if(prev) {
+            prev->next = node;
         }
+        transitions.push_back(node);
+        prev = node;
+    }
+
+    PathBuilder path_builder(*this);
+    generatePath(transitions, path_builder);
+    best_path = path_builder;
+
+    return true;
+}
+
+void Search::enqueueStartingNodes()
+{
+    std::pair<int, int> ids = generator_.getTransitionIds(*start_segment);
+    for(int id = ids.first; id < ids.second; ++id) {
+        Node* node = &nodes[id];
+        const Transition& next_transition = *node->transition;
+
+        // distance from start_pt to transition
+        Eigen::Vector2d  end_point_on_segment = node->curve_forward ? next_transition.path.front() : next_transition.path.back();
+        node->cost = cost_calculator_.calculateStraightCost(node, start_pt, end_point_on_segment);
+        enqueue(node);
     }
 }
 
+void Search::enqueue(Node* node)
+{
+    double key = node->cost;
+    if(use_astar) {
+        key += (cost_calculator_.findStartPointOnSegment(node) - end_pt).norm();
+    }
+    queue.push(node->transition->id, key);
+}
+
 void Search::initNodes()
 {
-    nodes.clear();
-    for(const Segment& s : generator_.getSegments()) {
-        for(const Transition& t : s.forward_transitions) {
-            nodes[&t].transition = &t;
-            nodes[&t].curve_forward = true;
-            nodes[&t].next_segment = t.target;
-        }
-        for(const Transition& t : s.backward_transitions) {
-            nodes[&t].transition = &t;
-            nodes[&t].curve_forward = false;
-            nodes[&t].next_segment = t.source;
+    // the graph of the course map does not change, the initial nodes are only built once
+    if(initial_nodes.size() != generator_.getTransitionCount()) {
+        initial_nodes.clear();
+        initial_nodes.resize(generator_.getTransitionCount());
+        for(const Segment& s : generator_.getSegments()) {
+            for(const Transition& t : s.forward_transitions) {
+                initial_nodes[t.id].transition = &t;
+                initial_nodes[t.id].curve_forward = true;
+                initial_nodes[t.id].next_segment = t.target;
+            }
+            for(const Transition& t : s.backward_transitions) {
+                initial_nodes[t.id].transition = &t;
+                initial_nodes[t.id].curve_forward = false;
+                initial_nodes[t.id].next_segment = t.source;
+            }
         }
     }
+
+    nodes = initial_nodes;
 }
 
 bool Search::findAppendices(const path_geom::PathPose& start_pose, const path_geom::PathPose& end_pose)
@@ -214,11 +311,11 @@ bool Search::findAppendices(const path_geom::PathPose& start_pose, const path_ge
     path_geom::PathPose start(start_msg.pose.position.x, start_msg.pose.position.y,
                               tf::getYaw(start_msg.pose.orientation));
     start_segment = generator_.findClosestSegment(start, M_PI / 8, 0.5);
-    start_pt = start_segment->line.nearestPointTo(start.pos_);
     if(!start_segment) {
         ROS_ERROR_STREAM("cannot find a path for start pose " << start.pos_);
         return false;
     }
+    start_pt = start_segment->line.nearestPointTo(start.pos_);
 
 
     end_appendix = findAppendix(end_pose, "end", true);
@@ -351,6 +448,11 @@ void Search::generatePathCandidate(Node* node)
         generatePath(transitions, path_builder);
         best_path = path_builder;
 
+        best_route.clear();
+        for(const Node* n : transitions) {
+            best_route.push_back(n->transition->id);
+        }
+
         ROS_DEBUG_STREAM("best path has " << best_path.paths.size() << " paths");
         for(const auto& path : best_path.paths) {
             ROS_DEBUG_STREAM("* poses: " << path.poses.size() << ", direction: " << (bool) path.forward);
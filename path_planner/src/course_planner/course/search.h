@@ -17,6 +17,8 @@
 #include "node.h"
 #include "path_builder.h"
 #include "cost_calculator.h"
+#include "indexed_heap.h"
+#include "route_cache.h"
 
 class CourseMap;
 
@@ -35,6 +37,14 @@ public:
 
     path_msgs::PathSequence findPath(lib_path::SimpleGridMap2d *map, const path_msgs::PlanPathGoal &goal, const path_geom::PathPose& start, const path_geom::PathPose& end);
 
+    // statistics of the last graph search
+    int getExpansions() const;
+    double getSearchTime() const;
+
+    // statistics of the route cache
+    long getRouteCacheHits() const;
+    long getRouteCacheMisses() const;
+
 private:
     path_msgs::PathSequence tryDirectPath(const path_geom::PathPose& start, const path_geom::PathPose& end);
 
@@ -44,7 +54,10 @@ private:
     path_msgs::PathSequence performDijkstraSearch();
     void initNodes();
 
-    void enqueueStartingNodes(std::set<Node *, bool(*)(const Node *, const Node *)> &queue);
+    bool findCachedRoute(const RouteCache::Key& key);
+
+    void enqueueStartingNodes();
+    void enqueue(Node* node);
 
     void generatePathCandidate(Node* current_node);
     void generatePath(const std::deque<const Node *> &path_transitions, PathBuilder &path_builder) const;
@@ -75,11 +88,18 @@ private:
     double max_distance_for_direct_try;
     double max_time_for_direct_try;
 
+    bool use_astar;
+
     path_msgs::PathSequence start_appendix;
     path_msgs::PathSequence end_appendix;
 
-    // search parameters
-    std::map<const Transition*, Node> nodes;
+    // search parameters, nodes are indexed by the transition id
+    std::vector<Node> nodes;
+    std::vector<Node> initial_nodes;
+    IndexedHeap<4> queue;
+
+    int expansions;
+    double search_time;
 
     const Segment* start_segment;
     const Segment* end_segment;
@@ -88,6 +108,10 @@ private:
 
     double min_cost;
     path_msgs::PathSequence best_path;
+    // transition ids of best_path
+    std::vector<int> best_route;
+
+    RouteCache route_cache;
 };
 
 #endif // SEARCH_H
@@ -1,6 +1,8 @@
 #include "segment.h"
 
 Segment::Segment(const path_geom::Line& line)
-    : line(line)
+    : line(line), id(-1)
 {
+    Eigen::Vector2d delta = line.endPoint() - line.startPoint();
+    yaw = std::atan2(delta(1), delta(0));
 }
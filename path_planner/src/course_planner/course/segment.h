@@ -8,6 +8,11 @@ class Segment
 {
 public:
     path_geom::Line line;
+
+    // index in the course map and direction of the segment
+    int id;
+    double yaw;
+
     std::vector<Transition> forward_transitions;
     std::vector<Transition> backward_transitions;
 
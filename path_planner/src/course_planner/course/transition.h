@@ -10,6 +10,9 @@ class Transition {
 public:
     double arc_length() const;
 
+    // index in the transition graph of the course map
+    int id = -1;
+
     const Segment* source;
     const Segment* target;
 
@@ -164,5 +164,7 @@ path_msgs::PathSequence CoursePlanner::plan (const path_msgs::PlanPathGoal &goal
     auto res = course_search_.findPath(map_info, goal, from_world_p, to_world_p);
     res.header = goal.goal.pose.header;
 
+    reportSearchStatistics(course_search_.getExpansions(), course_search_.getSearchTime());
+
     return res;
 }
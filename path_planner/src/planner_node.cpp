@@ -2,6 +2,7 @@
 #include "planner_node.h"
 
 /// PROJECT
+#include "path_smoother.h"
 #include <cslibs_path_planning/common/CollisionGridMap2d.h>
 #include <cslibs_path_planning/common/RotatedGridMap2d.h>
 #include <cslibs_path_planning/common/Bresenham2d.h>
@@ -19,9 +20,11 @@ using namespace lib_path;
 
 Planner::Planner()
     : nh_priv("~"),
+      tracing_(nh_priv),
       is_cost_map_(false),
       server_(nh, "plan_path", boost::bind(&Planner::execute, this, _1), false),
-      map_info(NULL), map_rotation_yaw_(0.0), thread_running(false)
+      map_info(NULL), map_rotation_yaw_(0.0), thread_running(false),
+      search_expansions_(0), search_time_(0.0)
 {
     std::string target_topic = "/goal";
     nh_priv.param("target_topic", target_topic, target_topic);
@@ -146,10 +149,26 @@ void Planner::feedback(int status)
     if(server_.isActive()) {
         path_msgs::PlanPathFeedback f;
         f.status = status;
+
+        thread_mutex.lock();
+        f.expansions = search_expansions_;
+        f.search_time = search_time_;
+        thread_mutex.unlock();
+
         server_.publishFeedback(f);
     }
 }
 
+void Planner::reportSearchStatistics(unsigned expansions, double search_time)
+{
+    thread_mutex.lock();
+    search_expansions_ = expansions;
+    search_time_ = search_time;
+    thread_mutex.unlock();
+
+    feedback(path_msgs::PlanPathFeedback::STATUS_PLANNING);
+}
+
 void Planner::updateMapCallback (const nav_msgs::OccupancyGridConstPtr &map)
 {
     pending_map = map;
@@ -414,7 +433,10 @@ void Planner::execute(const path_msgs::PlanPathGoalConstPtr &goal)
 
 path_msgs::PathSequence Planner::findPath(const path_msgs::PlanPathGoal& request)
 {
+    NAV_TRACE_SCOPE("planner/find_path");
+
     Stopwatch sw;
+    nav_tracing::Span map_span("planner/update_map");
     if(use_map_topic_ && pending_map) {
         updateMap(*pending_map, false);
 
@@ -506,6 +528,8 @@ path_msgs::PathSequence Planner::findPath(const path_msgs::PlanPathGoal& request
         updateMap(empty_map, false);
     }
 
+    map_span.end();
+
     if(map_info == NULL) {
         ROS_ERROR("request for path planning, but no map there yet...");
         return path_msgs::PathSequence();
@@ -517,12 +541,17 @@ path_msgs::PathSequence Planner::findPath(const path_msgs::PlanPathGoal& request
 
 
     sw.reset();
-    preprocess(request);
+    {
+        NAV_TRACE_SCOPE("planner/preprocess");
+        preprocess(request);
+    }
     ROS_DEBUG_STREAM("preprocessing took " << sw.msElapsed() << "ms");
 
 
     sw.reset();
+    nav_tracing::Span plan_span("planner/plan");
     path_msgs::PathSequence path_raw = doPlan(request);
+    plan_span.end();
     ROS_DEBUG_STREAM("planning took " << sw.msElapsed() << "ms");
 
     path_msgs::PathSequence path;
@@ -535,7 +564,10 @@ path_msgs::PathSequence Planner::findPath(const path_msgs::PlanPathGoal& request
     }
 
     sw.reset();
-    publish(path, path_raw);
+    {
+        NAV_TRACE_SCOPE("planner/publish");
+        publish(path, path_raw);
+    }
     ROS_DEBUG_STREAM("publish took " << sw.msElapsed() << "ms");
     return path;
 }
@@ -620,6 +652,8 @@ void Planner::preprocess(const path_msgs::PlanPathGoal& request)
 
 path_msgs::PathSequence Planner::postprocess(const path_msgs::PathSequence& path)
 {
+    NAV_TRACE_SCOPE("planner/postprocess");
+
     boost::lock_guard<boost::mutex> lock(map_mutex);
 
     Stopwatch sw;
@@ -702,6 +736,11 @@ path_msgs::PathSequence Planner::doPlan(const path_msgs::PlanPathGoal &request)
 
     ROS_DEBUG("starting search");
 
+    thread_mutex.lock();
+    search_expansions_ = 0;
+    search_time_ = 0.0;
+    thread_mutex.unlock();
+
     feedback(path_msgs::PlanPathFeedback::STATUS_PLANNING);
 
     boost::thread worker(boost::bind(&Planner::planThreaded, this, request));
@@ -1295,33 +1334,26 @@ path_msgs::DirectionalPath Planner::smoothPathSegment(const path_msgs::Direction
     new_path.forward = path.forward;
 
     int n = path.poses.size();
+    if(n < 2) {
+        return new_path;
+    }
 
-    double last_change = -2 * tolerance;
-    double change = 0;
+    std::vector<double> x(n), y(n);
+    for(int i = 0; i < n; ++i) {
+        x[i] = path.poses[i].pose.position.x;
+        y[i] = path.poses[i].pose.position.y;
+    }
 
     int offset = 2;
+    if(!PathSmoother::smooth(x, y, weight_data, weight_smooth, offset)) {
+        ROS_WARN_STREAM_THROTTLE(1, "not smoothing the path, weight_smooth has to be in [0, 0.5) and weight_data positive"
+                                 " (weight_data: " << weight_data << ", weight_smooth: " << weight_smooth << ")");
+        return new_path;
+    }
 
-    while(change > last_change + tolerance) {
-        last_change = change;
-        change = 0;
-
-        for(int i = offset; i < n-offset; ++i){
-            Pose2d path_i = convert(path.poses[i]);
-            Pose2d new_path_i = convert(new_path.poses[i]);
-            Pose2d new_path_ip1 = convert(new_path.poses[i+1]);
-            Pose2d new_path_im1 = convert(new_path.poses[i-1]);
-
-            Pose2d deltaData = weight_data * (path_i - new_path_i);
-            new_path_i = new_path_i + deltaData;
-
-            Pose2d deltaSmooth =  weight_smooth * (new_path_ip1 + new_path_im1 - 2* new_path_i);
-            new_path_i = new_path_i + deltaSmooth;
-
-            new_path.poses[i].pose.position.x = new_path_i.x;
-            new_path.poses[i].pose.position.y = new_path_i.y;
-
-            change += deltaData.distance_to_origin() + deltaSmooth.distance_to_origin();
-        }
+    for(int i = offset; i < n-offset; ++i){
+        new_path.poses[i].pose.position.x = x[i];
+        new_path.poses[i].pose.position.y = y[i];
     }
 
     // update orientations
@@ -1340,11 +1372,7 @@ path_msgs::DirectionalPath Planner::smoothPathSegment(const path_msgs::Direction
     bool is_backward = (theta_diff > M_PI_2 || theta_diff < -M_PI_2) ;
 
     for(int i = 1; i < n-1; ++i){
-        Pose2d next = convert(new_path.poses[i+1]);
-        Pose2d prev = convert(new_path.poses[i-1]);
-
-        Pose2d delta = next - prev;
-        double angle = std::atan2(delta.y, delta.x);
+        double angle = std::atan2(y[i+1] - y[i-1], x[i+1] - x[i-1]);
 
         if(is_backward) {
             angle = MathHelper::AngleClamp(angle + M_PI);
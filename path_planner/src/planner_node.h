@@ -15,6 +15,7 @@
 #include <sensor_msgs/LaserScan.h>
 #include <sensor_msgs/PointCloud2.h>
 #include <opencv2/core/core.hpp>
+#include <nav_tracing/diagnostics_publisher.h>
 
 /**
  * @brief The Planner class is a base class for other planning algorithms
@@ -105,7 +106,7 @@ protected:
      * @param path path to smooth
      * @param weight_data weight for data integrity
      * @param weight_smooth weight for smoothness
-     * @param tolerance iteration stopping criterium
+     * @param tolerance unused, the smoothing objective is solved directly
      * @return smooted path
      */
     path_msgs::PathSequence smoothPath(const path_msgs::PathSequence& path, double weight_data, double weight_smooth, double tolerance = 0.000001);
@@ -139,6 +140,13 @@ protected:
     void preempt();
     void feedback(int status);
 
+    /**
+     * @brief reportSearchStatistics stores the statistics of the search, which are sent with every following feedback
+     * @param expansions number of expanded nodes
+     * @param search_time duration of the search in seconds
+     */
+    void reportSearchStatistics(unsigned expansions, double search_time);
+
     path_msgs::PathSequence empty() const;
 
 protected:
@@ -178,6 +186,8 @@ protected:
     ros::NodeHandle nh;
     ros::NodeHandle nh_priv;
 
+    nav_tracing::DiagnosticsPublisher tracing_;
+
     bool is_cost_map_;
 
     bool use_map_topic_;
@@ -250,6 +260,9 @@ protected:
     boost::thread* thread_;
     boost::mutex thread_mutex;
 
+    unsigned search_expansions_;
+    double search_time_;
+
     boost::mutex map_mutex;
 
 protected:
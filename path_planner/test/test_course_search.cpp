@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <cslibs_path_planning/common/SimpleGridMap2d.h>
+
+#include "../src/course_planner/course/course_map.h"
+#include "../src/course_planner/course/search.h"
+#include "../src/course_planner/course/route_cache.h"
+
+namespace
+{
+XmlRpc::XmlRpcValue makePoint(double x, double y)
+{
+    XmlRpc::XmlRpcValue pt;
+    pt[0] = x;
+    pt[1] = y;
+    return pt;
+}
+
+XmlRpc::XmlRpcValue makeSegment(double x0, double y0, double x1, double y1)
+{
+    XmlRpc::XmlRpcValue segment;
+    segment[0] = makePoint(x0, y0);
+    segment[1] = makePoint(x1, y1);
+    return segment;
+}
+
+path_msgs::PlanPathGoal makeGoal()
+{
+    path_msgs::PlanPathGoal goal;
+    goal.goal.pose.header.frame_id = "map";
+    goal.goal.pose.header.stamp = ros::Time::now();
+
+    goal.options.goal_dist_threshold = 0.05;
+    goal.options.goal_angle_threshold_degree = 22.5;
+    goal.options.allow_forward = true;
+    goal.options.allow_backward = false;
+    goal.options.ackermann_la = 1.2;
+    goal.options.ackermann_steer_steps = 2;
+    goal.options.ackermann_max_steer_angle_degree = 60;
+    goal.options.ackermann_steer_delta_degree = 15;
+    return goal;
+}
+
+void expectSamePath(const path_msgs::PathSequence& a, const path_msgs::PathSequence& b)
+{
+    ASSERT_EQ(a.paths.size(), b.paths.size());
+    for(std::size_t i = 0; i < a.paths.size(); ++i) {
+        EXPECT_EQ(a.paths[i].forward, b.paths[i].forward);
+        ASSERT_EQ(a.paths[i].poses.size(), b.paths[i].poses.size());
+        for(std::size_t j = 0; j < a.paths[i].poses.size(); ++j) {
+            EXPECT_DOUBLE_EQ(a.paths[i].poses[j].pose.position.x, b.paths[i].poses[j].pose.position.x);
+            EXPECT_DOUBLE_EQ(a.paths[i].poses[j].pose.position.y, b.paths[i].poses[j].pose.position.y);
+        }
+    }
+}
+}
+
+TEST(TestRouteCache, quantisesPositions)
+{
+    RouteCache cache(2, 0.5);
+    cache.insert(cache.makeKey(0, Eigen::Vector2d(1.1, 0.0), 1, Eigen::Vector2d(5.0, 5.0)), {1, 2});
+
+    // same cell -> hit
+    const std::vector<int>* route = cache.find(cache.makeKey(0, Eigen::Vector2d(1.3, 0.0), 1, Eigen::Vector2d(5.2, 5.1)));
+    ASSERT_NE(nullptr, route);
+    EXPECT_EQ(std::vector<int>({1, 2}), *route);
+
+    // neighbouring cell or other segment -> miss
+    EXPECT_EQ(nullptr, cache.find(cache.makeKey(0, Eigen::Vector2d(1.6, 0.0), 1, Eigen::Vector2d(5.0, 5.0))));
+    EXPECT_EQ(nullptr, cache.find(cache.makeKey(2, Eigen::Vector2d(1.1, 0.0), 1, Eigen::Vector2d(5.0, 5.0))));
+
+    EXPECT_EQ(1, cache.getHits());
+    EXPECT_EQ(2, cache.getMisses());
+}
+
+TEST(TestRouteCache, evictsLeastRecentlyUsed)
+{
+    RouteCache cache(2, 1.0);
+    RouteCache::Key a = cache.makeKey(0, Eigen::Vector2d(0, 0), 1, Eigen::Vector2d(0, 0));
+    RouteCache::Key b = cache.makeKey(0, Eigen::Vector2d(0, 0), 2, Eigen::Vector2d(0, 0));
+    RouteCache::Key c = cache.makeKey(0, Eigen::Vector2d(0, 0), 3, Eigen::Vector2d(0, 0));
+
+    cache.insert(a, {1});
+    cache.insert(b, {2});
+    // a is used again -> b is the least recently used route
+    ASSERT_NE(nullptr, cache.find(a));
+    cache.insert(c, {3});
+
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_NE(nullptr, cache.find(a));
+    EXPECT_EQ(nullptr, cache.find(b));
+    EXPECT_NE(nullptr, cache.find(c));
+}
+
+TEST(TestCourseSearch, repeatedQueriesHitTheRouteCache)
+{
+    ros::NodeHandle nh;
+
+    // L-shaped course: along x, then left along y
+    XmlRpc::XmlRpcValue segments;
+    segments[0] = makeSegment(0.0, 0.0, 20.0, 0.0);
+    segments[1] = makeSegment(15.0, -5.0, 15.0, 20.0);
+
+    CourseMap course(nh);
+    course.load(segments);
+
+    // free map
+    lib_path::SimpleGridMap2d map(300, 300, 0.1);
+    map.setLowerThreshold(10);
+    map.setUpperThreshold(90);
+    map.set(std::vector<uint8_t>(300 * 300, 0), 300, 300);
+    map.setOrigin(lib_path::Point2d(-5.0, -10.0));
+
+    path_geom::PathPose start(2.0, 0.0, 0.0);
+    path_geom::PathPose end(15.0, 15.0, M_PI / 2);
+
+    Search cached_search(course);
+    path_msgs::PathSequence first = cached_search.findPath(&map, makeGoal(), start, end);
+    ASSERT_FALSE(first.paths.empty());
+    EXPECT_EQ(0, cached_search.getRouteCacheHits());
+    EXPECT_EQ(1, cached_search.getRouteCacheMisses());
+
+    path_msgs::PathSequence second = cached_search.findPath(&map, makeGoal(), start, end);
+    EXPECT_EQ(1, cached_search.getRouteCacheHits());
+    EXPECT_EQ(1, cached_search.getRouteCacheMisses());
+    EXPECT_EQ(0, cached_search.getExpansions());
+
+    ros::param::set("~course/route_cache/size", 0);
+    Search fresh_search(course);
+    path_msgs::PathSequence fresh = fresh_search.findPath(&map, makeGoal(), start, end);
+    EXPECT_EQ(0, fresh_search.getRouteCacheHits());
+    EXPECT_GT(fresh_search.getExpansions(), 0);
+
+    expectSamePath(first, second);
+    expectSamePath(fresh, second);
+}
+
+int main(int argc, char **argv){
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "test_course_search");
+  ros::start();
+  return RUN_ALL_TESTS();
+}
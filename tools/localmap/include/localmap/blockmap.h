@@ -80,6 +80,12 @@ public:
      */
     void SetPose(cv::Point3f normal, cv::Point3f pos);
 
+    /**
+     * @brief Get the result buffer for temporal fusion. It equals currentMap_ except for the rectangle of the last temporal update,
+     * so only that rectangle is restored instead of copying the whole map. A full copy is done after the map was shifted or reset.
+     */
+    cv::Mat& GetTemporalMap(const cv::Rect &updateRect);
+
     cv::Point2f center_;
     cv::Point2f origin_;
     int mapResolution_;
@@ -93,6 +99,11 @@ public:
     cv::Mat currentMap_;
     cv::Mat baseLinkMap_;
 
+    /**
+     * @brief Incremented whenever currentMap_ is changed outside of the fusion functions (shift, reset, safe blocks)
+     */
+    int revision_;
+
     cv::Point3f curNormal_;
     cv::Point3f curPos_;
 
@@ -110,6 +121,10 @@ private:
 
     cv::Mat tempMap_;
 
+    cv::Mat temporalMap_;
+    cv::Rect temporalDirty_;
+    int temporalRevision_;
+
 };
 
 
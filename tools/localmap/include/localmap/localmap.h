@@ -17,6 +17,7 @@
 
 //#include <tf_conversions/tf_eigen.h>
 #include "blockmap.h"
+#include "utils_fusion.h"
 //#include "utils_pose_estimator.h"
 
 
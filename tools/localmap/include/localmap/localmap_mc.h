@@ -17,6 +17,14 @@
 
 //#include <tf_conversions/tf_eigen.h>
 #include "blockmap.h"
+#include "utils_fusion.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <sys/time.h>
 //#include "utils_pose_estimator.h"
 
 
@@ -46,9 +54,23 @@ public:
     enum FUSE_MODE { FM_OVERWRITE,FM_MAX, FM_TEMPORAL};
 
     LocalmapMC();
+    ~LocalmapMC();
 
+    /**
+     * @brief Depth image callback, processes the image directly or hands it to the worker thread of the camera
+     */
     void imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx);
 
+    /**
+     * @brief Projects a depth image and fuses it into the block map. Projection runs in parallel for different cameras, fusion is serialized.
+     */
+    void ProcessFrame(const sensor_msgs::ImageConstPtr& depth, int idx, const timeval &receiveTime);
+
+    /**
+     * @brief Worker thread of one camera, processes the latest received frame
+     */
+    void CameraWorker(int idx);
+
     /**
      * @brief Convert a point from world to map coordinates
      */
@@ -65,7 +87,7 @@ public:
     /**
      * @brief Setup up transform matrices
      */
-    void SetupMatrices(tf::Transform &transform);
+    void SetupMatrices(ZImageProc &proc, tf::Transform &transform);
 
     /**
      * @brief Updates the local map with the current depth images, assigning the current height for all valid pixels in the current depth image
@@ -77,18 +99,57 @@ public:
      */
     void UpdateLocalMapMax(cv::Mat &localMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax);
 
-    void UpdateLocalMapTemporal(cv::Mat &localMap, cv::Mat &localTempMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax, const cv::Point3f &planeP, const cv::Point3f &planeN);
+    void UpdateLocalMapTemporal(const ZImageProc &proc, cv::Mat &localMap, cv::Mat &localTempMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax, const cv::Point3f &planeP, const cv::Point3f &planeN);
 
 private:
+
+    /**
+     * @brief Per camera state: projection parameters and buffers, the latest unprocessed frame and latency metrics
+     */
+    struct CameraPipeline
+    {
+        CameraPipeline() :
+            hasCamInfo(false),
+            hasCam2Base(false),
+            numProcessed(0),
+            numDropped(0),
+            totalQueueTime(0),
+            totalProjectTime(0),
+            totalFuseTime(0)
+        {}
+
+        bool hasCamInfo;
+        bool hasCam2Base;
+        sensor_msgs::CameraInfo camInfo;
+        tf::StampedTransform cam2Base;
+
+        ZImageProc proc;
+        cv::Mat zImg,assign;
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable frameCond;
+        sensor_msgs::ImageConstPtr pendingFrame;
+        timeval pendingReceiveTime;
+
+        int numProcessed;
+        std::atomic<int> numDropped;
+        double totalQueueTime;
+        double totalProjectTime;
+        double totalFuseTime;
+    };
+
+    /**
+     * @brief Project the depth image into the buffers of the camera
+     */
+    void ProjectDepthImage(CameraPipeline &cam, const cv::Mat &cvDepth, cv::Vec4i &minMax);
+
     ros::NodeHandle nodeG_;
     ros::NodeHandle nodeP_;
 
     std::vector<ros::Subscriber> depthImageSubs_;
     std::vector<ros::Subscriber> cameraInfoSubs_;
-    std::vector<bool> hasCamInfos_;
-    std::vector<bool> hasCam2Bases_;
-    std::vector<sensor_msgs::CameraInfo> camInfos_;
-    std::vector<tf::StampedTransform> cam2Bases_;
+    std::vector<std::unique_ptr<CameraPipeline> > cameras_;
 
 
     ros::Subscriber mapResetSub_;
@@ -146,10 +207,25 @@ private:
     float mapZeroLevelf_;
     ZImageProc proc_;
 
-    cv::Mat cZImg_,cAssign_;
     //CVAlignedMat::ptr acZImg_,acAssign_;
     BlockMap blockMap_;
 
+    /**
+     * @brief Guards the block map and the fusion stage
+     */
+    std::mutex fusionMutex_;
+
+    /**
+     * @brief Time of the last camera pipeline log, guarded by fusionMutex_
+     */
+    timeval lastMetricsLog_;
+
+    /**
+     * @brief If true, each camera is processed by its own worker thread
+     */
+    bool useCameraThreads_;
+    std::atomic<bool> running_;
+
     bool initBlockMap_;
 
     double transformWaitTime_,resetWaitTime_;
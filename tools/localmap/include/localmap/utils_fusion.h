@@ -0,0 +1,119 @@
+#ifndef UTILS_FUSION_H
+#define UTILS_FUSION_H
+
+
+#include <opencv2/core/core.hpp>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Vectorised kernels for fusing a projected z image into the local map
+ */
+class UtilsFusion
+{
+public:
+
+    enum FUSE_OP { FO_OVERWRITE, FO_OVERWRITE_RAW, FO_MAX};
+
+    /**
+     * @brief Fuse the region minMax (minx, miny, maxx, maxy) of zImage into localMap. Only pixels with assign >= minVal are used.
+     * FO_OVERWRITE: map = z/assign*scale+offset, FO_OVERWRITE_RAW: map = z*scale+offset, FO_MAX: map = max(map, z/assign*scale+offset)
+     * If PLANE is set, only pixels with x*plane[0]+y*plane[1]+plane[2] > 0 are updated.
+     */
+    template <int OP, bool PLANE>
+    static void FuseRegion(cv::Mat &localMap, const cv::Mat &zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax, float minVal, float scale, float offset, const cv::Vec3f &plane = cv::Vec3f(0,0,0))
+    {
+        for (int yl = minMax[1]; yl < minMax[3];++yl)
+        {
+            FuseRow<OP,PLANE>(localMap.ptr<float>(yl),zImage.ptr<float>(yl),assignImage.ptr<float>(yl),minMax[0],minMax[2],minVal,scale,offset,plane[0],(float)yl*plane[1]+plane[2]);
+        }
+    }
+
+    /**
+     * @brief Fuse the pixels [xs, xe) of a single row, planeX and planeC are the plane test coefficients for this row
+     */
+    template <int OP, bool PLANE>
+    static inline void FuseRow(float *mapP, const float *zP, const float *assignP, const int xs, const int xe, const float minVal, const float scale, const float offset, const float planeX, const float planeC)
+    {
+        int xl = xs;
+
+#if defined(__AVX__)
+        const __m256 minValV = _mm256_set1_ps(minVal);
+        const __m256 scaleV = _mm256_set1_ps(scale);
+        const __m256 offsetV = _mm256_set1_ps(offset);
+        const __m256 planeXV = _mm256_set1_ps(planeX);
+        const __m256 planeCV = _mm256_set1_ps(planeC);
+        const __m256 zeroV = _mm256_setzero_ps();
+        const __m256 stepV = _mm256_set1_ps(8.0f);
+        __m256 xV = _mm256_add_ps(_mm256_set1_ps((float)xs),_mm256_setr_ps(0,1,2,3,4,5,6,7));
+
+        for (; xl+8 <= xe; xl += 8)
+        {
+            const __m256 assignV = _mm256_loadu_ps(assignP+xl);
+            __m256 mask = _mm256_cmp_ps(assignV,minValV,_CMP_GE_OQ);
+            if (PLANE) mask = _mm256_and_ps(mask,_mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(xV,planeXV),planeCV),zeroV,_CMP_GT_OQ));
+            xV = _mm256_add_ps(xV,stepV);
+
+            if (_mm256_movemask_ps(mask) == 0) continue;
+
+            const __m256 zV = _mm256_loadu_ps(zP+xl);
+            const __m256 mapV = _mm256_loadu_ps(mapP+xl);
+            const __m256 nval = _mm256_add_ps(_mm256_mul_ps(OP == FO_OVERWRITE_RAW ? zV : _mm256_div_ps(zV,assignV),scaleV),offsetV);
+            if (OP == FO_MAX) mask = _mm256_and_ps(mask,_mm256_cmp_ps(nval,mapV,_CMP_GT_OQ));
+
+            _mm256_storeu_ps(mapP+xl,_mm256_blendv_ps(mapV,nval,mask));
+        }
+#elif defined(__SSE2__)
+        const __m128 minValV = _mm_set1_ps(minVal);
+        const __m128 scaleV = _mm_set1_ps(scale);
+        const __m128 offsetV = _mm_set1_ps(offset);
+        const __m128 planeXV = _mm_set1_ps(planeX);
+        const __m128 planeCV = _mm_set1_ps(planeC);
+        const __m128 zeroV = _mm_setzero_ps();
+        const __m128 stepV = _mm_set1_ps(4.0f);
+        __m128 xV = _mm_add_ps(_mm_set1_ps((float)xs),_mm_setr_ps(0,1,2,3));
+
+        for (; xl+4 <= xe; xl += 4)
+        {
+            const __m128 assignV = _mm_loadu_ps(assignP+xl);
+            __m128 mask = _mm_cmpge_ps(assignV,minValV);
+            if (PLANE) mask = _mm_and_ps(mask,_mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(xV,planeXV),planeCV),zeroV));
+            xV = _mm_add_ps(xV,stepV);
+
+            if (_mm_movemask_ps(mask) == 0) continue;
+
+            const __m128 zV = _mm_loadu_ps(zP+xl);
+            const __m128 mapV = _mm_loadu_ps(mapP+xl);
+            const __m128 nval = _mm_add_ps(_mm_mul_ps(OP == FO_OVERWRITE_RAW ? zV : _mm_div_ps(zV,assignV),scaleV),offsetV);
+            if (OP == FO_MAX) mask = _mm_and_ps(mask,_mm_cmpgt_ps(nval,mapV));
+
+            _mm_storeu_ps(mapP+xl,_mm_or_ps(_mm_and_ps(mask,nval),_mm_andnot_ps(mask,mapV)));
+        }
+#endif
+
+        for (; xl < xe;++xl)
+        {
+            if (assignP[xl] >= minVal && (!PLANE || (float)xl*planeX+planeC > 0))
+            {
+                const float nval = (OP == FO_OVERWRITE_RAW ? zP[xl] : zP[xl]/assignP[xl])*scale+offset;
+                if (OP != FO_MAX || nval > mapP[xl]) mapP[xl] = nval;
+            }
+        }
+    }
+
+    /**
+     * @brief Convert minMax (minx, miny, maxx, maxy) to a rectangle, empty if the region is empty
+     */
+    static inline cv::Rect MinMaxToRect(const cv::Vec4i &minMax)
+    {
+        if (minMax[2] <= minMax[0] || minMax[3] <= minMax[1]) return cv::Rect();
+        return cv::Rect(minMax[0],minMax[1],minMax[2]-minMax[0],minMax[3]-minMax[1]);
+    }
+
+};
+
+#endif // UTILS_FUSION_H
@@ -19,6 +19,9 @@ void BlockMap::Setup()
 
     UpdateCenter(cv::Point2f(0,0));
 
+    revision_ = 0;
+    temporalRevision_ = -1;
+
     curPos_ = cv::Point3f(0,0,0);
     curNormal_ = cv::Point3f(0,0,1);
 
@@ -32,6 +35,7 @@ void BlockMap::SetPose(cv::Point3f normal, cv::Point3f pos)
 
 void BlockMap::SetSafeBlocksTo()
 {
+    ++revision_;
     //const float heightPixelRatio = heightScale/pixelSizeInv;
     const float heightPixelRatio = heightScale_/pixelResolution_;
     const float absZInv1 = curNormal_.z == 0 ? 0 : 1.0f/std::abs(curNormal_.z);
@@ -68,6 +72,7 @@ void BlockMap::SetSafeBlocksTo()
 
 void BlockMap::SetSafeAroundRobot()
 {
+    ++revision_;
     //const float heightPixelRatio = heightScale/pixelSizeInv;
     const float heightPixelRatio = heightScale_/pixelResolution_;
     const float absZInv1 = curNormal_.z == 0 ? 0 : 1.0f/std::abs(curNormal_.z);
@@ -156,6 +161,7 @@ void BlockMap::SetSafeBlocksTo(const cv::Point3f &normal, const cv::Point3f &pos
 
 void BlockMap::SetMapTo(float val)
 {
+    ++revision_;
     currentMap_.setTo(val);
 
 }
@@ -238,6 +244,7 @@ cv::Point2i BlockMap::GetClosestBlockPos(const cv::Point2f &pos)
 
 void BlockMap::CenterMap(const cv::Point2i &newCenterBlock)
 {
+    ++revision_;
     cv::Point2i centerBlock(numBlocks_/2,numBlocks_/2);
 
     cv::Point2i shiftBlocks = newCenterBlock-centerBlock;
@@ -278,7 +285,8 @@ void BlockMap::CenterMap(const cv::Point2i &newCenterBlock)
 
         curImg.copyTo(targetImg);
 
-        tempMap_.copyTo(currentMap_);
+        /// swap buffers instead of copying back
+        std::swap(currentMap_,tempMap_);
 
 
 
@@ -296,6 +304,23 @@ void BlockMap::CenterMap(const cv::Point2i &newCenterBlock)
 
 }
 
+cv::Mat& BlockMap::GetTemporalMap(const cv::Rect &updateRect)
+{
+    if (temporalMap_.empty() || temporalRevision_ != revision_)
+    {
+        currentMap_.copyTo(temporalMap_);
+        temporalRevision_ = revision_;
+    }
+    else if (temporalDirty_.area() > 0)
+    {
+        currentMap_(temporalDirty_).copyTo(temporalMap_(temporalDirty_));
+    }
+
+    temporalDirty_ = updateRect & cv::Rect(0,0,currentMap_.cols,currentMap_.rows);
+
+    return temporalMap_;
+}
+
 void BlockMap::ReCenter(const cv::Point2f &pos)
 {
     if (!TestSafe(pos))
@@ -1,6 +1,8 @@
 
 #include "localmap.h"
 
+#include <nav_tracing/diagnostics_publisher.h>
+
 
 
 Localmap::Localmap() :
@@ -205,94 +207,18 @@ cv::Point2f Localmap::ConvertPoint(cv::Point2f &p)
 
 void Localmap::UpdateLocalMapOverwrite(cv::Mat &localMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax)
 {
-    const float *zImageP;
-    float *localMapP;
-    const float *assignP;
-
-    float minVal = proc_.minAssignValue_;
-    int xl,yl;
-    float mapScaleF = mapScale_;
-    float mapOffsetF = mapOffset_;
-
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            if (assignP[xl] >= minVal)
-            {
-                localMapP[xl] = (zImageP[xl]/(assignP[xl]))*mapScaleF+mapOffsetF;
-
-            }
-
-        }
-    }
-
+    UtilsFusion::FuseRegion<UtilsFusion::FO_OVERWRITE,false>(localMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_);
 }
 
 void Localmap::UpdateLocalMapOverwriteMax(cv::Mat &localMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax)
 {
-    const float *zImageP;
-    float *localMapP;
-    const float *assignP;
-
-    float minVal = proc_.minAssignValue_;
-    int xl,yl;
-    float mapScaleF = mapScale_;
-    float mapOffsetF = mapOffset_;
-
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            if (assignP[xl] >= minVal)
-            {
-                localMapP[xl] = (zImageP[xl])*mapScaleF+mapOffsetF;
-
-            }
-
-        }
-    }
-
+    UtilsFusion::FuseRegion<UtilsFusion::FO_OVERWRITE_RAW,false>(localMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_);
 }
 
 void Localmap::UpdateLocalMapTemporal(cv::Mat &localMap, cv::Mat &localTempMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax, const cv::Point3f &planeP, const cv::Point3f &planeN)
 {
-    const float *zImageP;
-    float *localMapP;
-    const float *assignP;
-
-    float minVal = proc_.minAssignValue_;
-    int xl,yl;
-    float mapScaleF = mapScale_;
-    float mapOffsetF = mapOffset_;
-
-    //float zVal = 0
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localTempMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            if (assignP[xl] >= minVal)
-            {
-                localMapP[xl] = (zImageP[xl]/(assignP[xl]))*mapScaleF+mapOffsetF;;
-
-            }
-
-        }
-    }
-
-    float px,py,pd;
+    /// The result contains all new measurements
+    UtilsFusion::FuseRegion<UtilsFusion::FO_OVERWRITE,false>(localTempMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_);
 
     float tppx,tppy,tppz;
     proc_.ToMapCoord(planeP.x,planeP.y,planeP.z,tppx,tppy,tppz);
@@ -301,89 +227,16 @@ void Localmap::UpdateLocalMapTemporal(cv::Mat &localMap, cv::Mat &localTempMap,
 
     cv::Point3f tnorm = planeN * (1.0f/(std::sqrt(planeN.dot(planeN))));
 
-    pd = -tPlaneP.dot(tnorm);
-    px = tnorm.x;
-    py = tnorm.y;
-
-    float x,y;
-    //cv::Mat tempAssign;
-    //float *tempAssignP;
-
-    //assignImage.copyTo(tempAssign);
-
-    /*
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        //zImageP = zImage.ptr<float>(yl);
-        //localMapP = localMap.ptr<float>(yl);
-        tempAssignP = tempAssign.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            x = (float)xl;
-            y = (float)yl;
-            if (x*px+y*py+pd < 0)
-            {
-                tempAssignP[xl] = -1.0f;
-            }
-        }
-
-    }
-    */
-
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            x = (float)xl;
-            y = (float)yl;
-
-            if (assignP[xl] >= minVal && x*px+y*py+pd > 0)
-            {
-                localMapP[xl] = (zImageP[xl]/(assignP[xl]))*mapScaleF+mapOffsetF;
-
-            }
-
-        }
-    }
+    /// Only measurements in front of the plane are kept in the map
+    const cv::Vec3f plane(tnorm.x,tnorm.y,-tPlaneP.dot(tnorm));
 
+    UtilsFusion::FuseRegion<UtilsFusion::FO_OVERWRITE,true>(localMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_,plane);
 }
 
 
 void Localmap::UpdateLocalMapMax(cv::Mat &localMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax)
 {
-    const float *zImageP;
-    float *localMapP;
-    const float *assignP;
-
-    float minVal = proc_.minAssignValue_;
-    int xl,yl;
-    float mapScaleF = mapScale_;
-    float mapOffsetF = mapOffset_;
-
-    //float zVal = 0
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            if (assignP[xl] >= minVal)
-            {
-                const float nval = (zImageP[xl]/(assignP[xl]))*mapScaleF+mapOffsetF;
-                if (nval > localMapP[xl]) localMapP[xl] = nval;
-
-            }
-
-        }
-    }
-
+    UtilsFusion::FuseRegion<UtilsFusion::FO_MAX,false>(localMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_);
 }
 
 
@@ -391,6 +244,7 @@ void Localmap::UpdateLocalMapMax(cv::Mat &localMap, const cv::Mat & zImage, cons
 
 void Localmap::imageCallback(const sensor_msgs::ImageConstPtr& depth)
 {
+    NAV_TRACE_SCOPE("localmap/image_callback");
 
 
     if (!hasCamInfo_) return;
@@ -548,7 +402,7 @@ void Localmap::imageCallback(const sensor_msgs::ImageConstPtr& depth)
     cv::Mat resultImg;
 
     switch (fuseMode_) {
-    case FM_TEMPORAL: {blockMap_.currentMap_.copyTo(resultImg); UpdateLocalMapTemporal(blockMap_.currentMap_,resultImg,cZImg_, cAssign_,minMax,cvPlaneP,cvPlaneN); /*resultImg = blockMap_.currentMap_;*/  break;}
+    case FM_TEMPORAL: {resultImg = blockMap_.GetTemporalMap(UtilsFusion::MinMaxToRect(minMax)); UpdateLocalMapTemporal(blockMap_.currentMap_,resultImg,cZImg_, cAssign_,minMax,cvPlaneP,cvPlaneN);  break;}
     case FM_MAX: {UpdateLocalMapMax(blockMap_.currentMap_,cZImg_, cAssign_,minMax); resultImg = blockMap_.currentMap_;  break;}
     default:
     {
@@ -688,6 +542,9 @@ int main(int argc, char **argv)
     ros::init(argc, argv, "LocalMap_Node");
     Localmap demNode;
 
+    ros::NodeHandle nodeP("~");
+    nav_tracing::DiagnosticsPublisher tracing(nodeP);
+
     ros::Rate r(60);
     while(ros::ok())
     {
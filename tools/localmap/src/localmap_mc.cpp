@@ -1,16 +1,24 @@
 
 #include "localmap_mc.h"
 
+#include <nav_tracing/diagnostics_publisher.h>
+
 
 
 LocalmapMC::LocalmapMC() :
     nodeG_(),
     nodeP_("~")
 {
-
+    lastMetricsLog_.tv_sec = 0;
+    lastMetricsLog_.tv_usec = 0;
 
     nodeP_.param("numCameras", numCameras_,1);
 
+    for (int i = 0; i < numCameras_;i++)
+    {
+        cameras_.push_back(std::unique_ptr<CameraPipeline>(new CameraPipeline()));
+    }
+
     for (int i = 0; i < numCameras_;i++)
     {
         //scan_sub_front_ = node_.subscribe<sensor_msgs::LaserScan>("scan/front/filtered", 1, boost::bind(&ScanConverter::scanCallback, this, _1, false));
@@ -23,11 +31,6 @@ LocalmapMC::LocalmapMC() :
 
     }
 
-    hasCamInfos_.resize(numCameras_,false);
-    hasCam2Bases_.resize(numCameras_,false);
-    camInfos_.resize(numCameras_);
-    cam2Bases_.resize(numCameras_);
-
 
     //depthSub_ = nodeG_.subscribe ("/depth_image", 1, &LocalmapMC::imageCallback, this);
     //scan_sub_front_ = node_.subscribe<sensor_msgs::LaserScan>("scan/front/filtered", 1, boost::bind(&ScanConverter::scanCallback, this, _1, false));
@@ -129,11 +132,18 @@ LocalmapMC::LocalmapMC() :
     //hasCamInfo_ = false;
     //hasCam2Base_ = false;
 
-    cAssign_ = cv::Mat(mapResolution_,mapResolution_,CV_32F);
-    cZImg_ = cv::Mat(mapResolution_,mapResolution_,CV_32F);
+    nodeP_.param("useCameraThreads", useCameraThreads_,numCameras_ > 1);
 
-    cZImg_.setTo(mapZeroLevel_);
-    cAssign_.setTo(0);
+    for (int i = 0; i < numCameras_;i++)
+    {
+        CameraPipeline &cam = *cameras_[i];
+        cam.proc = proc_;
+        cam.assign = cv::Mat(mapResolution_,mapResolution_,CV_32F);
+        cam.zImg = cv::Mat(mapResolution_,mapResolution_,CV_32F);
+
+        cam.zImg.setTo(mapZeroLevel_);
+        cam.assign.setTo(0);
+    }
 
     blockMap_.mapNotVisibleLevel_ = mapNotVisibleLevel_;
     blockMap_.mapBaseLevel_ = mapOffset_;
@@ -143,32 +153,53 @@ LocalmapMC::LocalmapMC() :
 
     initBlockMap_ = true;
 
+    running_ = true;
+    if (useCameraThreads_)
+    {
+        for (int i = 0; i < numCameras_;i++)
+        {
+            cameras_[i]->worker = std::thread(&LocalmapMC::CameraWorker,this,i);
+        }
+    }
 
 
+}
 
+LocalmapMC::~LocalmapMC()
+{
+    for (int i = 0; i < numCameras_;i++)
+    {
+        std::lock_guard<std::mutex> lock(cameras_[i]->mutex);
+        running_ = false;
+        cameras_[i]->frameCond.notify_all();
+    }
+    for (int i = 0; i < numCameras_;i++)
+    {
+        if (cameras_[i]->worker.joinable()) cameras_[i]->worker.join();
+    }
 }
 
 
 
-void LocalmapMC::SetupMatrices(tf::Transform &transform)
+void LocalmapMC::SetupMatrices(ZImageProc &proc, tf::Transform &transform)
 {
     tf::Matrix3x3 rotMat(transform.getRotation());
 
-    proc_.r11 = rotMat[0][0];
-    proc_.r12 = rotMat[0][1];
-    proc_.r13 = rotMat[0][2];
-    proc_.r21 = rotMat[1][0];
-    proc_.r22 = rotMat[1][1];
-    proc_.r23 = rotMat[1][2];
-    proc_.r31 = rotMat[2][0];
-    proc_.r32 = rotMat[2][1];
-    proc_.r33 = rotMat[2][2];
+    proc.r11 = rotMat[0][0];
+    proc.r12 = rotMat[0][1];
+    proc.r13 = rotMat[0][2];
+    proc.r21 = rotMat[1][0];
+    proc.r22 = rotMat[1][1];
+    proc.r23 = rotMat[1][2];
+    proc.r31 = rotMat[2][0];
+    proc.r32 = rotMat[2][1];
+    proc.r33 = rotMat[2][2];
 
     tf::Vector3 nTrans = transform.getOrigin();
 
-    proc_.t1 = nTrans.x();
-    proc_.t2 = nTrans.y();
-    proc_.t3 = nTrans.z();
+    proc.t1 = nTrans.x();
+    proc.t2 = nTrans.y();
+    proc.t3 = nTrans.z();
 
 
 }
@@ -194,11 +225,13 @@ bool LocalmapMC::GetTransform(ros::Time time,std::string targetFrame, std::strin
 
 void LocalmapMC::ci_callback(const sensor_msgs::CameraInfoConstPtr& info, int idx)
 {
-    if (hasCamInfos_[idx]) return;
+    CameraPipeline &cam = *cameras_[idx];
+    std::lock_guard<std::mutex> lock(cam.mutex);
+    if (cam.hasCamInfo) return;
     if (info->P.at(0) == 0) return;
-    camInfos_[idx] = *info;
+    cam.camInfo = *info;
 
-    hasCamInfos_[idx] = true;
+    cam.hasCamInfo = true;
 
 
     ROS_INFO_STREAM("Received camera info!");
@@ -209,6 +242,7 @@ void LocalmapMC::mr_callback(const std_msgs::Int8ConstPtr& data)
 {
     ros::Duration durWait(resetWaitTime_);
     durWait.sleep();
+    std::lock_guard<std::mutex> lock(fusionMutex_);
     blockMap_.SetMapTo(0);
     blockMap_.SetSafeAroundRobot();
 
@@ -220,221 +254,138 @@ void LocalmapMC::mr_callback(const std_msgs::Int8ConstPtr& data)
 
 cv::Point2f LocalmapMC::ConvertPoint(cv::Point2f &p)
 {
-    return cv::Point2f((p.x-proc_.minXVal_) * proc_.pixelResolution_,(p.y-proc_.minYVal_) * proc_.pixelResolution_);
+    return cv::Point2f((p.x-blockMap_.origin_.x) * proc_.pixelResolution_,(p.y-blockMap_.origin_.y) * proc_.pixelResolution_);
 
 }
 
 
 void LocalmapMC::UpdateLocalMapOverwrite(cv::Mat &localMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax)
 {
-    const float *zImageP;
-    float *localMapP;
-    const float *assignP;
-
-    float minVal = proc_.minAssignValue_;
-    int xl,yl;
-    float mapScaleF = mapScale_;
-    float mapOffsetF = mapOffset_;
-
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            if (assignP[xl] >= minVal)
-            {
-                localMapP[xl] = (zImageP[xl]/(assignP[xl]))*mapScaleF+mapOffsetF;
-
-            }
-
-        }
-    }
-
+    UtilsFusion::FuseRegion<UtilsFusion::FO_OVERWRITE,false>(localMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_);
 }
 
 void LocalmapMC::UpdateLocalMapOverwriteMax(cv::Mat &localMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax)
 {
-    const float *zImageP;
-    float *localMapP;
-    const float *assignP;
-
-    float minVal = proc_.minAssignValue_;
-    int xl,yl;
-    float mapScaleF = mapScale_;
-    float mapOffsetF = mapOffset_;
-
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            if (assignP[xl] >= minVal)
-            {
-                localMapP[xl] = (zImageP[xl])*mapScaleF+mapOffsetF;
-
-            }
-
-        }
-    }
-
+    UtilsFusion::FuseRegion<UtilsFusion::FO_OVERWRITE_RAW,false>(localMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_);
 }
 
 
-void LocalmapMC::UpdateLocalMapTemporal(cv::Mat &localMap, cv::Mat &localTempMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax, const cv::Point3f &planeP, const cv::Point3f &planeN)
+void LocalmapMC::UpdateLocalMapTemporal(const ZImageProc &proc, cv::Mat &localMap, cv::Mat &localTempMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax, const cv::Point3f &planeP, const cv::Point3f &planeN)
 {
-    const float *zImageP;
-    float *localMapP;
-    const float *assignP;
-
-    float minVal = proc_.minAssignValue_;
-    int xl,yl;
-    float mapScaleF = mapScale_;
-    float mapOffsetF = mapOffset_;
-
-    //float zVal = 0
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localTempMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            if (assignP[xl] >= minVal)
-            {
-                localMapP[xl] = (zImageP[xl]/(assignP[xl]))*mapScaleF+mapOffsetF;;
-
-            }
-
-        }
-    }
-
-    float px,py,pd;
+    /// The result contains all new measurements
+    UtilsFusion::FuseRegion<UtilsFusion::FO_OVERWRITE,false>(localTempMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_);
 
     float tppx,tppy,tppz;
-    proc_.ToMapCoord(planeP.x,planeP.y,planeP.z,tppx,tppy,tppz);
+    proc.ToMapCoord(planeP.x,planeP.y,planeP.z,tppx,tppy,tppz);
 
     cv::Point3f tPlaneP(tppx,tppy,0);
 
     cv::Point3f tnorm = planeN * (1.0f/(std::sqrt(planeN.dot(planeN))));
 
-    pd = -tPlaneP.dot(tnorm);
-    px = tnorm.x;
-    py = tnorm.y;
+    /// Only measurements in front of the plane are kept in the map
+    const cv::Vec3f plane(tnorm.x,tnorm.y,-tPlaneP.dot(tnorm));
 
-    float x,y;
-    //cv::Mat tempAssign;
-    //float *tempAssignP;
+    UtilsFusion::FuseRegion<UtilsFusion::FO_OVERWRITE,true>(localMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_,plane);
+}
 
-    //assignImage.copyTo(tempAssign);
 
-    /*
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        //zImageP = zImage.ptr<float>(yl);
-        //localMapP = localMap.ptr<float>(yl);
-        tempAssignP = tempAssign.ptr<float>(yl);
+void LocalmapMC::UpdateLocalMapMax(cv::Mat &localMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax)
+{
+    UtilsFusion::FuseRegion<UtilsFusion::FO_MAX,false>(localMap,zImage,assignImage,minMax,proc_.minAssignValue_,mapScale_,mapOffset_);
+}
 
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            x = (float)xl;
-            y = (float)yl;
-            if (x*px+y*py+pd < 0)
-            {
-                tempAssignP[xl] = -1.0f;
-            }
-        }
 
-    }
-    */
 
-    for (yl = minMax[1]; yl < minMax[3];++yl)
-    {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
 
-        for (xl = minMax[0]; xl < minMax[2];++xl)
-        {
-            x = (float)xl;
-            y = (float)yl;
+static double ElapsedMs(const timeval &start, const timeval &end)
+{
+    return (double)(end.tv_sec - start.tv_sec)*1000.0+ (double)(end.tv_usec - start.tv_usec)/1000.0;
+}
 
-            if (assignP[xl] >= minVal && x*px+y*py+pd > 0)
-            {
-                localMapP[xl] = (zImageP[xl]/(assignP[xl]))*mapScaleF+mapOffsetF;
 
-            }
+void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
+{
+    timeval receiveTime;
+    gettimeofday(&receiveTime, NULL);
 
-        }
+    if (!useCameraThreads_)
+    {
+        ProcessFrame(depth,idx,receiveTime);
+        return;
     }
 
+    /// Only the latest frame is kept, a frame that was not picked up by the worker yet is dropped
+    CameraPipeline &cam = *cameras_[idx];
+    std::lock_guard<std::mutex> lock(cam.mutex);
+    if (cam.pendingFrame) cam.numDropped++;
+    cam.pendingFrame = depth;
+    cam.pendingReceiveTime = receiveTime;
+    cam.frameCond.notify_one();
 }
 
-
-void LocalmapMC::UpdateLocalMapMax(cv::Mat &localMap, const cv::Mat & zImage, const cv::Mat &assignImage, const cv::Vec4i &minMax)
+void LocalmapMC::CameraWorker(int idx)
 {
-    const float *zImageP;
-    float *localMapP;
-    const float *assignP;
-
-    float minVal = proc_.minAssignValue_;
-    int xl,yl;
-    float mapScaleF = mapScale_;
-    float mapOffsetF = mapOffset_;
+    CameraPipeline &cam = *cameras_[idx];
 
-    //float zVal = 0
-    for (yl = minMax[1]; yl < minMax[3];++yl)
+    while (true)
     {
-        zImageP = zImage.ptr<float>(yl);
-        localMapP = localMap.ptr<float>(yl);
-        assignP = assignImage.ptr<float>(yl);
-
-        for (xl = minMax[0]; xl < minMax[2];++xl)
+        sensor_msgs::ImageConstPtr depth;
+        timeval receiveTime;
         {
-            if (assignP[xl] >= minVal)
-            {
-                const float nval = (zImageP[xl]/(assignP[xl]))*mapScaleF+mapOffsetF;
-                if (nval > localMapP[xl]) localMapP[xl] = nval;
-
-            }
-
+            std::unique_lock<std::mutex> lock(cam.mutex);
+            cam.frameCond.wait(lock,[this,&cam]{return !running_ || cam.pendingFrame;});
+            if (!running_) return;
+            depth = cam.pendingFrame;
+            receiveTime = cam.pendingReceiveTime;
+            cam.pendingFrame.reset();
         }
-    }
 
+        ProcessFrame(depth,idx,receiveTime);
+    }
 }
 
+void LocalmapMC::ProjectDepthImage(CameraPipeline &cam, const cv::Mat &cvDepth, cv::Vec4i &minMax)
+{
+    switch (processMode_) {
+    case PM_NN: cam.proc.ProcessDepthImageNN(cvDepth,cam.zImg, cam.assign,minMax, mapScale_,mapOffset_,mapZeroLevel_);  break;
+    case PM_MAX: cam.proc.ProcessDepthImageMaxNN(cvDepth,cam.zImg, cam.assign,minMax, mapScale_,mapOffset_,mapZeroLevel_);  break;
+    default:cam.proc.ProcessDepthImage(cvDepth,cam.zImg, cam.assign,minMax, mapScale_,mapOffset_,mapZeroLevel_);  break;
+    }
+}
 
-
-
-void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
+void LocalmapMC::ProcessFrame(const sensor_msgs::ImageConstPtr& depth, int idx, const timeval &receiveTime)
 {
+    NAV_TRACE_SCOPE("localmap/process_frame");
+
+    CameraPipeline &cam = *cameras_[idx];
+    ZImageProc &proc = cam.proc;
 
+    timeval tProcessStart;
+    gettimeofday(&tProcessStart, NULL);
 
-    if (!hasCamInfos_[idx]) return;
-    sensor_msgs::CameraInfo camInfo = camInfos_[idx];
-    proc_.SetupCam(camInfo.P[0],camInfo.P[5],camInfo.P[2],camInfo.P[6]);
+    sensor_msgs::CameraInfo camInfo;
+    {
+        std::lock_guard<std::mutex> lock(cam.mutex);
+        if (!cam.hasCamInfo) return;
+        camInfo = cam.camInfo;
+    }
+    proc.SetupCam(camInfo.P[0],camInfo.P[5],camInfo.P[2],camInfo.P[6]);
 
     std::string cameraFrame = depth->header.frame_id;
     ros::Time timeStamp = depth->header.stamp;
     if (useLatestTransform_ == 1) timeStamp = ros::Time::now();
     if (useLatestTransform_ == 2) timeStamp = ros::Time(0);
 
-    if (!hasCam2Bases_[idx])
+    if (!cam.hasCam2Base)
     {
 
-        if (!GetTransform(ros::Time(0),baseFrame_, cameraFrame, cam2Bases_[idx])) {
+        if (!GetTransform(ros::Time(0),baseFrame_, cameraFrame, cam.cam2Base)) {
             ROS_ERROR_STREAM("Error looking up Camera to Base transform: " << cameraFrame << " to " << baseFrame_);
 
             return;
 
         }
-        hasCam2Bases_[idx] = true;
+        cam.hasCam2Base = true;
     }
 
 
@@ -448,8 +399,9 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
     }
 
 
+    cv::Point3f robotPos3D(base2map.getOrigin().x(),base2map.getOrigin().y(),base2map.getOrigin().z());
+    cv::Point3f robotNormal;
     {
-        cv::Point3f pos(base2map.getOrigin().x(),base2map.getOrigin().y(),base2map.getOrigin().z());
 
         tf::Vector3 upVec(0,0,1.0);
 
@@ -462,9 +414,7 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
         tf::Vector3 tf_normal = tempTrans*upVec;
 
 
-        cv::Point3f normal(tf_normal.x(),tf_normal.y(),tf_normal.z());
-
-        blockMap_.SetPose(normal,pos);
+        robotNormal = cv::Point3f(tf_normal.x(),tf_normal.y(),tf_normal.z());
 
 
     }
@@ -491,7 +441,7 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
 
     cv::Point3f cvPlaneP(planePointMap.x(),planePointMap.y(),planePointMap.z());
     cv::Point3f cvPlaneN(diff.x(),diff.y(),diff.z());
-    proc_.SetPlane(cvPlaneP,cvPlaneN);
+    proc.SetPlane(cvPlaneP,cvPlaneN);
     cv::Point3f tDir(diff.x(),diff.y(),diff.z());
     tDir = tDir* (1.0/sqrt(tDir.dot(tDir)));
     //ROS_INFO_STREAM_THROTTLE(0.5,"Plane Point: " << cv::Point3f(planePointMap.x(),planePointMap.y(),planePointMap.z()) << " Normal: " << tDir);
@@ -516,7 +466,7 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
 
 
     tf::Transform cam2map;
-    cam2map = base2map*cam2Bases_[idx];
+    cam2map = base2map*cam.cam2Base;
 
 
 
@@ -524,7 +474,7 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
     cv::Mat cvDepth = cv_bridge::toCvShare(depth,"")->image;
 
 
-    SetupMatrices(cam2map);
+    SetupMatrices(proc,cam2map);
 
 
     if (cvDepth.type() != CV_32F)
@@ -547,6 +497,9 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
 
 
 
+    std::unique_lock<std::mutex> fusionLock(fusionMutex_);
+
+    blockMap_.SetPose(robotNormal,robotPos3D);
     blockMap_.ReCenter(robotPos*(1.0));
 
     if (initBlockMap_)
@@ -555,30 +508,46 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
         initBlockMap_ = false;
     }
 
+    const cv::Point2f projectionOrigin = blockMap_.origin_;
 
-    proc_.minXVal_ = blockMap_.origin_.x;
-    proc_.minYVal_ = blockMap_.origin_.y;
+    fusionLock.unlock();
 
 
+    /// Projection stage, runs in parallel for all cameras
+    proc.minXVal_ = projectionOrigin.x;
+    proc.minYVal_ = projectionOrigin.y;
 
     cv::Vec4i minMax;
+    {
+        NAV_TRACE_SCOPE("localmap/project");
+        ProjectDepthImage(cam,cvDepth,minMax);
+    }
 
+    timeval tProjectEnd;
+    gettimeofday(&tProjectEnd, NULL);
 
-    switch (processMode_) {
-    case PM_NN: proc_.ProcessDepthImageNN(cvDepth,cZImg_, cAssign_,minMax, mapScale_,mapOffset_,mapZeroLevel_);  break;
-    case PM_MAX: proc_.ProcessDepthImageMaxNN(cvDepth,cZImg_, cAssign_,minMax, mapScale_,mapOffset_,mapZeroLevel_);  break;
-    default:proc_.ProcessDepthImage(cvDepth,cZImg_, cAssign_,minMax, mapScale_,mapOffset_,mapZeroLevel_);  break;
+
+    /// Fusion stage
+    nav_tracing::Span fusionSpan("localmap/fusion");
+    fusionLock.lock();
+
+    if (blockMap_.origin_ != projectionOrigin)
+    {
+        /// Another camera recentered the map in the meantime, project again with the new origin
+        proc.minXVal_ = blockMap_.origin_.x;
+        proc.minYVal_ = blockMap_.origin_.y;
+        ProjectDepthImage(cam,cvDepth,minMax);
     }
 
     cv::Mat resultImg;
 
     switch (fuseMode_) {
-    case FM_TEMPORAL: {blockMap_.currentMap_.copyTo(resultImg); UpdateLocalMapTemporal(blockMap_.currentMap_,resultImg,cZImg_, cAssign_,minMax,cvPlaneP,cvPlaneN); /*resultImg = blockMap_.currentMap_;*/  break;}
-    case FM_MAX: {UpdateLocalMapMax(blockMap_.currentMap_,cZImg_, cAssign_,minMax); resultImg = blockMap_.currentMap_;  break;}
+    case FM_TEMPORAL: {resultImg = blockMap_.GetTemporalMap(UtilsFusion::MinMaxToRect(minMax)); UpdateLocalMapTemporal(proc,blockMap_.currentMap_,resultImg,cam.zImg, cam.assign,minMax,cvPlaneP,cvPlaneN);  break;}
+    case FM_MAX: {UpdateLocalMapMax(blockMap_.currentMap_,cam.zImg, cam.assign,minMax); resultImg = blockMap_.currentMap_;  break;}
     default:
     {
-        if (processMode_ != PM_MAX){ UpdateLocalMapOverwrite(blockMap_.currentMap_,cZImg_, cAssign_,minMax); resultImg = blockMap_.currentMap_;}
-        else {UpdateLocalMapOverwriteMax(blockMap_.currentMap_,cZImg_, cAssign_,minMax); resultImg = blockMap_.currentMap_;}
+        if (processMode_ != PM_MAX){ UpdateLocalMapOverwrite(blockMap_.currentMap_,cam.zImg, cam.assign,minMax); resultImg = blockMap_.currentMap_;}
+        else {UpdateLocalMapOverwriteMax(blockMap_.currentMap_,cam.zImg, cam.assign,minMax); resultImg = blockMap_.currentMap_;}
         break;
     }
     }
@@ -622,6 +591,8 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
 
 
 
+    fusionSpan.end();
+
     timeval tZend;
     gettimeofday(&tZend, NULL);
 
@@ -699,10 +670,34 @@ void LocalmapMC::imageCallback(const sensor_msgs::ImageConstPtr& depth, int idx)
         out_assign_image.header   = depth->header; // Same timestamp and tf frame as input image
         out_assign_image.header.stamp   = timeStamp; // Same timestamp and tf frame as input image
         out_assign_image.encoding = sensor_msgs::image_encodings::TYPE_32FC1; // Or whatever
-        out_assign_image.image    = cAssign_; // Your cv::Mat
+        out_assign_image.image    = cam.assign; // Your cv::Mat
         assignImagePub_.publish(out_assign_image.toImageMsg());
     }
 
+    timeval tFuseEnd;
+    gettimeofday(&tFuseEnd, NULL);
+
+    cam.numProcessed++;
+    cam.totalQueueTime += ElapsedMs(receiveTime,tProcessStart);
+    cam.totalProjectTime += ElapsedMs(tProcessStart,tProjectEnd);
+    cam.totalFuseTime += ElapsedMs(tProjectEnd,tFuseEnd);
+
+    // the metrics of all cameras are only formatted when they are logged
+    if (ElapsedMs(lastMetricsLog_,tFuseEnd) >= 3000.0)
+    {
+        lastMetricsLog_ = tFuseEnd;
+
+        std::ostringstream metrics;
+        for (int i = 0; i < numCameras_;i++)
+        {
+            const CameraPipeline &c = *cameras_[i];
+            if (c.numProcessed == 0) continue;
+            const double n = (double)c.numProcessed;
+            metrics << " [" << i << "] frames: " << c.numProcessed << " dropped: " << c.numDropped << " AVG queue: " << c.totalQueueTime/n << " project: " << c.totalProjectTime/n << " fuse: " << c.totalFuseTime/n;
+        }
+        ROS_INFO_STREAM("Camera pipeline ms:" << metrics.str());
+    }
+
 
 }
 
@@ -713,6 +708,9 @@ int main(int argc, char **argv)
     ros::init(argc, argv, "LocalMap_Node");
     LocalmapMC demNode;
 
+    ros::NodeHandle nodeP("~");
+    nav_tracing::DiagnosticsPublisher tracing(nodeP);
+
     ros::Rate r(60);
     while(ros::ok())
     {
@@ -17,6 +17,11 @@ struct PlannerConfig
         subSampleTimeStep = 0.03;
         replanFactor = -1;
         minNumberNodes = -1;
+        anytimeRefinement = false;
+        refinementDeadline = 0.05;
+        poseCacheBlockSize = 0;
+        poseCacheResolution = 1.0;
+        poseCacheMaxEntries = 200000;
     }
 
     /**
@@ -52,6 +57,26 @@ struct PlannerConfig
      * @brief minimum number of valid poses
      */
     int minNumberNodes;
+    /**
+     * @brief if true and replanFactor is > 1, the replanning with finer step sizes is done on a background thread after every planning. The coarse result is available immediately.
+     */
+    bool anytimeRefinement;
+    /**
+     * @brief in sec, the background refinement is stopped this long after the start of planning
+     */
+    float refinementDeadline;
+    /**
+     * @brief in pixels, size of the DEM blocks that are compared between two DEM updates to invalidate cached pose evaluations. 0 disables the pose cache.
+     */
+    int poseCacheBlockSize;
+    /**
+     * @brief in pixels, poses closer than this with the same orientation index share one cached evaluation
+     */
+    float poseCacheResolution;
+    /**
+     * @brief maximum number of cached pose evaluations
+     */
+    int poseCacheMaxEntries;
 
 
     // calculated
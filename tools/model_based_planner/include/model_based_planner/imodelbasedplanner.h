@@ -78,6 +78,16 @@ public:
      */
     virtual Trajectory* GetBLResultTrajectory() = 0;
 
+    /**
+     * @brief Adopt the result of the background refinement if it finished and scored better than the current result. Returns true if the result trajectory changed.
+     */
+    virtual bool FetchRefinedResult() = 0;
+
+    /**
+     * @brief Drop the background refinement of the last planning, e.g. because its result could not be used.
+     */
+    virtual void DiscardRefinedResult() = 0;
+
     /**
      * @brief Get a pointer to the leaf node with the highest score
      */
@@ -3,6 +3,11 @@
 
 
 #include "plannertraj.h"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+
 #ifdef USE_CLOSED_SET
 #include "closedset.h"
 #endif
@@ -39,12 +44,39 @@ public:
     using TB::NextNodeAvailable;
     using TB::ClearPrioQueue;
     using TB::GetBLResultTrajectory;
+    using TB::poseEstimator_;
+    using TB::allNodes_;
+    using TB::curNodeIdx_;
+    using TB::curVelocity_;
+    using TB::curRobotPose_;
+    using TB::goal_;
+    using TB::path_;
 
+    typedef std::chrono::steady_clock RefineClock;
 
 
     PI_AStar()
     {
+        useDeadline_ = false;
+        cancel_ = false;
+        refinementDone_ = false;
+        seedNodes_ = nullptr;
+        seedCount_ = 0;
+    }
+
+    ~PI_AStar()
+    {
+        StopRefinement();
+    }
 
+    /**
+     * @brief Stop the background refinement before the planner is re-initialized
+     */
+    void Initialize(ModelBasedPlannerConfig &config)
+    {
+        StopRefinement();
+        refiner_ = nullptr;
+        TB::Initialize(config);
     }
 
     /**
@@ -68,6 +100,7 @@ public:
         for (int tl = 0; tl < config_.plannerConfig_.maxSearchIterations;++tl)
         {
             if (openSet_.empty()) break;
+            if (useDeadline_ && (cancel_ || RefineClock::now() > deadline_)) break;
             TrajNode* curNode = openSet_.top();
             openSet_.pop();
 
@@ -76,7 +109,7 @@ public:
             for (int i = 0; i < numSplits;++i)
             {
                 if (!NextNodeAvailable()) return;
-                TrajNode* newNode = CreateTrajectory(curNode,tempCmds_[i]);
+                TrajNode* newNode = CreateTrajectory(curNode,tempCmds_[i],FindSeed(curNode,tempCmds_[i]));
                 scorer_.FinalNodeScore(*newNode);
 
 #ifdef USE_CLOSED_SET
@@ -141,11 +174,32 @@ public:
 
         if (!doReplan) return;
 
-        /*
-         * Create new configs with smaller stepSizes
-         */
-
         PlannerExpanderConfig curConfig = config_.expanderConfig_;
+        PlannerExpanderConfig newConfig = GetReplanExpanderConfig();
+        expander_->SetConfig(newConfig,config_.procConfig_.pixelSize);
+        if ((int)tempCmds_.size() < newConfig.numSplits) tempCmds_.resize(newConfig.numSplits);
+
+        ClearPrioQueue();
+
+        TrajNode *startNode = GetStartNode();
+
+#ifdef USE_CLOSED_SET
+        closedSet_.Setup(config_.plannerConfig_.maxLevel,1.0,0.0174533);
+#endif
+        IterateStar(startNode);
+
+        FinishedPlanning();
+
+        expander_->SetConfig(curConfig,config_.procConfig_.pixelSize);
+
+    }
+
+    /**
+     * @brief Create new configs with smaller stepSizes for replanning
+     */
+    PlannerExpanderConfig GetReplanExpanderConfig() const
+    {
+        const PlannerExpanderConfig &curConfig = config_.expanderConfig_;
         PlannerExpanderConfig newConfig = config_.expanderConfig_;
 
         newConfig.deltaTheta = (curConfig.firstLevelSplits > 0 ? curConfig.firstLevelDeltaTheta: curConfig.deltaTheta )/(float)config_.plannerConfig_.replanFactor;
@@ -154,17 +208,65 @@ public:
         newConfig.firstLevelDeltaTheta = -1;
         newConfig.firstLevelLinearSplits = -1;
         newConfig.firstLevelSplits = -1;
-        expander_->SetConfig(newConfig,config_.procConfig_.pixelSize);
 
         if ( ((float) newConfig.numSplits * newConfig.deltaTheta)/2.0f > config_.expanderConfig_.maxAngVel)
         {
             int oneSide =  (int)std::ceil(config_.expanderConfig_.maxAngVel / newConfig.deltaTheta);
             newConfig.numSplits = oneSide*2+1;
         }
+        return newConfig;
+    }
 
+    /**
+     * @brief Find the node of the seed search that was created from the seed of prev with the same command
+     */
+    inline const TrajNode* FindSeed(const TrajNode* prev, const cv::Point2f &cmd) const
+    {
+        if (seedNodes_ == nullptr || prev->seed_ == nullptr) return nullptr;
+
+        const std::vector<const TrajNode*> &children = seedChildren_[prev->seed_ - seedNodes_->data()];
+        for (unsigned int i = 0; i < children.size();++i)
+        {
+            const cv::Point2f &seedCmd = children[i]->endCmd_;
+            if (std::abs(seedCmd.x-cmd.x) < COMMANDEPSILON && std::abs(seedCmd.y-cmd.y) < COMMANDEPSILON) return children[i];
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Use the first seedCount nodes of seedNodes to avoid evaluating poses twice. seedNodes[0] has to be the start node.
+     */
+    void SetSeedNodes(const std::vector<TrajNode> *seedNodes, int seedCount)
+    {
+        seedNodes_ = seedNodes;
+        seedCount_ = seedCount;
+        if (seedNodes_ == nullptr || seedCount_ <= 0)
+        {
+            seedNodes_ = nullptr;
+            return;
+        }
+
+        seedChildren_.resize(seedCount_);
+        for (int tl = 0; tl < seedCount_;++tl) seedChildren_[tl].clear();
+
+        const TrajNode* base = seedNodes_->data();
+        for (int tl = 1; tl < seedCount_;++tl)
+        {
+            const TrajNode* node = &(*seedNodes_)[tl];
+            if (node->parent_ == nullptr) continue;
+            seedChildren_[node->parent_ - base].push_back(node);
+        }
+    }
+
+    /**
+     * @brief Background refinement: replan from the same inputs with finer step sizes until the deadline.
+     */
+    void RefinementWorker()
+    {
         ClearPrioQueue();
 
         TrajNode *startNode = GetStartNode();
+        if (seedNodes_ != nullptr) startNode->seed_ = &(*seedNodes_)[0];
 
 #ifdef USE_CLOSED_SET
         closedSet_.Setup(config_.plannerConfig_.maxLevel,1.0,0.0174533);
@@ -173,8 +275,86 @@ public:
 
         FinishedPlanning();
 
-        expander_->SetConfig(curConfig,config_.procConfig_.pixelSize);
+        seedNodes_ = nullptr;
+        refinementDone_.store(true,std::memory_order_release);
+    }
 
+    /**
+     * @brief Start the refinement of the last planning result on a background thread
+     */
+    void StartRefinement(const RefineClock::time_point &planStart)
+    {
+        if (refiner_ == nullptr)
+        {
+            refiner_ = PI_AStar<TS>::Create();
+            refiner_->Initialize(config_);
+        }
+
+        PlannerConfig refinerConfig = config_.plannerConfig_;
+        refinerConfig.anytimeRefinement = false;
+        PlannerExpanderConfig refinerExpanderConfig = GetReplanExpanderConfig();
+
+        refiner_->SetPlannerParameters(refinerConfig);
+        refiner_->SetPlannerScorerParameters(config_.scorerConfig_);
+        refiner_->SetPlannerExpanderParameters(refinerExpanderConfig);
+
+        /// Copy the planning inputs, the DEM is shared since UpdateDEM always allocates a new one.
+        /// The DEM position has to be set first, it is used to update the pose cache
+        refiner_->SetDEMPos(TB::GetDEMPos());
+        refiner_->poseEstimator_.SetDem(poseEstimator_.GetDEMPtr());
+        refiner_->curVelocity_ = curVelocity_;
+        refiner_->curImgVelocity_ = curImgVelocity_;
+        refiner_->curRobotPose_ = curRobotPose_;
+        refiner_->curImgRobotPose_ = curImgRobotPose_;
+        refiner_->goal_ = goal_;
+        refiner_->path_ = path_;
+        refiner_->scorer_ = scorer_;
+
+        refiner_->SetSeedNodes(&allNodes_,curNodeIdx_);
+
+        refiner_->useDeadline_ = true;
+        refiner_->cancel_ = false;
+        refiner_->deadline_ = planStart + std::chrono::microseconds((long)(config_.plannerConfig_.refinementDeadline*1e6f));
+        refiner_->refinementDone_ = false;
+
+        refinementThread_ = std::thread(&PI_AStar<TS>::RefinementWorker,refiner_.get());
+    }
+
+    /**
+     * @brief Cancel a running refinement and wait for it. Has to be called before any planning input changes.
+     */
+    void StopRefinement()
+    {
+        if (!refinementThread_.joinable()) return;
+        refiner_->cancel_ = true;
+        refinementThread_.join();
+    }
+
+    /**
+     * @brief Adopt the refined trajectory if it is ready and scores better than the coarse one
+     */
+    bool FetchRefinedResult()
+    {
+        if (refiner_ == nullptr || !refinementThread_.joinable()) return false;
+        if (!refiner_->refinementDone_.load(std::memory_order_acquire)) return false;
+
+        refinementThread_.join();
+
+        TrajNode* refinedNode = refiner_->bestNode_;
+        if (refinedNode == nullptr) return false;
+        if (bestNode_ != nullptr && refinedNode->fScore_ <= bestNode_->fScore_) return false;
+
+        bestNode_ = refinedNode;
+        bestScore_ = refinedNode->fScore_;
+        return true;
+    }
+
+    /**
+     * @brief Cancel the refinement, FetchRefinedResult() returns false until the next planning
+     */
+    void DiscardRefinedResult()
+    {
+        StopRefinement();
     }
 
     /**
@@ -182,6 +362,12 @@ public:
      */
     cv::Point2f Plan()
     {
+        const RefineClock::time_point planStart = RefineClock::now();
+
+        /// the refinement reads the node pool of the last planning
+        StopRefinement();
+        /// bestNode_ may point into the node pool of the refiner
+        bestNode_ = nullptr;
 
         ClearPrioQueue();
 
@@ -195,8 +381,13 @@ public:
         FinishedPlanning();
 
 
+        /// Refine with finer resolution in the background while the coarse result is used
+        if (config_.plannerConfig_.anytimeRefinement && config_.plannerConfig_.replanFactor > 1)
+        {
+            StartRefinement(planStart);
+        }
         /// Testing replan with finer resolution if planning fails
-        if (config_.plannerConfig_.replanFactor > 0 && config_.plannerConfig_.minNumberNodes > 0)
+        else if (config_.plannerConfig_.replanFactor > 0 && config_.plannerConfig_.minNumberNodes > 0)
         {
               Replan();
 
@@ -211,6 +402,25 @@ public:
     ClosedSet closedSet_;
 #endif
 
+protected:
+    /**
+     * @brief Second planner instance doing the anytime refinement, it shares no mutable state with this one
+     */
+    Ptr refiner_;
+    std::thread refinementThread_;
+
+    bool useDeadline_;
+    RefineClock::time_point deadline_;
+    std::atomic<bool> cancel_;
+    std::atomic<bool> refinementDone_;
+
+    /**
+     * @brief Nodes of the coarse search and their children, used to reuse evaluated poses
+     */
+    const std::vector<TrajNode> *seedNodes_;
+    int seedCount_;
+    std::vector<std::vector<const TrajNode*> > seedChildren_;
+
 };
 
 #endif // PI_ASTAR_H
@@ -0,0 +1,232 @@
+#ifndef PLANNER_RECORDING_H
+#define PLANNER_RECORDING_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "config_modelbasedplanner.h"
+
+/**
+ * @brief Binary recording of the planner inputs, which can be replayed offline with model_based_planner_replay.
+ *
+ * A recording is a file header followed by a stream of records. Every record starts with a RecordHeader and
+ * its payload is padded to 8 bytes. The data is stored in host byte order and the config structs are
+ * stored as raw memory, the recording can only be replayed by a build with the same config layout.
+ *
+ * CONFIG records hold the complete planner config including the chassis image, PATH records the goal and
+ * path and CYCLE records the inputs of one call of Plan(). The DEM of a cycle is the xor with the DEM of
+ * the previous cycle (or zero for key frames), run length encoded, so unchanged cells are nearly free.
+ */
+namespace PlannerRecordingFormat
+{
+const char MAGIC[8] = {'M','B','P','R','E','C','\0','\0'};
+const std::uint32_t VERSION = 1;
+
+enum RecordType { RT_CONFIG = 1, RT_PATH = 2, RT_CYCLE = 3 };
+
+struct RecordHeader
+{
+    std::uint32_t type;
+    std::uint32_t size; // payload bytes, without padding
+};
+}
+
+/**
+ * @brief The inputs and outputs of one planning cycle
+ */
+struct PlanningCycle
+{
+    PlanningCycle()
+    {
+        stamp = 0;
+        pose = cv::Point3f(0,0,0);
+        velocity = cv::Point2f(0,0);
+        demPos = cv::Point2f(0,0);
+        command = cv::Point2f(0,0);
+        planningMS = 0;
+        poseCount = 0;
+    }
+
+    /**
+     * @brief time of the cycle in seconds
+     */
+    double stamp;
+    /**
+     * @brief robot pose in world coordinates, as passed to SetRobotPose
+     */
+    cv::Point3f pose;
+    /**
+     * @brief as passed to SetVelocity
+     */
+    cv::Point2f velocity;
+    /**
+     * @brief as passed to SetDEMPos
+     */
+    cv::Point2f demPos;
+    /**
+     * @brief the result of Plan()
+     */
+    cv::Point2f command;
+    /**
+     * @brief duration of Plan() while recording
+     */
+    float planningMS;
+    /**
+     * @brief number of tested poses while recording
+     */
+    int poseCount;
+};
+
+/**
+ * @brief Writes a recording, see PlannerRecordingFormat
+ */
+class PlannerRecorder
+{
+public:
+    PlannerRecorder();
+
+    /**
+     * @brief Create the file, an existing file is overwritten
+     */
+    bool Open(const std::string &fileName);
+    void Close();
+    bool IsOpen() const
+    {
+        return out_.is_open();
+    }
+
+    /**
+     * @brief Write the config, the chassis image is embedded so the recording is self contained
+     */
+    void WriteConfig(const ModelBasedPlannerConfig &config);
+
+    /**
+     * @brief Write goal and path, nothing is written if they did not change since the last call
+     */
+    void WritePath(const cv::Point3f &goal, const std::vector<cv::Point3f> &path);
+
+    /**
+     * @brief Write one planning cycle with the DEM passed to UpdateDEM
+     */
+    void WriteCycle(const PlanningCycle &cycle, const cv::Mat &dem);
+
+    /**
+     * @brief Every n-th DEM is stored without reference to the previous one
+     */
+    void SetKeyFrameInterval(int n)
+    {
+        keyFrameInterval_ = n;
+    }
+
+private:
+    void WriteRecord(std::uint32_t type, const std::vector<char> &payload);
+
+    std::ofstream out_;
+    std::vector<char> buffer_;
+
+    cv::Point3f lastGoal_;
+    std::vector<cv::Point3f> lastPath_;
+    bool hasPath_;
+
+    cv::Mat prevDem_;
+    int keyFrameInterval_;
+    int framesSinceKey_;
+};
+
+/**
+ * @brief Reads a recording through a read only memory mapping. The records are visited in order with Next().
+ */
+class PlannerRecording
+{
+public:
+    PlannerRecording();
+    ~PlannerRecording();
+
+    bool Open(const std::string &fileName);
+    void Close();
+
+    /**
+     * @brief Start again at the first record
+     */
+    void Rewind();
+
+    /**
+     * @brief Advance to the next record. Returns the record type or 0 at the end of the recording.
+     *        A truncated or corrupt record ends the recording.
+     */
+    int Next();
+
+    /**
+     * @brief The latest CONFIG record. The chassis image is returned as encoded file content.
+     */
+    const ModelBasedPlannerConfig& GetConfig() const
+    {
+        return config_;
+    }
+    const std::vector<uchar>& GetChassisImage() const
+    {
+        return chassisImage_;
+    }
+
+    /**
+     * @brief The latest PATH record
+     */
+    const cv::Point3f& GetGoal() const
+    {
+        return goal_;
+    }
+    const std::vector<cv::Point3f>& GetPath() const
+    {
+        return path_;
+    }
+
+    /**
+     * @brief The latest CYCLE record, the DEM buffer is reused by the next cycle
+     */
+    const PlanningCycle& GetCycle() const
+    {
+        return cycle_;
+    }
+    const cv::Mat& GetDEM() const
+    {
+        return dem_;
+    }
+
+    /**
+     * @brief Number of cycles read since Open or Rewind
+     */
+    int GetCycleCount() const
+    {
+        return cycleCount_;
+    }
+
+    /**
+     * @brief Reason why Open failed or the recording ended early, empty otherwise
+     */
+    const std::string& GetError() const
+    {
+        return error_;
+    }
+
+private:
+    bool ReadConfig(const char *data, std::size_t size);
+    bool ReadPath(const char *data, std::size_t size);
+    bool ReadCycle(const char *data, std::size_t size);
+
+    const char *data_;
+    std::size_t size_;
+    std::size_t offset_;
+
+    ModelBasedPlannerConfig config_;
+    std::vector<uchar> chassisImage_;
+    cv::Point3f goal_;
+    std::vector<cv::Point3f> path_;
+    PlanningCycle cycle_;
+    cv::Mat dem_;
+    int cycleCount_;
+    std::string error_;
+};
+
+#endif // PLANNER_RECORDING_H
@@ -6,6 +6,7 @@
 #include <memory>
 #include <config_planner.h>
 #include "utils_math_approx.h"
+#include <opencv2/imgproc/imgproc.hpp>
 
 
 
@@ -35,6 +36,14 @@ struct NodeScorer_Base
 
     }
 
+    /**
+     * @brief Set the size of the DEM image, scorers that rasterise the path cover this region
+     */
+    void SetMapSize(const cv::Size &mapSize)
+    {
+        mapSize_ = mapSize;
+    }
+
     float validThreshold_;
     float notVisibleThreshold_;
     float poseTimeStep_;
@@ -48,6 +57,8 @@ struct NodeScorer_Base
     cv::Point3f curRobotPose_;
     cv::Point2f lastCmdVel_;
 
+    cv::Size mapSize_;
+
 };
 
 
@@ -559,7 +570,83 @@ struct NodeScorer_Path_T : public NodeScorer_Goal_T
             path2_.push_back(cv::Point2f(path[tl].x,path[tl].y));
         }
 
+        UpdatePathField();
+
+    }
+
+    /**
+     * @brief Rasterise the distance to the path in image coordinates, so that scoring a pose is a bilinear
+     * lookup instead of a loop over all segments.
+     *
+     * The field covers the DEM region, extended towards the path by at most a quarter of the DEM size.
+     * Path parts outside of the field are ignored. Where the closest path point lies inside of the field,
+     * the distance deviates from GetMinPathDistanceSegments by less than PATH_FIELD_TOLERANCE pixels,
+     * due to rounding the path to pixels and the interpolation.
+     * Poses outside of the field fall back to the exact computation.
+     */
+    void UpdatePathField()
+    {
+        pathDistField_.release();
+
+        if (path2_.size() < 2 || mapSize_.width <= 0 || mapSize_.height <= 0) return;
+
+        const float margin = (float)(std::max(mapSize_.width, mapSize_.height)/4);
+
+        float minX = 0, minY = 0;
+        float maxX = (float)(mapSize_.width-1), maxY = (float)(mapSize_.height-1);
+        for (unsigned int tl = 0; tl < path2_.size();++tl)
+        {
+            minX = std::min(minX, path2_[tl].x);
+            minY = std::min(minY, path2_[tl].y);
+            maxX = std::max(maxX, path2_[tl].x);
+            maxY = std::max(maxY, path2_[tl].y);
+        }
+        minX = std::max(minX, -margin);
+        minY = std::max(minY, -margin);
+        maxX = std::min(maxX, (float)(mapSize_.width-1) + margin);
+        maxY = std::min(maxY, (float)(mapSize_.height-1) + margin);
+
+        fieldOrigin_ = cv::Point2f(std::floor(minX), std::floor(minY));
+        const cv::Size fieldSize((int)std::ceil(maxX - fieldOrigin_.x) + 1, (int)std::ceil(maxY - fieldOrigin_.y) + 1);
+
+        // path pixels are 0
+        pathMask_.create(fieldSize, CV_8U);
+        pathMask_.setTo(cv::Scalar(255));
+
+        for (unsigned int tl = 1; tl < path2_.size();++tl)
+        {
+            const cv::Point2f a = path2_[tl-1] - fieldOrigin_;
+            const cv::Point2f b = path2_[tl] - fieldOrigin_;
+
+            // clipped to the field
+            cv::line(pathMask_, cv::Point(cvRound(a.x), cvRound(a.y)), cv::Point(cvRound(b.x), cvRound(b.y)), cv::Scalar(0), 1, 8);
+        }
+
+        if (cv::countNonZero(pathMask_) == (int)pathMask_.total()) return;
+
+        cv::distanceTransform(pathMask_, pathDistField_, cv::DIST_L2, cv::DIST_MASK_PRECISE);
+    }
+
+    /**
+     * @brief Bilinear lookup in a path field, returns false if p is outside of the field
+     */
+    inline bool LookupPathField(const cv::Mat &field, const cv::Point3f &p3, float &value) const
+    {
+        if (field.empty()) return false;
 
+        const float x = p3.x - fieldOrigin_.x;
+        const float y = p3.y - fieldOrigin_.y;
+        if (!(x >= 0 && y >= 0 && x < (float)(field.cols-1) && y < (float)(field.rows-1))) return false;
+
+        const int ix = (int)x;
+        const int iy = (int)y;
+        const float fx = x - (float)ix;
+        const float fy = y - (float)iy;
+
+        const float* r0 = field.ptr<float>(iy) + ix;
+        const float* r1 = field.ptr<float>(iy+1) + ix;
+        value = (r0[0]*(1.0f-fx) + r0[1]*fx)*(1.0f-fy) + (r1[0]*(1.0f-fx) + r1[1]*fx)*fy;
+        return true;
     }
 
 
@@ -596,6 +683,19 @@ struct NodeScorer_Path_T : public NodeScorer_Goal_T
     {
         if (path2_.empty()) return 0;
 
+        float dist;
+        if (LookupPathField(pathDistField_, p3, dist)) return dist;
+
+        return GetMinPathDistanceSegments(p3);
+    }
+
+    /**
+     * @brief Find the smalles distance to the current path by checking all segments
+     */
+    inline float GetMinPathDistanceSegments(const cv::Point3f p3)const
+    {
+        if (path2_.empty()) return 0;
+
         cv::Point2f p(p3.x,p3.y);
 
         float curDis = 99999999999.0f;
@@ -636,6 +736,16 @@ struct NodeScorer_Path_T : public NodeScorer_Goal_T
         //return 0;
     }
 
+    //! Maximal deviation of the path field from the exact distance in pixels
+    static constexpr float PATH_FIELD_TOLERANCE = 2.0f;
+
+    //! Distance to the path in image coordinates, relative to fieldOrigin_
+    cv::Mat pathDistField_;
+    cv::Point2f fieldOrigin_;
+
+    //! Buffer for UpdatePathField
+    cv::Mat pathMask_;
+
 };
 
 /**
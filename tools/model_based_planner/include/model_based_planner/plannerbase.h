@@ -272,6 +272,19 @@ public:
     Trajectory* GetResultTrajectory();
 
     Trajectory* GetBLResultTrajectory();
+
+    /**
+     * @brief Planners without background refinement never change their result after Plan()
+     */
+    virtual bool FetchRefinedResult()
+    {
+        return false;
+    }
+
+    virtual void DiscardRefinedResult()
+    {
+    }
+
     TrajNode* GetBestNode()
     {
 
@@ -80,6 +80,7 @@ public:
     {
         config_.expanderConfig_ = config;
         expander_->SetConfig(config_.expanderConfig_,config_.procConfig_.pixelSize);
+        tempCmds_.resize(GetNumberSplits());
     }
 
     /**
@@ -105,6 +106,7 @@ public:
             path_.push_back(PoseToImgPose(path[tl]));
         }
 
+        scorer_.SetMapSize(GetDem().size());
         scorer_.SetPath(path_);
 
     }
@@ -208,9 +210,10 @@ public:
 
 
     /**
-     * @brief Create a Trajectory from the previous node and the current control command
+     * @brief Create a Trajectory from the previous node and the current control command.
+     * If seed is set, it has to be a node with the same start pose and command, its evaluated poses are copied instead of calling the pose estimator.
      */
-    TrajNode* CreateTrajectory(TrajNode* prev, const cv::Point2f &cmd)
+    TrajNode* CreateTrajectory(TrajNode* prev, const cv::Point2f &cmd, const TrajNode* seed = nullptr)
     {
 
         float curStep = config_.plannerConfig_.subSampleTimeStep;
@@ -226,6 +229,7 @@ public:
         out.startCmd_ = cmd;
         out.endCmd_ = cmd;
         out.validState_ = TN_VS_VALID;
+        out.seed_ = seed;
 
 
         PoseEvalResults *prevPER = prev->end_;
@@ -236,12 +240,22 @@ public:
         for (tl = 0; tl < config_.plannerConfig_.numSubSamples;++tl)
         {
             PoseEvalResults &results = out.poseResults_[tl];
-            results.SetWheelAnglesRobot(wheelAnglesRobot);
 
-            DriveModelDA::UpdatePose(curP,cmd*curStep,results.pose);
-            curStep+=config_.plannerConfig_.subSampleTimeStep;
-            results.cmd = cmd;
-            poseEstimator_.Evaluate(results);
+            if (seed != nullptr && tl < seed->numValid_)
+            {
+                /// The checks below only depend on the pose and the previous pose, which are identical for the seed
+                results = seed->poseResults_[tl];
+                curStep+=config_.plannerConfig_.subSampleTimeStep;
+            }
+            else
+            {
+                results.SetWheelAnglesRobot(wheelAnglesRobot);
+
+                DriveModelDA::UpdatePose(curP,cmd*curStep,results.pose);
+                curStep+=config_.plannerConfig_.subSampleTimeStep;
+                results.cmd = cmd;
+                poseEstimator_.Evaluate(results);
+            }
             //poseEstimator_->Evaluate(out.poseResults_[tl]);
             CalculateAngleDiff(*prevPER,results);
             //poseEstimator_.CheckState(results);
@@ -259,6 +259,7 @@ struct TrajNode : public Trajectory
         bestChildScore_ = -99999999;
         validChildCount_ = 0;
         bestChild_ = nullptr;
+        seed_ = nullptr;
 
 
         for (unsigned int tl = 0; tl < poseResults_.size();++tl) poseResults_[tl].Reset();
@@ -334,6 +335,9 @@ struct TrajNode : public Trajectory
     int validChildCount_;
     TrajNode* bestChild_;
 
+    //!node of a previous search with identical start pose and command sequence, its poses are reused instead of evaluated again
+    const TrajNode* seed_;
+
 
 };
 
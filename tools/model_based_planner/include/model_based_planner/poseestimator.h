@@ -4,6 +4,7 @@
 
 
 #include "robotmodel.h"
+#include "poseevalcache.h"
 
 
 
@@ -33,11 +34,22 @@ public:
     cv::Mat GetDEM(){
         return dem_;
     }
+    /**
+     * @brief Get the aligned DEM, can be shared since SetDem always allocates a new one
+     */
+    CVAlignedMat::ptr GetDEMPtr(){
+        return demPtr_;
+    }
 
     /**
-     * @brief Evaluate a single pose on the current DEM
+     * @brief Evaluate a single pose on the current DEM, uses the pose cache if enabled
      */
     void Evaluate(PoseEvalResults &results) const;
+
+    /**
+     * @brief Get the pose evaluation cache
+     */
+    const PoseEvalCache& GetPoseCache() const {return cache_;}
     /**
      * @brief Draw debug image with current DEM and last planning visualization
      */
@@ -67,6 +79,11 @@ private:
     CVAlignedMat::ptr demPtr_;
     cv::Mat dem_;
 
+    /**
+     * @brief cached pose evaluations, kept across DEM updates
+     */
+    mutable PoseEvalCache cache_;
+
 
 
 };
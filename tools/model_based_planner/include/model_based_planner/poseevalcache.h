@@ -0,0 +1,159 @@
+#ifndef POSEEVALCACHE_H
+#define POSEEVALCACHE_H
+
+#include "poseevalresults.h"
+#include "cv_aligned_mat.h"
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Key of a cached pose evaluation: position in global pixel coordinates (quantized), robot and wheel descriptor indices
+ */
+struct PoseCacheKey
+{
+    int x,y;
+    int angleIdx;
+    cv::Vec4i wheelAngleIdx;
+
+    inline bool operator==(const PoseCacheKey &other) const
+    {
+        return x == other.x && y == other.y && angleIdx == other.angleIdx && wheelAngleIdx == other.wheelAngleIdx;
+    }
+};
+
+/**
+ * @brief Hash function for PoseCacheKey
+ */
+struct PoseCacheKeyHash
+{
+    inline std::size_t operator()(const PoseCacheKey &key) const
+    {
+        std::size_t h = (std::size_t)(unsigned int)key.x;
+        h = h*73856093u ^ (std::size_t)(unsigned int)key.y*19349663u;
+        h = h*83492791u ^ (std::size_t)key.angleIdx;
+        h = h*31u ^ (std::size_t)key.wheelAngleIdx[0];
+        h = h*31u ^ (std::size_t)key.wheelAngleIdx[1];
+        h = h*31u ^ (std::size_t)key.wheelAngleIdx[2];
+        h = h*31u ^ (std::size_t)key.wheelAngleIdx[3];
+        return h;
+    }
+};
+
+
+/**
+ * @brief Cache for pose evaluations that is kept across planning cycles.
+ * The DEM is divided into square blocks in global pixel coordinates. Each new DEM is compared block by block to the previous one,
+ * every block whose content changed gets the current cycle as revision. A cached pose is valid as long as no block within the
+ * robot footprint around it was changed after the pose was evaluated.
+ */
+class PoseEvalCache
+{
+public:
+    PoseEvalCache();
+
+    /**
+     * @brief Setup the cache, blockSize <= 0 disables it
+     * @param blockSize size of the DEM blocks in pixels
+     * @param resolution quantization of the pose position in pixels
+     * @param maxEntries maximum number of cached poses
+     * @param footprintRadius radius in pixels around a pose that contains all DEM pixels read by the pose evaluation
+     */
+    void Setup(int blockSize, float resolution, int maxEntries, int footprintRadius);
+
+    /**
+     * @brief True if the cache is used
+     */
+    bool IsEnabled() const {return blockSize_ > 0;}
+
+    /**
+     * @brief Start a new cycle with a new DEM, demOffset is the position of the DEM origin in global pixel coordinates
+     */
+    void UpdateDem(CVAlignedMat::ptr demPtr, const cv::Point2f &demOffset);
+
+    /**
+     * @brief Remove all entries and block revisions
+     */
+    void Clear();
+
+    /**
+     * @brief Create the key for a pose in DEM image coordinates
+     */
+    inline PoseCacheKey GetKey(const cv::Point3f &pose, const int angleIdx, const cv::Vec4i &wheelAngleIdx) const
+    {
+        PoseCacheKey key;
+        key.x = (int)std::floor((pose.x+demOffset_.x)*resolutionInv_+0.5f);
+        key.y = (int)std::floor((pose.y+demOffset_.y)*resolutionInv_+0.5f);
+        key.angleIdx = angleIdx;
+        key.wheelAngleIdx = wheelAngleIdx;
+        return key;
+    }
+
+    /**
+     * @brief Copies the cached evaluation into results if a valid entry exists, the pose and cmd of results are kept
+     */
+    bool Lookup(const PoseCacheKey &key, PoseEvalResults &results);
+
+    /**
+     * @brief Store an evaluation result
+     */
+    void Insert(const PoseCacheKey &key, const PoseEvalResults &results);
+
+    /**
+     * @brief Number of hits and misses since the last UpdateDem
+     */
+    int GetNumHits() const {return numHits_;}
+    int GetNumMisses() const {return numMisses_;}
+    std::size_t GetNumEntries() const {return entries_.size();}
+
+private:
+
+    struct Entry
+    {
+        PoseEvalResults results;
+        int cycle;
+    };
+
+    /**
+     * @brief Returns the latest revision of all blocks within the footprint of a key, the current cycle if unknown
+     */
+    inline int GetFootprintRevision(const PoseCacheKey &key) const
+    {
+        const int bx = FloorDiv((int)std::floor((float)key.x*resolution_),blockSize_)-blockOrigin_.x;
+        const int by = FloorDiv((int)std::floor((float)key.y*resolution_),blockSize_)-blockOrigin_.y;
+        if (bx < 0 || by < 0 || bx >= numBlocks_.width || by >= numBlocks_.height) return cycle_;
+        return footprintRevision_[by*numBlocks_.width+bx];
+    }
+
+    static inline int FloorDiv(const int a, const int b)
+    {
+        return a >= 0 ? a/b : -((-a+b-1)/b);
+    }
+
+    void Prune();
+
+    std::unordered_map<PoseCacheKey,Entry,PoseCacheKeyHash> entries_;
+
+    /// Block revisions and footprint dilated revisions of the current DEM
+    std::vector<int> blockRevision_;
+    std::vector<int> footprintRevision_;
+    cv::Point2i blockOrigin_;
+    cv::Size numBlocks_;
+
+    /// previous DEM used for the block comparison
+    CVAlignedMat::ptr prevDemPtr_;
+    cv::Mat prevDem_;
+    cv::Point2i prevOffset_;
+    cv::Point2f demOffset_;
+
+    int cycle_;
+    int blockSize_;
+    int maxEntries_;
+    int footprintRadius_;
+    float resolution_, resolutionInv_;
+
+    int numHits_, numMisses_;
+
+};
+
+#endif // POSEEVALCACHE_H
@@ -34,6 +34,24 @@ public:
      */
     int EvaluatePose(const cv::Mat &dem, PoseEvalResults &results) const;
 
+    /**
+     * @brief Get the robot and wheel descriptor indices EvaluatePose uses for the given pose, robotWheelAngle has to be set
+     */
+    inline void GetAngleIndices(const PoseEvalResults &results, int &angleIdx, cv::Vec4i &wheelAngleIdx) const
+    {
+        const float angle = NormalizeAngle(results.pose.z);
+        angleIdx = GetAngleIdxFast(angle);
+        for (int i = 0; i < 4; ++i)
+        {
+            wheelAngleIdx[i] = wheels_[i].IsTurnable() ? GetAngleIdxFast(angle+results.wheelEvalResults_[i].robotWheelAngle) : angleIdx;
+        }
+    }
+
+    /**
+     * @brief Radius in pixels around the base link containing all DEM pixels read by EvaluatePose
+     */
+    int GetFootprintRadius() const {return footprintRadius_;}
+
     /**
      * @brief Calculates the z-position of the base link
      */
@@ -235,6 +253,7 @@ private:
     float lw1_4,lw2_4,l_2, lw1_4Sqr, lw2_4Sqr;
     float w1_2, w2_2,w1pw2,w1mw2,mw1mw2;
     float fwZFactor,rwZFactor;
+    int footprintRadius_;
 
 
     ProcConfig procConfig_;
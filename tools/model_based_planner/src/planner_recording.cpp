@@ -0,0 +1,511 @@
+#include "planner_recording.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace PlannerRecordingFormat;
+
+namespace
+{
+
+const std::size_t FILE_HEADER_SIZE = sizeof(MAGIC) + 2*sizeof(std::uint32_t);
+
+// RLE tokens: 0..127 are followed by token+1 literal bytes, 128..254 skip token-127 unchanged bytes
+// and LONG_RUN is followed by the number of unchanged bytes as uint32
+const uchar MAX_LITERALS = 128;
+const uchar MAX_SHORT_RUN = 127;
+const uchar LONG_RUN = 255;
+
+inline std::size_t Padded(std::size_t size)
+{
+    return (size + 7) & ~(std::size_t)7;
+}
+
+template<typename T>
+inline void Put(std::vector<char> &buf, const T &value)
+{
+    const char *p = reinterpret_cast<const char*>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+inline void PutString(std::vector<char> &buf, const std::string &s)
+{
+    Put(buf, (std::uint32_t)s.size());
+    buf.insert(buf.end(), s.begin(), s.end());
+}
+
+/**
+ * @brief Bounds checked reading of a record payload
+ */
+class PayloadReader
+{
+public:
+    PayloadReader(const char *data, std::size_t size):
+        data_(data),
+        size_(size),
+        pos_(0)
+    {
+    }
+
+    const char* Skip(std::size_t n)
+    {
+        if (n > size_ - pos_) return nullptr;
+        const char *p = data_ + pos_;
+        pos_ += n;
+        return p;
+    }
+
+    template<typename T>
+    bool Get(T &value)
+    {
+        const char *p = Skip(sizeof(T));
+        if (p == nullptr) return false;
+        std::memcpy(&value, p, sizeof(T));
+        return true;
+    }
+
+    std::size_t Remaining() const
+    {
+        return size_ - pos_;
+    }
+
+    bool GetString(std::string &s)
+    {
+        std::uint32_t length;
+        if (!Get(length)) return false;
+        const char *p = Skip(length);
+        if (p == nullptr) return false;
+        s.assign(p, length);
+        return true;
+    }
+
+private:
+    const char *data_;
+    std::size_t size_;
+    std::size_t pos_;
+};
+
+inline uchar XorRef(const uchar *cur, const uchar *ref, std::size_t i)
+{
+    return ref == nullptr ? cur[i] : (uchar)(cur[i] ^ ref[i]);
+}
+
+/**
+ * @brief Run length encoding of cur xor ref, ref == nullptr encodes cur itself
+ */
+void EncodeXorRLE(const uchar *cur, const uchar *ref, std::size_t n, std::vector<char> &out)
+{
+    std::size_t i = 0;
+    while (i < n)
+    {
+        std::size_t run = 0;
+        while (i + run < n && XorRef(cur, ref, i + run) == 0) run++;
+
+        // a single unchanged byte between changes is cheaper as literal
+        if (run >= 2 || (run > 0 && i + run == n))
+        {
+            if (run > MAX_SHORT_RUN)
+            {
+                out.push_back((char)LONG_RUN);
+                Put(out, (std::uint32_t)run);
+            }
+            else
+            {
+                out.push_back((char)(MAX_SHORT_RUN + run));
+            }
+            i += run;
+            continue;
+        }
+
+        std::size_t tokenPos = out.size();
+        out.push_back(0);
+        std::size_t count = 0;
+        while (i < n && count < MAX_LITERALS)
+        {
+            if (XorRef(cur, ref, i) == 0 && (i + 1 == n || XorRef(cur, ref, i + 1) == 0)) break;
+            out.push_back((char)XorRef(cur, ref, i));
+            i++;
+            count++;
+        }
+        out[tokenPos] = (char)(count - 1);
+    }
+}
+
+/**
+ * @brief Apply an encoding of EncodeXorRLE to dst in place
+ */
+bool DecodeXorRLE(const uchar *in, std::size_t inSize, uchar *dst, std::size_t n)
+{
+    std::size_t pos = 0;
+    std::size_t i = 0;
+    while (pos < inSize)
+    {
+        const uchar token = in[pos++];
+        if (token < MAX_LITERALS)
+        {
+            const std::size_t count = token + 1;
+            if (count > inSize - pos || count > n - i) return false;
+            for (std::size_t k = 0; k < count; ++k) dst[i + k] ^= in[pos + k];
+            pos += count;
+            i += count;
+        }
+        else
+        {
+            std::size_t run = token - MAX_SHORT_RUN;
+            if (token == LONG_RUN)
+            {
+                std::uint32_t longRun;
+                if (sizeof(longRun) > inSize - pos) return false;
+                std::memcpy(&longRun, in + pos, sizeof(longRun));
+                pos += sizeof(longRun);
+                run = longRun;
+            }
+            if (run > n - i) return false;
+            i += run;
+        }
+    }
+    return i == n;
+}
+
+bool ReadFile(const std::string &fileName, std::vector<char> &content)
+{
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    if (!in.is_open()) return false;
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+}
+
+
+PlannerRecorder::PlannerRecorder()
+{
+    hasPath_ = false;
+    keyFrameInterval_ = 50;
+    framesSinceKey_ = 0;
+}
+
+bool PlannerRecorder::Open(const std::string &fileName)
+{
+    Close();
+    out_.open(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) return false;
+
+    out_.write(MAGIC, sizeof(MAGIC));
+    std::uint32_t header[2] = {VERSION, 0};
+    out_.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out_.flush();
+
+    hasPath_ = false;
+    prevDem_.release();
+    return true;
+}
+
+void PlannerRecorder::Close()
+{
+    if (out_.is_open()) out_.close();
+}
+
+void PlannerRecorder::WriteRecord(std::uint32_t type, const std::vector<char> &payload)
+{
+    if (!out_.is_open()) return;
+
+    RecordHeader header;
+    header.type = type;
+    header.size = (std::uint32_t)payload.size();
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_.write(payload.data(), payload.size());
+
+    const char zeros[8] = {0};
+    out_.write(zeros, Padded(payload.size()) - payload.size());
+
+    // a crash leaves a valid recording of all cycles so far
+    out_.flush();
+}
+
+void PlannerRecorder::WriteConfig(const ModelBasedPlannerConfig &config)
+{
+    if (!out_.is_open()) return;
+
+    buffer_.clear();
+    Put(buffer_, (std::uint32_t)sizeof(ProcConfig));
+    Put(buffer_, (std::uint32_t)sizeof(RobotConfig));
+    Put(buffer_, (std::uint32_t)sizeof(PlannerConfig));
+    Put(buffer_, (std::uint32_t)sizeof(PlannerScorerConfig));
+    Put(buffer_, (std::uint32_t)sizeof(PlannerExpanderConfig));
+    Put(buffer_, (std::uint32_t)sizeof(WheelsConfig));
+    Put(buffer_, config.procConfig_);
+    Put(buffer_, config.robotConfig_);
+    Put(buffer_, config.plannerConfig_);
+    Put(buffer_, config.scorerConfig_);
+    Put(buffer_, config.expanderConfig_);
+    Put(buffer_, config.wheelsConfig_);
+
+    PutString(buffer_, config.plannerType_);
+    PutString(buffer_, config.nodeExpanderType_);
+    PutString(buffer_, config.scorerType_);
+
+    const ChassisConfig &chassis = config.chassisConfig_;
+    Put(buffer_, chassis.chassisPosRobot);
+    Put(buffer_, chassis.chassisImageCenter);
+    Put(buffer_, chassis.chassisModelYSize);
+    Put(buffer_, chassis.chassisImageValueScale);
+    Put(buffer_, chassis.chassisImageValueOffset);
+    Put(buffer_, (std::uint8_t)chassis.testChassis);
+    PutString(buffer_, chassis.chassisfileName);
+
+    std::vector<char> image;
+    ReadFile(chassis.chassisfileName, image);
+    PutString(buffer_, std::string(image.begin(), image.end()));
+
+    WriteRecord(RT_CONFIG, buffer_);
+}
+
+void PlannerRecorder::WritePath(const cv::Point3f &goal, const std::vector<cv::Point3f> &path)
+{
+    if (!out_.is_open()) return;
+    if (hasPath_ && goal == lastGoal_ && path == lastPath_) return;
+
+    buffer_.clear();
+    Put(buffer_, goal);
+    Put(buffer_, (std::uint32_t)path.size());
+    const char *p = reinterpret_cast<const char*>(path.data());
+    buffer_.insert(buffer_.end(), p, p + path.size()*sizeof(cv::Point3f));
+    WriteRecord(RT_PATH, buffer_);
+
+    lastGoal_ = goal;
+    lastPath_ = path;
+    hasPath_ = true;
+}
+
+void PlannerRecorder::WriteCycle(const PlanningCycle &cycle, const cv::Mat &dem)
+{
+    if (!out_.is_open()) return;
+
+    cv::Mat cur = dem.isContinuous() ? dem : dem.clone();
+
+    bool keyFrame = prevDem_.empty() || prevDem_.size() != cur.size() || prevDem_.type() != cur.type();
+    if (++framesSinceKey_ >= keyFrameInterval_) keyFrame = true;
+    if (keyFrame) framesSinceKey_ = 0;
+
+    buffer_.clear();
+    Put(buffer_, cycle.stamp);
+    Put(buffer_, cycle.pose);
+    Put(buffer_, cycle.velocity);
+    Put(buffer_, cycle.demPos);
+    Put(buffer_, cycle.command);
+    Put(buffer_, cycle.planningMS);
+    Put(buffer_, (std::int32_t)cycle.poseCount);
+
+    Put(buffer_, (std::int32_t)cur.rows);
+    Put(buffer_, (std::int32_t)cur.cols);
+    Put(buffer_, (std::int32_t)cur.type());
+    Put(buffer_, (std::uint8_t)keyFrame);
+
+    const std::size_t bytes = cur.total()*cur.elemSize();
+    EncodeXorRLE(cur.data, keyFrame ? nullptr : prevDem_.data, bytes, buffer_);
+
+    WriteRecord(RT_CYCLE, buffer_);
+
+    cur.copyTo(prevDem_);
+}
+
+
+PlannerRecording::PlannerRecording()
+{
+    data_ = nullptr;
+    size_ = 0;
+    offset_ = 0;
+    cycleCount_ = 0;
+}
+
+PlannerRecording::~PlannerRecording()
+{
+    Close();
+}
+
+bool PlannerRecording::Open(const std::string &fileName)
+{
+    Close();
+    error_.clear();
+
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error_ = "cannot open " + fileName;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < FILE_HEADER_SIZE)
+    {
+        close(fd);
+        error_ = "not a planner recording: " + fileName;
+        return false;
+    }
+
+    void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        error_ = "cannot map " + fileName;
+        return false;
+    }
+    madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const char*>(mapped);
+    size_ = st.st_size;
+
+    std::uint32_t version;
+    std::memcpy(&version, data_ + sizeof(MAGIC), sizeof(version));
+    if (std::memcmp(data_, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION)
+    {
+        Close();
+        error_ = "not a planner recording or unsupported version: " + fileName;
+        return false;
+    }
+
+    Rewind();
+    return true;
+}
+
+void PlannerRecording::Close()
+{
+    if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    offset_ = 0;
+}
+
+void PlannerRecording::Rewind()
+{
+    offset_ = FILE_HEADER_SIZE;
+    cycleCount_ = 0;
+    dem_.release();
+}
+
+int PlannerRecording::Next()
+{
+    while (data_ != nullptr && size_ - offset_ >= sizeof(RecordHeader))
+    {
+        RecordHeader header;
+        std::memcpy(&header, data_ + offset_, sizeof(header));
+        const char *payload = data_ + offset_ + sizeof(header);
+        if (header.size > size_ - offset_ - sizeof(header))
+        {
+            // the recording was interrupted while writing this record
+            offset_ = size_;
+            return 0;
+        }
+        offset_ = std::min(size_, offset_ + sizeof(header) + Padded(header.size));
+
+        bool ok = true;
+        switch (header.type)
+        {
+        case RT_CONFIG: ok = ReadConfig(payload, header.size); break;
+        case RT_PATH: ok = ReadPath(payload, header.size); break;
+        case RT_CYCLE: ok = ReadCycle(payload, header.size); break;
+        default: continue; // unknown records are skipped
+        }
+
+        if (!ok)
+        {
+            if (error_.empty()) error_ = "corrupt record";
+            offset_ = size_;
+            return 0;
+        }
+        return header.type;
+    }
+    return 0;
+}
+
+bool PlannerRecording::ReadConfig(const char *data, std::size_t size)
+{
+    PayloadReader in(data, size);
+
+    std::uint32_t sizes[6];
+    for (int i = 0; i < 6; ++i) if (!in.Get(sizes[i])) return false;
+    if (sizes[0] != sizeof(ProcConfig) || sizes[1] != sizeof(RobotConfig) || sizes[2] != sizeof(PlannerConfig) ||
+            sizes[3] != sizeof(PlannerScorerConfig) || sizes[4] != sizeof(PlannerExpanderConfig) ||
+            sizes[5] != sizeof(WheelsConfig))
+    {
+        error_ = "config layout of the recording differs from this build";
+        return false;
+    }
+
+    ModelBasedPlannerConfig config;
+    std::uint8_t testChassis;
+    std::string image;
+    ChassisConfig &chassis = config.chassisConfig_;
+    if (!in.Get(config.procConfig_) || !in.Get(config.robotConfig_) || !in.Get(config.plannerConfig_) ||
+            !in.Get(config.scorerConfig_) || !in.Get(config.expanderConfig_) || !in.Get(config.wheelsConfig_) ||
+            !in.GetString(config.plannerType_) || !in.GetString(config.nodeExpanderType_) ||
+            !in.GetString(config.scorerType_) ||
+            !in.Get(chassis.chassisPosRobot) || !in.Get(chassis.chassisImageCenter) ||
+            !in.Get(chassis.chassisModelYSize) || !in.Get(chassis.chassisImageValueScale) ||
+            !in.Get(chassis.chassisImageValueOffset) || !in.Get(testChassis) ||
+            !in.GetString(chassis.chassisfileName) || !in.GetString(image))
+    {
+        return false;
+    }
+    chassis.testChassis = testChassis != 0;
+
+    config_ = config;
+    chassisImage_.assign(image.begin(), image.end());
+    return true;
+}
+
+bool PlannerRecording::ReadPath(const char *data, std::size_t size)
+{
+    PayloadReader in(data, size);
+
+    std::uint32_t count;
+    if (!in.Get(goal_) || !in.Get(count)) return false;
+    const char *points = in.Skip((std::size_t)count*sizeof(cv::Point3f));
+    if (points == nullptr) return false;
+
+    path_.resize(count);
+    std::memcpy(path_.data(), points, (std::size_t)count*sizeof(cv::Point3f));
+    return true;
+}
+
+bool PlannerRecording::ReadCycle(const char *data, std::size_t size)
+{
+    PayloadReader in(data, size);
+
+    std::int32_t poseCount, rows, cols, type;
+    std::uint8_t keyFrame;
+    if (!in.Get(cycle_.stamp) || !in.Get(cycle_.pose) || !in.Get(cycle_.velocity) || !in.Get(cycle_.demPos) ||
+            !in.Get(cycle_.command) || !in.Get(cycle_.planningMS) || !in.Get(poseCount) ||
+            !in.Get(rows) || !in.Get(cols) || !in.Get(type) || !in.Get(keyFrame))
+    {
+        return false;
+    }
+    cycle_.poseCount = poseCount;
+    if (rows < 0 || cols < 0) return false;
+
+    if (keyFrame)
+    {
+        dem_.create(rows, cols, type);
+        dem_.setTo(cv::Scalar::all(0));
+    }
+    else if (dem_.rows != rows || dem_.cols != cols || dem_.type() != type)
+    {
+        // a delta frame has to follow a frame of the same layout
+        return false;
+    }
+
+    const std::size_t encodedSize = in.Remaining();
+    const char *encoded = in.Skip(encodedSize);
+    if (!DecodeXorRLE(reinterpret_cast<const uchar*>(encoded), encodedSize, dem_.data, dem_.total()*dem_.elemSize()))
+    {
+        return false;
+    }
+
+    cycleCount_++;
+    return true;
+}
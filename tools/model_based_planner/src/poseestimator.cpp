@@ -17,6 +17,9 @@ void PoseEstimator::Setup(ModelBasedPlannerConfig &config)
     //procConfig_ = config.procConfig_;
     //scorerConfig_ = config.scorerConfig_;
     robotModel_.SetupRobot(config);
+
+    const PlannerConfig &pc = config.plannerConfig_;
+    cache_.Setup(pc.poseCacheBlockSize,pc.poseCacheResolution,pc.poseCacheMaxEntries,robotModel_.GetFootprintRadius());
 }
 
 
@@ -27,20 +30,34 @@ void PoseEstimator::SetDem(CVAlignedMat::ptr dem)
 
     dem_ = demPtr_->mat_;
 
+    const float pixelSizeInv = robotModel_.GetProcConfig().pixelSizeInv;
+    cache_.UpdateDem(demPtr_,cv::Point2f(imagePosBLMinX*pixelSizeInv,imagePosBLMinY*pixelSizeInv));
+
 }
 void PoseEstimator::SetDem(cv::Mat dem)
 {
-    demPtr_ = CVAlignedMat::Create(dem);
-
-    dem_ = demPtr_->mat_;
-
+    SetDem(CVAlignedMat::Create(dem));
 }
 
 
 void PoseEstimator::Evaluate(PoseEvalResults &results) const
 {
     //const int res = robotModel_.EvaluatePose(dem_,results);
+    if (!cache_.IsEnabled())
+    {
+        robotModel_.EvaluatePose(dem_,results);
+        return;
+    }
+
+    int angleIdx;
+    cv::Vec4i wheelAngleIdx;
+    robotModel_.GetAngleIndices(results,angleIdx,wheelAngleIdx);
+    const PoseCacheKey key = cache_.GetKey(results.pose,angleIdx,wheelAngleIdx);
+
+    if (cache_.Lookup(key,results)) return;
+
     robotModel_.EvaluatePose(dem_,results);
+    cache_.Insert(key,results);
 
     //++poseCounter_;
 
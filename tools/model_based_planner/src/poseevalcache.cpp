@@ -0,0 +1,182 @@
+#include "poseevalcache.h"
+#include <cstring>
+
+PoseEvalCache::PoseEvalCache()
+{
+    cycle_ = 0;
+    blockSize_ = 0;
+    maxEntries_ = 0;
+    footprintRadius_ = 0;
+    resolution_ = 1.0f;
+    resolutionInv_ = 1.0f;
+
+    blockOrigin_ = cv::Point2i(0,0);
+    numBlocks_ = cv::Size(0,0);
+    prevOffset_ = cv::Point2i(0,0);
+    demOffset_ = cv::Point2f(0,0);
+
+    numHits_ = 0;
+    numMisses_ = 0;
+}
+
+void PoseEvalCache::Setup(int blockSize, float resolution, int maxEntries, int footprintRadius)
+{
+    blockSize_ = blockSize;
+    resolution_ = resolution > 0 ? resolution : 1.0f;
+    resolutionInv_ = 1.0f/resolution_;
+    maxEntries_ = maxEntries;
+    footprintRadius_ = footprintRadius;
+
+    Clear();
+}
+
+void PoseEvalCache::Clear()
+{
+    entries_.clear();
+    blockRevision_.clear();
+    footprintRevision_.clear();
+    numBlocks_ = cv::Size(0,0);
+    prevDemPtr_ = nullptr;
+    prevDem_ = cv::Mat();
+}
+
+void PoseEvalCache::UpdateDem(CVAlignedMat::ptr demPtr, const cv::Point2f &demOffset)
+{
+    if (!IsEnabled()) return;
+
+    const cv::Mat &dem = demPtr->mat_;
+
+    ++cycle_;
+    numHits_ = 0;
+    numMisses_ = 0;
+
+    const cv::Point2i offset((int)std::floor(demOffset.x+0.5f),(int)std::floor(demOffset.y+0.5f));
+
+    /// The block comparison requires the new DEM grid to be shifted by whole pixels
+    const cv::Point2f subPixel(demOffset.x-(float)offset.x,demOffset.y-(float)offset.y);
+    const cv::Point2f prevSubPixel(demOffset_.x-(float)prevOffset_.x,demOffset_.y-(float)prevOffset_.y);
+    if (std::abs(subPixel.x-prevSubPixel.x) > 0.05f || std::abs(subPixel.y-prevSubPixel.y) > 0.05f || prevDem_.type() != dem.type())
+    {
+        Clear();
+    }
+
+    const cv::Point2i newOrigin(FloorDiv(offset.x,blockSize_),FloorDiv(offset.y,blockSize_));
+    const cv::Size newNumBlocks(FloorDiv(offset.x+dem.cols-1,blockSize_)-newOrigin.x+1,FloorDiv(offset.y+dem.rows-1,blockSize_)-newOrigin.y+1);
+
+    std::vector<int> newRevision(newNumBlocks.width*newNumBlocks.height,cycle_);
+
+    const cv::Rect demRect(offset.x,offset.y,dem.cols,dem.rows);
+    const cv::Rect prevRect(prevOffset_.x,prevOffset_.y,prevDem_.cols,prevDem_.rows);
+    const std::size_t rowBytes = blockSize_*dem.elemSize();
+
+    for (int by = 0; by < newNumBlocks.height; ++by)
+    {
+        for (int bx = 0; bx < newNumBlocks.width; ++bx)
+        {
+            const cv::Rect block((newOrigin.x+bx)*blockSize_,(newOrigin.y+by)*blockSize_,blockSize_,blockSize_);
+
+            /// Blocks not fully covered by both DEMs always count as changed
+            if ((block & demRect) != block || (block & prevRect) != block) continue;
+
+            bool equal = true;
+            for (int y = 0; y < blockSize_ && equal; ++y)
+            {
+                const uchar* newRow = dem.ptr(block.y-offset.y+y)+(block.x-offset.x)*dem.elemSize();
+                const uchar* prevRow = prevDem_.ptr(block.y-prevOffset_.y+y)+(block.x-prevOffset_.x)*prevDem_.elemSize();
+                equal = memcmp(newRow,prevRow,rowBytes) == 0;
+            }
+            if (!equal) continue;
+
+            const int ox = newOrigin.x+bx-blockOrigin_.x;
+            const int oy = newOrigin.y+by-blockOrigin_.y;
+            if (ox >= 0 && oy >= 0 && ox < numBlocks_.width && oy < numBlocks_.height)
+            {
+                newRevision[by*newNumBlocks.width+bx] = blockRevision_[oy*numBlocks_.width+ox];
+            }
+        }
+    }
+
+    blockRevision_.swap(newRevision);
+    blockOrigin_ = newOrigin;
+    numBlocks_ = newNumBlocks;
+
+    /// Dilate the revisions by the robot footprint (separable max filter), blocks outside of the DEM count as changed
+    const int r = (int)std::ceil(((float)footprintRadius_+resolution_)/(float)blockSize_);
+    std::vector<int> tmp(blockRevision_.size());
+    footprintRevision_.resize(blockRevision_.size());
+
+    for (int by = 0; by < numBlocks_.height; ++by)
+    {
+        for (int bx = 0; bx < numBlocks_.width; ++bx)
+        {
+            int rev = (bx-r < 0 || bx+r >= numBlocks_.width) ? cycle_ : 0;
+            for (int x = std::max(0,bx-r); x <= std::min(numBlocks_.width-1,bx+r); ++x) rev = std::max(rev,blockRevision_[by*numBlocks_.width+x]);
+            tmp[by*numBlocks_.width+bx] = rev;
+        }
+    }
+    for (int by = 0; by < numBlocks_.height; ++by)
+    {
+        for (int bx = 0; bx < numBlocks_.width; ++bx)
+        {
+            int rev = (by-r < 0 || by+r >= numBlocks_.height) ? cycle_ : 0;
+            for (int y = std::max(0,by-r); y <= std::min(numBlocks_.height-1,by+r); ++y) rev = std::max(rev,tmp[y*numBlocks_.width+bx]);
+            footprintRevision_[by*numBlocks_.width+bx] = rev;
+        }
+    }
+
+    /// The DEM is not modified after it was set, so it is safe to keep a reference
+    prevDemPtr_ = demPtr;
+    prevDem_ = dem;
+    prevOffset_ = offset;
+    demOffset_ = demOffset;
+
+    if ((int)entries_.size() >= maxEntries_) Prune();
+}
+
+void PoseEvalCache::Prune()
+{
+    for (auto it = entries_.begin(); it != entries_.end();)
+    {
+        if (it->second.cycle < GetFootprintRevision(it->first)) it = entries_.erase(it);
+        else ++it;
+    }
+
+    /// Still full with valid entries, start over
+    if ((int)entries_.size() >= maxEntries_) entries_.clear();
+}
+
+bool PoseEvalCache::Lookup(const PoseCacheKey &key, PoseEvalResults &results)
+{
+    const auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.cycle < GetFootprintRevision(key))
+    {
+        ++numMisses_;
+        return false;
+    }
+
+    const cv::Point3f pose = results.pose;
+    const cv::Point2f cmd = results.cmd;
+    const cv::Vec4f wheelAnglesRobot(results.wheelEvalResults_[0].robotWheelAngle,results.wheelEvalResults_[1].robotWheelAngle,results.wheelEvalResults_[2].robotWheelAngle,results.wheelEvalResults_[3].robotWheelAngle);
+
+    results = it->second.results;
+
+    results.pose = pose;
+    results.cmd = cmd;
+    results.SetWheelAnglesRobot(wheelAnglesRobot);
+
+    ++numHits_;
+    return true;
+}
+
+void PoseEvalCache::Insert(const PoseCacheKey &key, const PoseEvalResults &results)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+        if ((int)entries_.size() >= maxEntries_) return;
+        it = entries_.insert(std::make_pair(key,Entry())).first;
+    }
+
+    it->second.results = results;
+    it->second.cycle = cycle_;
+}
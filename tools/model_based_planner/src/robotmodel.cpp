@@ -6,6 +6,7 @@
 
 RobotModel::RobotModel()
 {
+    footprintRadius_ = 0;
 
 }
 
@@ -899,4 +900,28 @@ void RobotModel::SetupRobot(const ProcConfig &procConfig, const RobotConfig &rob
 
     }
 
+    /// Bounding radius of all wheel and chassis images around the base link for all orientations
+    float footprint = 0;
+    for (unsigned int a = 0; a < descriptors_.size(); ++a)
+    {
+        const RobotDescriptor &desc = descriptors_[a];
+        for (unsigned int i = 0; i < wheels_.size(); ++i)
+        {
+            const float wheelDist = (float)cv::norm(desc.wheelPositionsImage_[i]-desc.baseLinkPosImage_);
+            for (unsigned int w = 0; w < wheels_[i].descriptors_.size(); ++w)
+            {
+                const WheelDescriptor &wDesc = wheels_[i].descriptors_[w];
+                const cv::Mat &wImg = wDesc.image_->mat_;
+                footprint = std::max(footprint,wheelDist+(float)cv::norm(wDesc.jointPosImg_)+(float)std::sqrt(wImg.cols*wImg.cols+wImg.rows*wImg.rows));
+            }
+        }
+        if (chassisModel_.TestChassis())
+        {
+            const ChassisDescriptor &cDesc = chassisModel_.GetDescriptorIdx(a);
+            const cv::Mat &cImg = cDesc.image_->mat_;
+            footprint = std::max(footprint,(float)cv::norm(desc.chassisPosImage_-desc.baseLinkPosImage_)+(float)cv::norm(cDesc.centerImg_)+(float)std::sqrt(cImg.cols*cImg.cols+cImg.rows*cImg.rows));
+        }
+    }
+    footprintRadius_ = (int)std::ceil(footprint)+2;
+
 }
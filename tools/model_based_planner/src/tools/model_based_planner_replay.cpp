@@ -0,0 +1,187 @@
+/**
+ * Replays a planner recording (see planner_recording.h) as fast as possible and reports the planning times.
+ *
+ * usage: model_based_planner_replay <recording> [repetitions]
+ */
+#include <imodelbasedplanner.h>
+#include <planner_recording.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <unistd.h>
+
+namespace
+{
+
+const float COMMAND_TOLERANCE = 1e-4f;
+
+/**
+ * @brief Write the embedded chassis image to a temporary file, the chassis model is loaded from a file
+ */
+std::string WriteChassisImage(const std::vector<uchar> &image)
+{
+    char fileName[] = "/tmp/mbp_chassis_XXXXXX";
+    int fd = mkstemp(fileName);
+    if (fd < 0) return "";
+    bool ok = write(fd, image.data(), image.size()) == (ssize_t)image.size();
+    close(fd);
+    if (!ok)
+    {
+        unlink(fileName);
+        return "";
+    }
+    return fileName;
+}
+
+IModelBasedPlanner::Ptr CreatePlanner(const PlannerRecording &recording)
+{
+    ModelBasedPlannerConfig config = recording.GetConfig();
+
+    std::string chassisFile;
+    if (!recording.GetChassisImage().empty())
+    {
+        chassisFile = WriteChassisImage(recording.GetChassisImage());
+        if (chassisFile.empty())
+        {
+            std::cerr << "cannot write the chassis image" << std::endl;
+            return IModelBasedPlanner::Ptr();
+        }
+        config.chassisConfig_.chassisfileName = chassisFile;
+    }
+
+    IModelBasedPlanner::Ptr planner = IModelBasedPlanner::Create(config);
+
+    if (!chassisFile.empty()) unlink(chassisFile.c_str());
+    return planner;
+}
+
+double Percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty()) return 0;
+    std::size_t idx = std::min(sorted.size() - 1, (std::size_t)(p*sorted.size()));
+    return sorted[idx];
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <recording> [repetitions]" << std::endl;
+        return 1;
+    }
+    const int repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1;
+
+    PlannerRecording recording;
+    if (!recording.Open(argv[1]))
+    {
+        std::cerr << recording.GetError() << std::endl;
+        return 1;
+    }
+
+    IModelBasedPlanner::Ptr planner;
+    std::vector<double> planMS;
+    double recordedMS = 0;
+    long poseCount = 0;
+    long recordedPoseCount = 0;
+    int divergedCycles = 0;
+    int firstDiverged = -1;
+
+    for (int rep = 0; rep < repetitions; ++rep)
+    {
+        recording.Rewind();
+
+        int type;
+        while ((type = recording.Next()) != 0)
+        {
+            if (type == PlannerRecordingFormat::RT_CONFIG)
+            {
+                ModelBasedPlannerConfig config = recording.GetConfig();
+                if (!planner)
+                {
+                    planner = CreatePlanner(recording);
+                    if (!planner)
+                    {
+                        std::cerr << "cannot create the planner of type " << config.plannerType_ << "/"
+                                  << config.scorerType_ << std::endl;
+                        return 1;
+                    }
+                }
+                planner->SetPlannerParameters(config.plannerConfig_);
+                planner->SetPlannerExpanderParameters(config.expanderConfig_);
+                planner->SetPlannerScorerParameters(config.scorerConfig_);
+            }
+            else if (!planner)
+            {
+                std::cerr << "recording does not start with a config" << std::endl;
+                return 1;
+            }
+            else if (type == PlannerRecordingFormat::RT_PATH)
+            {
+                planner->SetGoalMap(recording.GetGoal());
+                planner->SetPathMap(recording.GetPath());
+            }
+            else if (type == PlannerRecordingFormat::RT_CYCLE)
+            {
+                const PlanningCycle &cycle = recording.GetCycle();
+
+                planner->SetDEMPos(cycle.demPos);
+                planner->SetRobotPose(cycle.pose);
+                planner->SetVelocity(cycle.velocity);
+                planner->UpdateDEM(recording.GetDEM());
+
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                cv::Point2f command = planner->Plan();
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+                planMS.push_back(elapsed.count());
+                poseCount += planner->GetPoseCount();
+                if (rep == 0)
+                {
+                    recordedMS += cycle.planningMS;
+                    recordedPoseCount += cycle.poseCount;
+
+                    cv::Point2f diff = command - cycle.command;
+                    if (std::abs(diff.x) > COMMAND_TOLERANCE || std::abs(diff.y) > COMMAND_TOLERANCE)
+                    {
+                        if (firstDiverged < 0) firstDiverged = recording.GetCycleCount() - 1;
+                        divergedCycles++;
+                    }
+                }
+            }
+        }
+
+        if (!recording.GetError().empty())
+        {
+            std::cerr << "recording ends early: " << recording.GetError() << std::endl;
+        }
+    }
+
+    const int cycles = recording.GetCycleCount();
+    if (cycles == 0)
+    {
+        std::cerr << "recording contains no planning cycles" << std::endl;
+        return 1;
+    }
+
+    double totalMS = 0;
+    for (double ms : planMS) totalMS += ms;
+    std::vector<double> sorted = planMS;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::printf("cycles: %d x %d\n", cycles, repetitions);
+    std::printf("plan [ms]: mean %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f\n", totalMS/planMS.size(),
+                Percentile(sorted, 0.5), Percentile(sorted, 0.9), Percentile(sorted, 0.99), sorted.back());
+    std::printf("recorded plan [ms]: mean %.3f\n", recordedMS/cycles);
+    std::printf("poses per cycle: %.1f (recorded %.1f)\n", poseCount/(double)planMS.size(),
+                recordedPoseCount/(double)cycles);
+    std::printf("diverged commands: %d", divergedCycles);
+    if (firstDiverged >= 0) std::printf(", first in cycle %d", firstDiverged);
+    std::printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * Test of the rasterised path distance of NodeScorer_Path_T.
+ */
+#include <gtest/gtest.h>
+#include <planner_scorer.h>
+#include <cmath>
+#include <random>
+
+TEST(TestPathScorer, pathFieldMatchesSegmentDistance)
+{
+    NodeScorer_Path_T scorer;
+    scorer.SetMapSize(cv::Size(200, 150));
+
+    // a curved path with non integer coordinates that leaves the DEM on both sides, but stays inside of the field
+    std::vector<cv::Point3f> path;
+    for (int i = 0; i <= 60; ++i)
+    {
+        const float t = (float)i/60.0f;
+        path.push_back(cv::Point3f(-40.3f + 280.0f*t, 75.2f + 50.0f*std::sin(6.0f*t), 0));
+    }
+    scorer.SetPath(path);
+    ASSERT_FALSE(scorer.pathDistField_.empty());
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> x(-60.0f, 260.0f);
+    std::uniform_real_distribution<float> y(-50.0f, 200.0f);
+
+    int inField = 0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        const cv::Point3f p(x(rng), y(rng), 0);
+        const float exact = scorer.GetMinPathDistanceSegments(p);
+
+        float field;
+        if (scorer.LookupPathField(scorer.pathDistField_, p, field))
+        {
+            ++inField;
+            EXPECT_NEAR(exact, field, NodeScorer_Path_T::PATH_FIELD_TOLERANCE);
+        }
+        // outside of the field the exact distance is used
+        EXPECT_NEAR(exact, scorer.GetMinPathDistance(p), NodeScorer_Path_T::PATH_FIELD_TOLERANCE);
+    }
+    EXPECT_GT(inField, 1000);
+}
+
+TEST(TestPathScorer, pathOutsideOfFieldFallsBackToSegments)
+{
+    NodeScorer_Path_T scorer;
+    scorer.SetMapSize(cv::Size(100, 100));
+
+    std::vector<cv::Point3f> path;
+    path.push_back(cv::Point3f(500, 500, 0));
+    path.push_back(cv::Point3f(600, 500, 0));
+    scorer.SetPath(path);
+
+    const cv::Point3f p(50, 50, 0);
+    EXPECT_FLOAT_EQ(scorer.GetMinPathDistanceSegments(p), scorer.GetMinPathDistance(p));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
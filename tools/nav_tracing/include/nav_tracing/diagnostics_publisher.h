@@ -0,0 +1,48 @@
+#ifndef NAV_TRACING_DIAGNOSTICS_PUBLISHER_H
+#define NAV_TRACING_DIAGNOSTICS_PUBLISHER_H
+
+/// PROJECT
+#include <nav_tracing/tracing.h>
+
+/// SYSTEM
+#include <ros/ros.h>
+#include <std_srvs/Trigger.h>
+
+namespace nav_tracing
+{
+
+/**
+ * @brief The DiagnosticsPublisher class periodically collects the spans of the Tracer and publishes
+ *        the latency of every stage on /diagnostics.
+ *
+ * Parameters (relative to the given private node handle):
+ * - tracing/enabled (true): record spans at all
+ * - tracing/publish_rate (1.0): rate in Hz of collecting and publishing
+ * - tracing/window (1024): number of samples per stage used for the percentiles
+ * - tracing/history (100000): number of spans kept for the Chrome trace
+ * - tracing/trace_file (""): the Chrome trace is written to this file on shutdown and on ~tracing/write_trace
+ */
+class DiagnosticsPublisher
+{
+public:
+    explicit DiagnosticsPublisher(ros::NodeHandle& nh_private);
+    ~DiagnosticsPublisher();
+
+    void publish();
+
+private:
+    void timerCallback(const ros::TimerEvent&);
+    bool writeTrace(std_srvs::Trigger::Request& req, std_srvs::Trigger::Response& res);
+
+private:
+    ros::NodeHandle nh_;
+    ros::Publisher diagnostics_pub_;
+    ros::ServiceServer write_trace_srv_;
+    ros::Timer timer_;
+
+    std::string trace_file_;
+};
+
+}
+
+#endif // NAV_TRACING_DIAGNOSTICS_PUBLISHER_H
@@ -0,0 +1,181 @@
+#ifndef NAV_TRACING_TRACING_H
+#define NAV_TRACING_TRACING_H
+
+/// SYSTEM
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace nav_tracing
+{
+
+/**
+ * @brief A finished span: <name> took <duration_ns> starting at <start_ns> (steady clock).
+ */
+struct Event
+{
+    const char* name;
+    std::uint64_t start_ns;
+    std::uint64_t duration_ns;
+    std::uint32_t thread;
+};
+
+/**
+ * @brief Latency statistics of one stage over the last Tracer::window() samples.
+ */
+struct StageStatistics
+{
+    std::string name;
+    std::uint64_t count;
+    double mean_ms;
+    double p50_ms;
+    double p90_ms;
+    double p99_ms;
+    double max_ms;
+};
+
+/**
+ * @brief The Tracer class collects the spans of all threads.
+ *
+ * Recording a span only writes to a ring buffer owned by the calling thread, there is no lock and no
+ * allocation on that path. If a ring buffer is full, the span is counted as dropped.
+ * collect() drains all buffers into the per-stage statistics and the history used for the Chrome trace,
+ * it is meant to be called periodically by one thread, e.g. by the DiagnosticsPublisher.
+ */
+class Tracer
+{
+public:
+    static Tracer& instance();
+
+    static std::uint64_t now();
+
+    bool isEnabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief record stores a finished span of the calling thread.
+     * @param name has to outlive the tracer, use string literals or intern()
+     */
+    void record(const char* name, std::uint64_t start_ns, std::uint64_t duration_ns);
+
+    /**
+     * @brief intern returns a pointer to a copy of <name> that lives as long as the tracer.
+     */
+    const char* intern(const std::string& name);
+
+    /**
+     * @brief collect drains the buffers of all threads.
+     * @return number of collected spans
+     */
+    std::size_t collect();
+
+    //! Number of registered thread buffers. The buffer of an exited thread is released by the next collect().
+    std::size_t threadBufferCount() const;
+
+    //! Statistics of all stages seen by collect(), sorted by name.
+    std::vector<StageStatistics> statistics() const;
+    void resetStatistics();
+
+    //! Number of spans that were lost because a thread buffer was full.
+    std::uint64_t dropped() const;
+
+    void setWindow(std::size_t samples);
+    std::size_t window() const;
+
+    void setHistory(std::size_t events);
+
+    /**
+     * @brief writeChromeTrace writes the collected history in the Chrome trace event format,
+     *        which can be opened with chrome://tracing or https://ui.perfetto.dev.
+     */
+    void writeChromeTrace(std::ostream& out) const;
+    bool writeChromeTrace(const std::string& file) const;
+
+private:
+    Tracer();
+
+    struct ThreadBuffer;
+    ThreadBuffer& threadBuffer();
+
+    struct Stage
+    {
+        Stage();
+
+        std::uint64_t count;
+        double sum_ms;
+        double max_ms;
+        std::vector<double> window;
+        std::size_t next;
+    };
+
+private:
+    std::atomic<bool> enabled_;
+    std::atomic<std::uint64_t> dropped_;
+
+    mutable std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    std::uint32_t next_thread_;
+
+    std::mutex names_mutex_;
+    std::set<std::string> names_;
+
+    mutable std::mutex collect_mutex_;
+    std::map<std::string, Stage> stages_;
+    std::deque<Event> history_;
+    std::size_t window_;
+    std::size_t history_size_;
+};
+
+/**
+ * @brief The Span class measures the time from its construction to end() or its destruction.
+ *        Nothing is measured while the tracer is disabled.
+ */
+class Span
+{
+public:
+    explicit Span(const char* name)
+        : name_(Tracer::instance().isEnabled() ? name : nullptr),
+          start_(name_ ? Tracer::now() : 0)
+    {
+    }
+
+    ~Span()
+    {
+        end();
+    }
+
+    void end()
+    {
+        if(name_) {
+            Tracer::instance().record(name_, start_, Tracer::now() - start_);
+            name_ = nullptr;
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name_;
+    std::uint64_t start_;
+};
+
+}
+
+#define NAV_TRACE_CONCAT_IMPL(a, b) a##b
+#define NAV_TRACE_CONCAT(a, b) NAV_TRACE_CONCAT_IMPL(a, b)
+
+/// Traces the rest of the enclosing scope as stage <name>, <name> has to be a string literal.
+#define NAV_TRACE_SCOPE(name) ::nav_tracing::Span NAV_TRACE_CONCAT(nav_trace_span_, __LINE__)(name)
+
+#endif // NAV_TRACING_TRACING_H
@@ -0,0 +1,110 @@
+/// HEADER
+#include <nav_tracing/diagnostics_publisher.h>
+
+/// SYSTEM
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <sstream>
+
+using namespace nav_tracing;
+
+namespace {
+diagnostic_msgs::KeyValue keyValue(const std::string& key, double value)
+{
+    diagnostic_msgs::KeyValue kv;
+    kv.key = key;
+    std::stringstream ss;
+    ss << value;
+    kv.value = ss.str();
+    return kv;
+}
+}
+
+DiagnosticsPublisher::DiagnosticsPublisher(ros::NodeHandle& nh_private)
+    : nh_(nh_private)
+{
+    Tracer& tracer = Tracer::instance();
+
+    tracer.setEnabled(nh_.param("tracing/enabled", true));
+    tracer.setWindow(nh_.param("tracing/window", 1024));
+    tracer.setHistory(nh_.param("tracing/history", 100000));
+    nh_.param("tracing/trace_file", trace_file_, std::string(""));
+
+    double rate = nh_.param("tracing/publish_rate", 1.0);
+
+    ros::NodeHandle nh;
+    diagnostics_pub_ = nh.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 10);
+    write_trace_srv_ = nh_.advertiseService("tracing/write_trace", &DiagnosticsPublisher::writeTrace, this);
+
+    if(tracer.isEnabled() && rate > 0.0) {
+        timer_ = nh.createTimer(ros::Duration(1.0 / rate), &DiagnosticsPublisher::timerCallback, this);
+    }
+}
+
+DiagnosticsPublisher::~DiagnosticsPublisher()
+{
+    if(!trace_file_.empty()) {
+        Tracer& tracer = Tracer::instance();
+        tracer.collect();
+        if(!tracer.writeChromeTrace(trace_file_)) {
+            ROS_ERROR_STREAM("cannot write the trace to " << trace_file_);
+        }
+    }
+}
+
+void DiagnosticsPublisher::timerCallback(const ros::TimerEvent&)
+{
+    publish();
+}
+
+void DiagnosticsPublisher::publish()
+{
+    Tracer& tracer = Tracer::instance();
+    tracer.collect();
+
+    const std::string& node = ros::this_node::getName();
+
+    diagnostic_msgs::DiagnosticArray msg;
+    msg.header.stamp = ros::Time::now();
+
+    for(const StageStatistics& s : tracer.statistics()) {
+        diagnostic_msgs::DiagnosticStatus status;
+        status.level = diagnostic_msgs::DiagnosticStatus::OK;
+        status.name = node + ": " + s.name;
+        status.hardware_id = node;
+
+        std::stringstream message;
+        message << "p50 " << s.p50_ms << " ms, p99 " << s.p99_ms << " ms";
+        status.message = message.str();
+
+        status.values.push_back(keyValue("count", s.count));
+        status.values.push_back(keyValue("mean_ms", s.mean_ms));
+        status.values.push_back(keyValue("p50_ms", s.p50_ms));
+        status.values.push_back(keyValue("p90_ms", s.p90_ms));
+        status.values.push_back(keyValue("p99_ms", s.p99_ms));
+        status.values.push_back(keyValue("max_ms", s.max_ms));
+        msg.status.push_back(status);
+    }
+
+    if(tracer.dropped() > 0) {
+        diagnostic_msgs::DiagnosticStatus status;
+        status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+        status.name = node + ": tracing";
+        status.hardware_id = node;
+        status.message = "spans dropped, the thread buffers are full";
+        status.values.push_back(keyValue("dropped", tracer.dropped()));
+        msg.status.push_back(status);
+    }
+
+    diagnostics_pub_.publish(msg);
+}
+
+bool DiagnosticsPublisher::writeTrace(std_srvs::Trigger::Request&, std_srvs::Trigger::Response& res)
+{
+    std::string file = trace_file_.empty() ? std::string("/tmp/nav_trace.json") : trace_file_;
+
+    Tracer& tracer = Tracer::instance();
+    tracer.collect();
+    res.success = tracer.writeChromeTrace(file);
+    res.message = res.success ? file : "cannot write " + file;
+    return true;
+}
@@ -0,0 +1,278 @@
+/// HEADER
+#include <nav_tracing/tracing.h>
+
+/// SYSTEM
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <unistd.h>
+
+using namespace nav_tracing;
+
+namespace {
+const std::size_t BUFFER_CAPACITY = 4096;
+
+double toMs(std::uint64_t ns)
+{
+    return ns * 1e-6;
+}
+
+double percentile(std::vector<double>& samples, double p)
+{
+    if(samples.empty()) {
+        return 0.0;
+    }
+    std::size_t k = std::min(samples.size() - 1, static_cast<std::size_t>(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+void writeEscaped(std::ostream& out, const char* s)
+{
+    for(; *s; ++s) {
+        if(*s == '"' || *s == '\\') {
+            out << '\\';
+        }
+        out << *s;
+    }
+}
+}
+
+/**
+ * Single producer, single consumer ring: only the owning thread advances head, only collect() advances tail.
+ */
+struct Tracer::ThreadBuffer
+{
+    explicit ThreadBuffer(std::uint32_t id)
+        : id(id), head(0), tail(0), events(BUFFER_CAPACITY)
+    {
+    }
+
+    std::uint32_t id;
+    std::atomic<std::size_t> head;
+    std::atomic<std::size_t> tail;
+    std::vector<Event> events;
+};
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+std::uint64_t Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Tracer::Tracer()
+    : enabled_(true),
+      dropped_(0),
+      next_thread_(0),
+      window_(1024),
+      history_size_(100000)
+{
+}
+
+Tracer::Stage::Stage()
+    : count(0), sum_ms(0.0), max_ms(0.0), next(0)
+{
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+Tracer::ThreadBuffer& Tracer::threadBuffer()
+{
+    // the registry keeps the buffer alive after the thread has exited, so that its last spans are collected
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if(!buffer) {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffer = std::make_shared<ThreadBuffer>(next_thread_++);
+        buffers_.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::record(const char* name, std::uint64_t start_ns, std::uint64_t duration_ns)
+{
+    ThreadBuffer& buffer = threadBuffer();
+
+    std::size_t head = buffer.head.load(std::memory_order_relaxed);
+    std::size_t tail = buffer.tail.load(std::memory_order_acquire);
+    if(head - tail >= buffer.events.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Event& e = buffer.events[head % buffer.events.size()];
+    e.name = name;
+    e.start_ns = start_ns;
+    e.duration_ns = duration_ns;
+    e.thread = buffer.id;
+
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+const char* Tracer::intern(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(names_mutex_);
+    return names_.insert(name).first->c_str();
+}
+
+std::size_t Tracer::collect()
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers = buffers_;
+    }
+
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+
+    std::size_t collected = 0;
+    for(const std::shared_ptr<ThreadBuffer>& buffer : buffers) {
+        std::size_t tail = buffer->tail.load(std::memory_order_relaxed);
+        std::size_t head = buffer->head.load(std::memory_order_acquire);
+        for(; tail != head; ++tail) {
+            const Event& e = buffer->events[tail % buffer->events.size()];
+
+            Stage& stage = stages_[e.name];
+            double ms = toMs(e.duration_ns);
+            ++stage.count;
+            stage.sum_ms += ms;
+            stage.max_ms = std::max(stage.max_ms, ms);
+            if(stage.window.size() < window_) {
+                stage.window.push_back(ms);
+            } else if(window_ > 0) {
+                stage.window[stage.next] = ms;
+                stage.next = (stage.next + 1) % window_;
+            }
+
+            if(history_size_ > 0) {
+                if(history_.size() >= history_size_) {
+                    history_.pop_front();
+                }
+                history_.push_back(e);
+            }
+            ++collected;
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+    // otherwise every buffer would still be referenced here
+    buffers.clear();
+
+    {
+        // drop the buffers of threads that have exited once they are empty
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                      [](const std::shared_ptr<ThreadBuffer>& b) {
+                           return b.use_count() == 1 &&
+                                   b->head.load(std::memory_order_acquire) == b->tail.load(std::memory_order_relaxed);
+                       }), buffers_.end());
+    }
+
+    return collected;
+}
+
+std::size_t Tracer::threadBufferCount() const
+{
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    return buffers_.size();
+}
+
+std::vector<StageStatistics> Tracer::statistics() const
+{
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+
+    std::vector<StageStatistics> result;
+    result.reserve(stages_.size());
+    for(const auto& entry : stages_) {
+        const Stage& stage = entry.second;
+        std::vector<double> samples = stage.window;
+
+        StageStatistics s;
+        s.name = entry.first;
+        s.count = stage.count;
+        s.mean_ms = stage.count > 0 ? stage.sum_ms / stage.count : 0.0;
+        s.p50_ms = percentile(samples, 0.5);
+        s.p90_ms = percentile(samples, 0.9);
+        s.p99_ms = percentile(samples, 0.99);
+        s.max_ms = stage.max_ms;
+        result.push_back(s);
+    }
+    return result;
+}
+
+void Tracer::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    stages_.clear();
+    history_.clear();
+}
+
+std::uint64_t Tracer::dropped() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void Tracer::setWindow(std::size_t samples)
+{
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    window_ = samples;
+    for(auto& entry : stages_) {
+        entry.second.window.clear();
+        entry.second.next = 0;
+    }
+}
+
+std::size_t Tracer::window() const
+{
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    return window_;
+}
+
+void Tracer::setHistory(std::size_t events)
+{
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    history_size_ = events;
+    while(history_.size() > history_size_) {
+        history_.pop_front();
+    }
+}
+
+void Tracer::writeChromeTrace(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+
+    const int pid = getpid();
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for(const Event& e : history_) {
+        if(!first) {
+            out << ",";
+        }
+        first = false;
+
+        out << "\n{\"name\":\"";
+        writeEscaped(out, e.name);
+        out << "\",\"ph\":\"X\",\"ts\":" << e.start_ns / 1000 << "." << (e.start_ns % 1000) / 100
+            << ",\"dur\":" << e.duration_ns / 1000 << "." << (e.duration_ns % 1000) / 100
+            << ",\"pid\":" << pid << ",\"tid\":" << e.thread << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool Tracer::writeChromeTrace(const std::string& file) const
+{
+    std::ofstream out(file.c_str());
+    if(!out.is_open()) {
+        return false;
+    }
+    writeChromeTrace(out);
+    return out.good();
+}
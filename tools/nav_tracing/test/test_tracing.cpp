@@ -0,0 +1,134 @@
+/**
+ * Test of the Tracer.
+ */
+#include <gtest/gtest.h>
+#include <nav_tracing/tracing.h>
+#include <sstream>
+#include <thread>
+
+using namespace nav_tracing;
+
+namespace {
+const StageStatistics* find(const std::vector<StageStatistics>& stats, const std::string& name)
+{
+    for(const StageStatistics& s : stats) {
+        if(s.name == name) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+}
+
+TEST(TestTracing, collectsSpansOfAllThreads)
+{
+    Tracer& tracer = Tracer::instance();
+    tracer.resetStatistics();
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for(int i = 0; i < 100; ++i) {
+                NAV_TRACE_SCOPE("test/worker");
+            }
+        });
+    }
+    for(std::thread& t : threads) {
+        t.join();
+    }
+    {
+        NAV_TRACE_SCOPE("test/main");
+    }
+
+    EXPECT_EQ(401u, tracer.collect());
+
+    std::vector<StageStatistics> stats = tracer.statistics();
+    const StageStatistics* worker = find(stats, "test/worker");
+    ASSERT_NE(nullptr, worker);
+    EXPECT_EQ(400u, worker->count);
+    EXPECT_LE(worker->p50_ms, worker->p99_ms);
+    EXPECT_LE(worker->p99_ms, worker->max_ms);
+
+    const StageStatistics* main = find(stats, "test/main");
+    ASSERT_NE(nullptr, main);
+    EXPECT_EQ(1u, main->count);
+
+    // everything has been drained
+    EXPECT_EQ(0u, tracer.collect());
+}
+
+TEST(TestTracing, releasesBuffersOfExitedThreads)
+{
+    Tracer& tracer = Tracer::instance();
+    {
+        NAV_TRACE_SCOPE("test/main");
+    }
+    tracer.collect();
+    ASSERT_EQ(1u, tracer.threadBufferCount());
+
+    for(int t = 0; t < 50; ++t) {
+        std::thread thread([]() {
+            NAV_TRACE_SCOPE("test/short_lived");
+        });
+        thread.join();
+    }
+    EXPECT_EQ(51u, tracer.threadBufferCount());
+
+    EXPECT_EQ(50u, tracer.collect());
+    EXPECT_EQ(1u, tracer.threadBufferCount());
+}
+
+TEST(TestTracing, percentilesOfKnownDurations)
+{
+    Tracer& tracer = Tracer::instance();
+    tracer.resetStatistics();
+
+    for(int i = 1; i <= 100; ++i) {
+        tracer.record("test/known", 0, i * 1000000ull);
+    }
+    tracer.collect();
+
+    std::vector<StageStatistics> stats = tracer.statistics();
+    const StageStatistics* s = find(stats, "test/known");
+    ASSERT_NE(nullptr, s);
+    EXPECT_DOUBLE_EQ(51.0, s->p50_ms);
+    EXPECT_DOUBLE_EQ(100.0, s->p99_ms);
+    EXPECT_DOUBLE_EQ(100.0, s->max_ms);
+    EXPECT_DOUBLE_EQ(50.5, s->mean_ms);
+}
+
+TEST(TestTracing, disabledTracerRecordsNothing)
+{
+    Tracer& tracer = Tracer::instance();
+    tracer.resetStatistics();
+    tracer.setEnabled(false);
+    {
+        NAV_TRACE_SCOPE("test/disabled");
+    }
+    tracer.setEnabled(true);
+
+    EXPECT_EQ(0u, tracer.collect());
+}
+
+TEST(TestTracing, writesChromeTrace)
+{
+    Tracer& tracer = Tracer::instance();
+    tracer.resetStatistics();
+
+    tracer.record(tracer.intern("test/\"quoted\""), 1500, 2500);
+    tracer.collect();
+
+    std::stringstream out;
+    tracer.writeChromeTrace(out);
+    std::string json = out.str();
+
+    EXPECT_NE(std::string::npos, json.find("\"traceEvents\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"test/\\\"quoted\\\"\""));
+    EXPECT_NE(std::string::npos, json.find("\"ts\":1.5,\"dur\":2.5"));
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,5 +1,7 @@
 #include <boost/bind.hpp>
 
+#include <algorithm>
+
 #include <OgreSceneNode.h>
 #include <OgreSceneManager.h>
 #include <OgreManualObject.h>
@@ -10,6 +12,7 @@
 
 #include "rviz/display_context.h"
 #include "rviz/frame_manager.h"
+#include "rviz/properties/bool_property.h"
 #include "rviz/properties/enum_property.h"
 #include "rviz/properties/color_property.h"
 #include "rviz/properties/float_property.h"
@@ -23,6 +26,78 @@
 namespace rviz
 {
 
+namespace
+{
+/**
+ * Douglas-Peucker simplification, removes all points that are closer than <tolerance> to the
+ * simplified line. The first and the last point are always kept.
+ */
+void decimate( std::vector<Ogre::Vector3>& points, float tolerance )
+{
+    const std::size_t n = points.size();
+    if( n < 3 || tolerance <= 0.0f )
+    {
+        return;
+    }
+
+    const float tolerance_sq = tolerance * tolerance;
+    std::vector<char> keep( n, 0 );
+    keep[ 0 ] = keep[ n - 1 ] = 1;
+
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    ranges.push_back( std::make_pair( 0, n - 1 ));
+    while( !ranges.empty() )
+    {
+        std::size_t first = ranges.back().first;
+        std::size_t last = ranges.back().second;
+        ranges.pop_back();
+
+        const Ogre::Vector3& a = points[ first ];
+        Ogre::Vector3 ab = points[ last ] - a;
+        float ab_sq = ab.squaredLength();
+
+        float max_dist_sq = 0.0f;
+        std::size_t max_i = first;
+        for( std::size_t i = first + 1; i < last; ++i )
+        {
+            Ogre::Vector3 ap = points[ i ] - a;
+            float dist_sq;
+            if( ab_sq > 0.0f )
+            {
+                float t = std::max( 0.0f, std::min( 1.0f, ap.dotProduct( ab ) / ab_sq ));
+                dist_sq = ( ap - t * ab ).squaredLength();
+            }
+            else
+            {
+                dist_sq = ap.squaredLength();
+            }
+            if( dist_sq > max_dist_sq )
+            {
+                max_dist_sq = dist_sq;
+                max_i = i;
+            }
+        }
+
+        if( max_dist_sq > tolerance_sq )
+        {
+            keep[ max_i ] = 1;
+            ranges.push_back( std::make_pair( first, max_i ));
+            ranges.push_back( std::make_pair( max_i, last ));
+        }
+    }
+
+    std::size_t j = 0;
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        if( keep[ i ] )
+        {
+            points[ j++ ] = points[ i ];
+        }
+    }
+    points.resize( j );
+}
+}
+
 PathSequenceDisplay::PathSequenceDisplay()
 {
     style_property_ = new EnumProperty( "Line Style", "Lines",
@@ -55,6 +130,16 @@ PathSequenceDisplay::PathSequenceDisplay()
     offset_property_ = new VectorProperty( "Offset", Ogre::Vector3::ZERO,
                                            "Allows you to offset the path from the origin of the reference frame.  In meters.",
                                            this, SLOT( updateOffset() ));
+
+    reuse_geometry_property_ = new BoolProperty( "Reuse Geometry", true,
+                                                 "Keep the vertex buffers between messages and only upload sub paths that changed.",
+                                                 this, SLOT( updateReuseGeometry() ));
+
+    decimation_property_ = new FloatProperty( "Decimation", 0.01,
+                                              "Points closer than this distance, in meters, to the simplified path are not drawn. "
+                                              "Only used with 'Reuse Geometry', 0 disables the simplification.",
+                                              reuse_geometry_property_, SLOT( updateReuseGeometry() ), this );
+    decimation_property_->setMin( 0.0 );
 }
 
 PathSequenceDisplay::~PathSequenceDisplay()
@@ -113,6 +198,11 @@ void PathSequenceDisplay::updateLineWidth()
     }
 }
 
+void PathSequenceDisplay::updateReuseGeometry()
+{
+    updateBufferLength();
+}
+
 void PathSequenceDisplay::updateOffset()
 {
     scene_node_->setPosition( offset_property_->getVector() );
@@ -155,6 +245,8 @@ void PathSequenceDisplay::destroyObjects()
 
         billboard_lines.clear();
     }
+
+    geometry_.clear();
 }
 
 void PathSequenceDisplay::updateBufferLength()
@@ -178,6 +270,10 @@ void PathSequenceDisplay::updateBufferLength()
         break;
     }
 
+    if( reuse_geometry_property_->getBool() )
+    {
+        geometry_.resize( buffer_length );
+    }
 
 }
 
@@ -196,23 +292,32 @@ void PathSequenceDisplay::processMessage( const path_msgs::PathSequence::ConstPt
     size_t bufferIndex = messages_received_ % buffer_length_property_->getInt();
 
     LineStyle style = (LineStyle) style_property_->getOptionInt();
+    bool reuse = reuse_geometry_property_->getBool();
     std::vector<Ogre::ManualObject*>* manual_objects = NULL;
     std::vector<rviz::BillboardLine*>* billboard_lines = NULL;
 
-    // Delete oldest element
+    // Delete oldest element, when reusing the geometry it is only hidden until it is needed again
     switch(style)
     {
     case LINES:
         manual_objects = &manual_objects_.at(bufferIndex );
         for(Ogre::ManualObject* mo : *manual_objects) {
-            mo->clear();
+            if(reuse) {
+                mo->setVisible(false);
+            } else {
+                mo->clear();
+            }
         }
         break;
 
     case BILLBOARDS:
         billboard_lines = &billboard_lines_.at(bufferIndex );
         for(rviz::BillboardLine* bi : *billboard_lines) {
-            bi->clear();
+            if(reuse) {
+                bi->getSceneNode()->setVisible(false);
+            } else {
+                bi->clear();
+            }
         }
         break;
     }
@@ -282,6 +387,65 @@ void PathSequenceDisplay::processMessage( const path_msgs::PathSequence::ConstPt
 
     float line_width = line_width_property_->getFloat();
 
+    if(reuse) {
+        std::vector<SubPathGeometry>& geometry = geometry_.at(bufferIndex);
+        if(geometry.size() < n) {
+            geometry.resize(n);
+        }
+
+        for(std::size_t k = 0; k < n; ++k) {
+            const auto& color = msg->paths[k].forward ? color_forward : color_backward;
+            SubPathGeometry& next = scratch_geometry_;
+            buildGeometry(*msg, k, transform, color, style == BILLBOARDS, next);
+
+            // an empty entry has never been uploaded, sub paths have at least one point
+            SubPathGeometry& current = geometry[k];
+            bool changed = current.points.empty() || current.points != next.points || current.color != next.color;
+
+            switch(style)
+            {
+            case LINES: {
+                Ogre::ManualObject* manual_object = manual_objects->at(k);
+                if(changed) {
+                    manual_object->estimateVertexCount( next.points.size() );
+                    if(manual_object->getNumSections() > 0) {
+                        // keeps the hardware buffer, it is only reallocated if the path has grown
+                        manual_object->beginUpdate( 0 );
+                    } else {
+                        manual_object->begin( "BaseWhiteNoLighting", Ogre::RenderOperation::OT_LINE_STRIP );
+                    }
+                    for(const Ogre::Vector3& p : next.points) {
+                        manual_object->position( p );
+                        manual_object->colour( next.color );
+                    }
+                    manual_object->end();
+                }
+                manual_object->setVisible(true);
+                break;
+            }
+
+            case BILLBOARDS: {
+                rviz::BillboardLine* billboard_line = billboard_lines->at(k);
+                if(changed) {
+                    billboard_line->clear();
+                    billboard_line->setNumLines( 1 );
+                    billboard_line->setMaxPointsPerLine( next.points.size() );
+                    billboard_line->setLineWidth( line_width );
+                    for(const Ogre::Vector3& p : next.points) {
+                        billboard_line->addPoint( p, next.color );
+                    }
+                }
+                billboard_line->getSceneNode()->setVisible(true);
+                break;
+            }
+            }
+
+            if(changed) {
+                std::swap(current, next);
+            }
+        }
+        return;
+    }
 
     switch(style)
     {
@@ -354,6 +518,26 @@ void PathSequenceDisplay::processMessage( const path_msgs::PathSequence::ConstPt
 
 }
 
+void PathSequenceDisplay::buildGeometry( const path_msgs::PathSequence& msg, std::size_t k, const Ogre::Matrix4& transform,
+                                         const Ogre::ColourValue& color, bool prepend_previous, SubPathGeometry& geometry ) const
+{
+    geometry.points.clear();
+    geometry.color = color;
+
+    if(prepend_previous && k > 0) {
+        // for later segments we need to re-render the last point of the preceeding path
+        const geometry_msgs::Point& pos = msg.paths[k-1].poses.back().pose.position;
+        geometry.points.push_back( transform * Ogre::Vector3( pos.x, pos.y, pos.z ));
+    }
+    for(const geometry_msgs::PoseStamped& pose : msg.paths[k].poses)
+    {
+        const geometry_msgs::Point& pos = pose.pose.position;
+        geometry.points.push_back( transform * Ogre::Vector3( pos.x, pos.y, pos.z ));
+    }
+
+    decimate( geometry.points, decimation_property_->getFloat() );
+}
+
 } // namespace rviz
 
 #include <pluginlib/class_list_macros.h>
@@ -5,14 +5,19 @@
 
 #include "rviz/message_filter_display.h"
 
+#include <OgreVector3.h>
+#include <OgreColourValue.h>
+
 namespace Ogre
 {
 class ManualObject;
+class Matrix4;
 }
 
 namespace rviz
 {
 
+class BoolProperty;
 class ColorProperty;
 class FloatProperty;
 class IntProperty;
@@ -47,12 +52,28 @@ private Q_SLOTS:
   void updateStyle();
   void updateLineWidth();
   void updateOffset();
+  void updateReuseGeometry();
 
 private:
   void destroyObjects();
 
+  /**
+   * @brief Geometry of one sub path as it was uploaded, used to skip unchanged sub paths.
+   */
+  struct SubPathGeometry
+  {
+    std::vector<Ogre::Vector3> points;
+    Ogre::ColourValue color;
+  };
+
+  void buildGeometry( const path_msgs::PathSequence& msg, std::size_t k, const Ogre::Matrix4& transform,
+                      const Ogre::ColourValue& color, bool prepend_previous, SubPathGeometry& geometry ) const;
+
   std::vector<std::vector<Ogre::ManualObject*>> manual_objects_;
   std::vector<std::vector<rviz::BillboardLine*>> billboard_lines_;
+  //! uploaded geometry for each buffer entry and sub path, only used when geometry is reused
+  std::vector<std::vector<SubPathGeometry>> geometry_;
+  SubPathGeometry scratch_geometry_;
 
   EnumProperty* style_property_;
   ColorProperty* color_forward_property_;
@@ -61,6 +82,8 @@ private:
   FloatProperty* line_width_property_;
   IntProperty* buffer_length_property_;
   VectorProperty* offset_property_;
+  BoolProperty* reuse_geometry_property_;
+  FloatProperty* decimation_property_;
 
   enum LineStyle {
     LINES,